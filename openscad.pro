@@ -239,6 +239,7 @@ HEADERS += src/typedefs.h \
            src/version_check.h \
            src/ProgressWidget.h \
            src/parsersettings.h \
+           src/ParserContext.h \
            src/renderer.h \
            src/settings.h \
            src/rendersettings.h \
@@ -291,6 +292,7 @@ HEADERS += src/typedefs.h \
            src/textnode.h \
            src/openscad.h \
            src/handle_dep.h \
+           src/FileWatcher.h \
            src/Geometry.h \
            src/Polygon2d.h \
            src/clipper-utils.h \
@@ -308,6 +310,7 @@ HEADERS += src/typedefs.h \
            src/nodecache.h \
            src/nodedumper.h \
            src/ModuleCache.h \
+           src/ASTCache.h \
            src/GeometryCache.h \
            src/GeometryEvaluator.h \
            src/Tree.h \
@@ -315,6 +318,7 @@ HEADERS += src/typedefs.h \
            src/FreetypeRenderer.h \
            src/FontCache.h \
            src/memory.h \
+           src/parallel.h \
            src/linalg.h \
            src/Camera.h \
            src/system-gl.h \
@@ -325,6 +329,7 @@ HEADERS += src/typedefs.h \
            \
            src/lodepng.h \
            src/OffscreenView.h \
+           src/SoftwareRenderer.h \
            src/OffscreenContext.h \
            src/OffscreenContextAll.hpp \
            src/fbo.h \
@@ -343,6 +348,7 @@ SOURCES += src/version_check.cc \
            src/linalg.cc \
            src/Camera.cc \
            src/handle_dep.cc \
+           src/FileWatcher.cc \
            src/value.cc \
            src/expr.cc \
            src/stackcheck.cc \
@@ -392,6 +398,7 @@ SOURCES += src/version_check.cc \
            src/traverser.cc \
            src/GeometryEvaluator.cc \
            src/ModuleCache.cc \
+           src/ASTCache.cc \
            src/GeometryCache.cc \
            src/Tree.cc \
 	   src/DrawingCallback.cc \
@@ -420,6 +427,7 @@ SOURCES += src/version_check.cc \
            src/export_svg.cc \
            src/export_nef.cc \
            src/export_png.cc \
+           src/SoftwareRenderer.cc \
            src/import.cc \
            src/renderer.cc \
            src/colormap.cc \
@@ -0,0 +1,638 @@
+#include "ASTCache.h"
+#include "module.h"
+#include "expression.h"
+#include "function.h"
+#include "parsersettings.h"
+#include "handle_dep.h"
+#include "printutils.h"
+#include "boosty.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <fstream>
+#include <sstream>
+#include <typeinfo>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace fs = boost::filesystem;
+
+ASTCache *ASTCache::inst = NULL;
+
+// Bump when the format or the AST classes change
+static const char *MAGIC = "OpenSCAD AST cache 1";
+
+enum ast_expr_e {
+	EXPR_NULL,
+	EXPR_NOT,
+	EXPR_AND,
+	EXPR_OR,
+	EXPR_MULTIPLY,
+	EXPR_DIVISION,
+	EXPR_MODULO,
+	EXPR_PLUS,
+	EXPR_MINUS,
+	EXPR_LESS,
+	EXPR_LESS_OR_EQUAL,
+	EXPR_EQUAL,
+	EXPR_NOT_EQUAL,
+	EXPR_GREATER_OR_EQUAL,
+	EXPR_GREATER,
+	EXPR_TERNARY,
+	EXPR_ARRAY_LOOKUP,
+	EXPR_INVERT,
+	EXPR_CONST,
+	EXPR_RANGE,
+	EXPR_VECTOR,
+	EXPR_LOOKUP,
+	EXPR_MEMBER,
+	EXPR_FUNCTION_CALL,
+	EXPR_LET,
+	EXPR_LC_IF,
+	EXPR_LC_EACH,
+	EXPR_LC_FOR,
+	EXPR_LC_FOR_C,
+	EXPR_LC_LET
+};
+
+enum ast_inst_e {
+	INST_MODULE,
+	INST_IFELSE
+};
+
+// FNV-1a
+static uint64_t hash_string(const std::string &str, uint64_t h = 14695981039346656037ULL)
+{
+	for (unsigned char c : str) {
+		h ^= c;
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+static bool read_file(const std::string &filename, std::string &contents)
+{
+	std::ifstream ifs(filename.c_str(), std::ios::binary);
+	if (!ifs.is_open()) return false;
+	std::stringstream buf;
+	buf << ifs.rdbuf();
+	contents = buf.str();
+	return true;
+}
+
+static std::string hash_file(const std::string &filename)
+{
+	std::string contents;
+	if (!read_file(filename, contents)) return "";
+	return str(boost::format("%016x.%x") % hash_string(contents) % contents.size());
+}
+
+/*!
+	Serializes the AST into a flat buffer in native byte order.
+	Sets ok to false if the AST contains something which can't be stored.
+*/
+class ASTCache::Writer
+{
+public:
+	Writer() : ok(true) {}
+
+	std::string buf;
+	bool ok;
+
+	void u8(uint8_t v) { buf.push_back(v); }
+	void u32(uint32_t v) { buf.append((const char *)&v, sizeof(v)); }
+	void i32(int32_t v) { buf.append((const char *)&v, sizeof(v)); }
+	void f64(double v) { buf.append((const char *)&v, sizeof(v)); }
+	void str(const std::string &s) { u32(s.size()); buf.append(s); }
+
+	void value(const Value &v) {
+		u8(v.type());
+		switch (v.type()) {
+		case Value::UNDEFINED:
+			break;
+		case Value::BOOL:
+			u8(v.toBool());
+			break;
+		case Value::NUMBER:
+			f64(v.toDouble());
+			break;
+		case Value::STRING:
+			str(v.toString());
+			break;
+		case Value::VECTOR:
+			if (const std::vector<double> *numbers = v.toNumbers()) {
+				u32(numbers->size());
+				for (double d : *numbers) {
+					u8(Value::NUMBER);
+					f64(d);
+				}
+			}
+			else {
+				u32(v.toVector().size());
+				for(const auto &item : v.toVector()) value(*item);
+			}
+			break;
+		default:
+			ok = false;
+		}
+	}
+
+	void assignments(const AssignmentList &args) {
+		u32(args.size());
+		for(const auto &arg : args) {
+			str(arg.first);
+			expression(arg.second.get());
+		}
+	}
+
+	void expression(const Expression *e) {
+		if (!e) {
+			u8(EXPR_NULL);
+			return;
+		}
+		const std::type_info &type = typeid(*e);
+		if (type == typeid(ExpressionNot)) unary(EXPR_NOT, e);
+		else if (type == typeid(ExpressionLogicalAnd)) binary(EXPR_AND, e);
+		else if (type == typeid(ExpressionLogicalOr)) binary(EXPR_OR, e);
+		else if (type == typeid(ExpressionMultiply)) binary(EXPR_MULTIPLY, e);
+		else if (type == typeid(ExpressionDivision)) binary(EXPR_DIVISION, e);
+		else if (type == typeid(ExpressionModulo)) binary(EXPR_MODULO, e);
+		else if (type == typeid(ExpressionPlus)) binary(EXPR_PLUS, e);
+		else if (type == typeid(ExpressionMinus)) binary(EXPR_MINUS, e);
+		else if (type == typeid(ExpressionLess)) binary(EXPR_LESS, e);
+		else if (type == typeid(ExpressionLessOrEqual)) binary(EXPR_LESS_OR_EQUAL, e);
+		else if (type == typeid(ExpressionEqual)) binary(EXPR_EQUAL, e);
+		else if (type == typeid(ExpressionNotEqual)) binary(EXPR_NOT_EQUAL, e);
+		else if (type == typeid(ExpressionGreaterOrEqual)) binary(EXPR_GREATER_OR_EQUAL, e);
+		else if (type == typeid(ExpressionGreater)) binary(EXPR_GREATER, e);
+		else if (type == typeid(ExpressionArrayLookup)) binary(EXPR_ARRAY_LOOKUP, e);
+		else if (type == typeid(ExpressionInvert)) unary(EXPR_INVERT, e);
+		else if (type == typeid(ExpressionTernary)) {
+			u8(EXPR_TERNARY);
+			expression(e->first);
+			expression(e->second);
+			expression(e->third);
+		}
+		else if (type == typeid(ExpressionConst)) {
+			u8(EXPR_CONST);
+			value(*static_cast<const ExpressionConst *>(e)->const_value);
+		}
+		else if (type == typeid(ExpressionRange) || type == typeid(ExpressionVector)) {
+			u8(type == typeid(ExpressionRange) ? EXPR_RANGE : EXPR_VECTOR);
+			u32(e->children.size());
+			for(const auto &child : e->children) expression(child);
+		}
+		else if (type == typeid(ExpressionLookup)) {
+			u8(EXPR_LOOKUP);
+			str(static_cast<const ExpressionLookup *>(e)->var_name);
+		}
+		else if (type == typeid(ExpressionMember)) {
+			u8(EXPR_MEMBER);
+			str(static_cast<const ExpressionMember *>(e)->member);
+			expression(e->first);
+		}
+		else if (type == typeid(ExpressionFunctionCall)) {
+			const ExpressionFunctionCall *call = static_cast<const ExpressionFunctionCall *>(e);
+			u8(EXPR_FUNCTION_CALL);
+			str(call->funcname);
+			assignments(call->call_arguments);
+		}
+		else if (type == typeid(ExpressionLet)) {
+			u8(EXPR_LET);
+			assignments(static_cast<const ExpressionLet *>(e)->call_arguments);
+			expression(e->first);
+		}
+		else if (type == typeid(ExpressionLcIf)) {
+			u8(EXPR_LC_IF);
+			expression(static_cast<const ExpressionLcIf *>(e)->cond);
+			expression(e->first);
+			expression(e->second);
+		}
+		else if (type == typeid(ExpressionLcEach)) unary(EXPR_LC_EACH, e);
+		else if (type == typeid(ExpressionLcFor)) {
+			u8(EXPR_LC_FOR);
+			assignments(static_cast<const ExpressionLcFor *>(e)->call_arguments);
+			expression(e->first);
+		}
+		else if (type == typeid(ExpressionLcForC)) {
+			const ExpressionLcForC *lc = static_cast<const ExpressionLcForC *>(e);
+			u8(EXPR_LC_FOR_C);
+			assignments(lc->call_arguments);
+			assignments(lc->incr_arguments);
+			expression(e->first);
+			expression(e->second);
+		}
+		else if (type == typeid(ExpressionLcLet)) {
+			u8(EXPR_LC_LET);
+			assignments(static_cast<const ExpressionLcLet *>(e)->call_arguments);
+			expression(e->first);
+		}
+		else {
+			ok = false;
+		}
+	}
+
+	void unary(ast_expr_e tag, const Expression *e) {
+		u8(tag);
+		expression(e->first);
+	}
+
+	void binary(ast_expr_e tag, const Expression *e) {
+		u8(tag);
+		expression(e->first);
+		expression(e->second);
+	}
+
+	void instantiation(const ModuleInstantiation *inst) {
+		const IfElseModuleInstantiation *ifelse = dynamic_cast<const IfElseModuleInstantiation *>(inst);
+		u8(ifelse ? INST_IFELSE : INST_MODULE);
+		str(inst->name());
+		str(inst->path());
+		Location loc = inst->getLocation();
+		i32(loc.first_line);
+		i32(loc.first_column);
+		i32(loc.last_line);
+		i32(loc.last_column);
+		u8(inst->tag_root);
+		u8(inst->tag_highlight);
+		u8(inst->tag_background);
+		assignments(inst->arguments);
+		scope(inst->scope);
+		if (ifelse) scope(ifelse->else_scope);
+	}
+
+	void scope(const LocalScope &scope) {
+		assignments(scope.assignments);
+		u32(scope.children.size());
+		for(const auto &child : scope.children) instantiation(child);
+		u32(scope.functions.size());
+		for(const auto &f : scope.functions) {
+			const Function *func = dynamic_cast<const Function *>(f.second);
+			if (!func) {
+				ok = false;
+				return;
+			}
+			str(f.first);
+			str(func->name);
+			assignments(func->definition_arguments);
+			expression(func->expr);
+		}
+		u32(scope.modules.size());
+		for(const auto &m : scope.modules) {
+			const Module *mod = dynamic_cast<const Module *>(m.second);
+			if (!mod || dynamic_cast<const FileModule *>(mod)) {
+				ok = false;
+				return;
+			}
+			str(m.first);
+			assignments(mod->definition_arguments);
+			this->scope(mod->scope);
+		}
+	}
+};
+
+/*!
+	Reads back the buffer written by Writer. Reading past the end or any
+	unexpected data sets ok to false; callers discard the result in that case.
+*/
+class ASTCache::Reader
+{
+public:
+	Reader(const std::string &buf) : pos(buf.data()), end(buf.data() + buf.size()), ok(true) {}
+
+	const char *pos;
+	const char *end;
+	bool ok;
+
+	bool get(void *dst, size_t n) {
+		if (!ok || size_t(end - pos) < n) {
+			ok = false;
+			memset(dst, 0, n);
+			return false;
+		}
+		memcpy(dst, pos, n);
+		pos += n;
+		return true;
+	}
+	uint8_t u8() { uint8_t v; get(&v, sizeof(v)); return v; }
+	uint32_t u32() { uint32_t v; get(&v, sizeof(v)); return v; }
+	int32_t i32() { int32_t v; get(&v, sizeof(v)); return v; }
+	double f64() { double v; get(&v, sizeof(v)); return v; }
+	std::string str() {
+		uint32_t n = u32();
+		if (!ok || size_t(end - pos) < n) {
+			ok = false;
+			return "";
+		}
+		std::string s(pos, n);
+		pos += n;
+		return s;
+	}
+	// Element counts can't exceed the remaining buffer, so corrupt input
+	// doesn't trigger huge allocations.
+	uint32_t count() {
+		uint32_t n = u32();
+		if (n > size_t(end - pos)) ok = false;
+		return ok ? n : 0;
+	}
+
+	ValuePtr value() {
+		switch (u8()) {
+		case Value::UNDEFINED:
+			return ValuePtr::undefined;
+		case Value::BOOL:
+			return ValuePtr(u8() != 0);
+		case Value::NUMBER:
+			return ValuePtr(f64());
+		case Value::STRING:
+			return ValuePtr(str());
+		case Value::VECTOR: {
+			// Packs vectors of numbers as they were before being written
+			VectorBuilder vec;
+			uint32_t n = count();
+			for (uint32_t i = 0; i < n && ok; i++) vec.push_back(value());
+			return vec.build();
+		}
+		default:
+			ok = false;
+			return ValuePtr::undefined;
+		}
+	}
+
+	AssignmentList assignments() {
+		AssignmentList args;
+		uint32_t n = count();
+		for (uint32_t i = 0; i < n && ok; i++) {
+			std::string name = str();
+			args.push_back(Assignment(name, shared_ptr<Expression>(expression())));
+		}
+		return args;
+	}
+
+	// Reads n subexpressions; on failure, deletes them and returns false
+	bool subexpressions(Expression **exprs, size_t n) {
+		for (size_t i = 0; i < n; i++) exprs[i] = expression();
+		if (!ok) {
+			for (size_t i = 0; i < n; i++) delete exprs[i];
+		}
+		return ok;
+	}
+
+	Expression *expression() {
+		Expression *e[3] = {NULL, NULL, NULL};
+		uint8_t tag = u8();
+		if (!ok) return NULL;
+		switch (tag) {
+		case EXPR_NULL: return NULL;
+		case EXPR_NOT: return subexpressions(e, 1) ? new ExpressionNot(e[0]) : NULL;
+		case EXPR_AND: return subexpressions(e, 2) ? new ExpressionLogicalAnd(e[0], e[1]) : NULL;
+		case EXPR_OR: return subexpressions(e, 2) ? new ExpressionLogicalOr(e[0], e[1]) : NULL;
+		case EXPR_MULTIPLY: return subexpressions(e, 2) ? new ExpressionMultiply(e[0], e[1]) : NULL;
+		case EXPR_DIVISION: return subexpressions(e, 2) ? new ExpressionDivision(e[0], e[1]) : NULL;
+		case EXPR_MODULO: return subexpressions(e, 2) ? new ExpressionModulo(e[0], e[1]) : NULL;
+		case EXPR_PLUS: return subexpressions(e, 2) ? new ExpressionPlus(e[0], e[1]) : NULL;
+		case EXPR_MINUS: return subexpressions(e, 2) ? new ExpressionMinus(e[0], e[1]) : NULL;
+		case EXPR_LESS: return subexpressions(e, 2) ? new ExpressionLess(e[0], e[1]) : NULL;
+		case EXPR_LESS_OR_EQUAL: return subexpressions(e, 2) ? new ExpressionLessOrEqual(e[0], e[1]) : NULL;
+		case EXPR_EQUAL: return subexpressions(e, 2) ? new ExpressionEqual(e[0], e[1]) : NULL;
+		case EXPR_NOT_EQUAL: return subexpressions(e, 2) ? new ExpressionNotEqual(e[0], e[1]) : NULL;
+		case EXPR_GREATER_OR_EQUAL: return subexpressions(e, 2) ? new ExpressionGreaterOrEqual(e[0], e[1]) : NULL;
+		case EXPR_GREATER: return subexpressions(e, 2) ? new ExpressionGreater(e[0], e[1]) : NULL;
+		case EXPR_TERNARY: return subexpressions(e, 3) ? new ExpressionTernary(e[0], e[1], e[2]) : NULL;
+		case EXPR_ARRAY_LOOKUP: return subexpressions(e, 2) ? new ExpressionArrayLookup(e[0], e[1]) : NULL;
+		case EXPR_INVERT: return subexpressions(e, 1) ? new ExpressionInvert(e[0]) : NULL;
+		case EXPR_LC_EACH: return subexpressions(e, 1) ? new ExpressionLcEach(e[0]) : NULL;
+		case EXPR_LC_IF: return subexpressions(e, 3) ? new ExpressionLcIf(e[0], e[1], e[2]) : NULL;
+		case EXPR_CONST: {
+			ValuePtr val = value();
+			return ok ? new ExpressionConst(val) : NULL;
+		}
+		case EXPR_RANGE: {
+			uint32_t n = u32();
+			if (n == 2 && subexpressions(e, 2)) return new ExpressionRange(e[0], e[1]);
+			if (n == 3 && subexpressions(e, 3)) return new ExpressionRange(e[0], e[1], e[2]);
+			ok = false;
+			return NULL;
+		}
+		case EXPR_VECTOR: {
+			uint32_t n = count();
+			if (n == 0 || !subexpressions(e, 1)) {
+				ok = false;
+				return NULL;
+			}
+			Expression *vec = new ExpressionVector(e[0]);
+			for (uint32_t i = 1; i < n && ok; i++) vec->children.push_back(expression());
+			if (!ok) {
+				delete vec;
+				return NULL;
+			}
+			return vec;
+		}
+		case EXPR_LOOKUP: {
+			std::string name = str();
+			return ok ? new ExpressionLookup(name) : NULL;
+		}
+		case EXPR_MEMBER: {
+			std::string member = str();
+			return subexpressions(e, 1) ? new ExpressionMember(e[0], member) : NULL;
+		}
+		case EXPR_FUNCTION_CALL: {
+			std::string name = str();
+			AssignmentList args = assignments();
+			return ok ? new ExpressionFunctionCall(name, args) : NULL;
+		}
+		case EXPR_LET: {
+			AssignmentList args = assignments();
+			return subexpressions(e, 1) ? new ExpressionLet(args, e[0]) : NULL;
+		}
+		case EXPR_LC_FOR: {
+			AssignmentList args = assignments();
+			return subexpressions(e, 1) ? new ExpressionLcFor(args, e[0]) : NULL;
+		}
+		case EXPR_LC_FOR_C: {
+			AssignmentList args = assignments();
+			AssignmentList incrargs = assignments();
+			return subexpressions(e, 2) ? new ExpressionLcForC(args, incrargs, e[0], e[1]) : NULL;
+		}
+		case EXPR_LC_LET: {
+			AssignmentList args = assignments();
+			return subexpressions(e, 1) ? new ExpressionLcLet(args, e[0]) : NULL;
+		}
+		default:
+			ok = false;
+			return NULL;
+		}
+	}
+
+	ModuleInstantiation *instantiation() {
+		uint8_t type = u8();
+		if (type != INST_MODULE && type != INST_IFELSE) {
+			ok = false;
+			return NULL;
+		}
+		std::string name = str();
+		ModuleInstantiation *inst;
+		if (type == INST_IFELSE) inst = new IfElseModuleInstantiation();
+		else inst = new ModuleInstantiation(name);
+		inst->setPath(str());
+		int fl = i32(), fc = i32(), ll = i32(), lc = i32();
+		inst->setLocation(fl, fc, ll, lc);
+		inst->tag_root = u8();
+		inst->tag_highlight = u8();
+		inst->tag_background = u8();
+		inst->arguments = assignments();
+		scope(inst->scope);
+		if (type == INST_IFELSE) scope(static_cast<IfElseModuleInstantiation *>(inst)->else_scope);
+		return inst;
+	}
+
+	void scope(LocalScope &scope) {
+		scope.assignments = assignments();
+		uint32_t n = count();
+		for (uint32_t i = 0; i < n && ok; i++) {
+			ModuleInstantiation *inst = instantiation();
+			if (inst) scope.children.push_back(inst);
+		}
+		n = count();
+		for (uint32_t i = 0; i < n && ok; i++) {
+			std::string key = str();
+			std::string name = str();
+			AssignmentList args = assignments();
+			Expression *expr = expression();
+			if (!ok) {
+				delete expr;
+				break;
+			}
+			delete scope.functions[key];
+			scope.functions[key] = Function::create(name.c_str(), args, expr);
+		}
+		n = count();
+		for (uint32_t i = 0; i < n && ok; i++) {
+			std::string key = str();
+			Module *mod = new Module();
+			delete scope.modules[key];
+			scope.modules[key] = mod;
+			mod->definition_arguments = assignments();
+			this->scope(mod->scope);
+		}
+	}
+};
+
+std::string ASTCache::cacheFile(const std::string &filename, const std::string &text) const
+{
+	uint64_t h = hash_string(MAGIC);
+	h = hash_string(filename, h);
+	h = hash_string(text, h);
+	for(const auto &dir : librarypath) h = hash_string(dir, h);
+	std::string name = str(boost::format("%016x-%x.ast") % h % text.size());
+	return boosty::stringy(fs::path(this->cachedir) / name);
+}
+
+/*!
+	Returns the cached module for the given file and parser input, or NULL
+	if there is no valid cache entry.
+	Like parse(), this registers used libraries and dependencies.
+*/
+FileModule *ASTCache::load(const std::string &filename, const std::string &text)
+{
+	if (!isEnabled()) return NULL;
+
+	std::string buf;
+	if (!read_file(cacheFile(filename, text), buf)) return NULL;
+
+	Reader reader(buf);
+	// Filename and text are compared too, so a hash collision can't return
+	// the wrong module
+	if (reader.str() != MAGIC || reader.str() != filename || reader.str() != text) return NULL;
+
+	FileModule *module = new FileModule();
+	module->setModulePath(reader.str());
+
+	// The include closure must be unchanged. Include paths are resolved again
+	// like in FileModule::include_modified(), so files shadowing them are detected.
+	std::vector<std::pair<std::string, std::string>> includes;
+	uint32_t n = reader.count();
+	for (uint32_t i = 0; i < n && reader.ok; i++) {
+		std::string localpath = reader.str();
+		std::string fullpath = reader.str();
+		std::string filehash = reader.str();
+		if (!reader.ok || boosty::stringy(find_valid_path(module->modulePath(), localpath)) != fullpath ||
+				hash_file(fullpath) != filehash) {
+			delete module;
+			return NULL;
+		}
+		includes.push_back(std::make_pair(localpath, fullpath));
+	}
+
+	std::vector<std::string> uses;
+	n = reader.count();
+	for (uint32_t i = 0; i < n && reader.ok; i++) uses.push_back(reader.str());
+
+	reader.scope(module->scope);
+	if (!reader.ok || reader.pos != reader.end) {
+		PRINTB("WARNING: Ignoring corrupt AST cache entry for '%s'", filename);
+		delete module;
+		return NULL;
+	}
+
+	for(const auto &inc : includes) {
+		module->registerInclude(inc.first, inc.second);
+		handle_dep(inc.second, filename);
+	}
+	for(const auto &use : uses) {
+		module->registerUse(use);
+		if (boosty::is_absolute(fs::path(use))) handle_dep(use, filename);
+	}
+	return module;
+}
+
+/*!
+	Stores the given module, parsed from text, in the cache.
+	Failures are silently ignored; the cache is only an optimization.
+*/
+void ASTCache::store(const std::string &filename, const std::string &text, const FileModule &module)
+{
+	if (!isEnabled()) return;
+
+	Writer writer;
+	writer.str(MAGIC);
+	writer.str(filename);
+	writer.str(text);
+	writer.str(module.modulePath());
+
+	writer.u32(module.includes.size());
+	for(const auto &inc : module.includes) {
+		if (!inc.second.valid) return;
+		writer.str(inc.first);
+		writer.str(inc.second.filename);
+		writer.str(hash_file(inc.second.filename));
+	}
+	writer.u32(module.uses.size());
+	for(const auto &use : module.uses) writer.str(use);
+
+	writer.scope(module.scope);
+	if (!writer.ok) return;
+
+	// Write to a temporary file and rename, so concurrent processes never
+	// see partial entries
+	std::string cachefile = cacheFile(filename, text);
+	std::string tmpfile = str(boost::format("%s.%d.tmp") % cachefile % getpid());
+	try {
+		fs::create_directories(this->cachedir);
+		{
+			std::ofstream ofs(tmpfile.c_str(), std::ios::binary);
+			if (!ofs.is_open()) return;
+			ofs.write(writer.buf.data(), writer.buf.size());
+			if (!ofs.good()) {
+				ofs.close();
+				fs::remove(tmpfile);
+				return;
+			}
+		}
+		fs::rename(tmpfile, cachefile);
+	}
+	catch (const fs::filesystem_error &e) {
+		PRINTDB("AST cache: %s", e.what());
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+
+/*!
+	Persistent cache of parsed library files.
+
+	Stores a binary form of the FileModule AST in a cache directory, so
+	libraries don't have to be parsed again on every start. Entries are keyed
+	by a hash of the file name, the text passed to the parser and the library
+	path. They also record the content hash of every included file and are
+	only used while the include closure is unchanged.
+
+	Only files that parsed without any warnings are stored, since loading
+	from the cache doesn't repeat the messages.
+
+	The cache is disabled unless a cache directory has been set.
+*/
+class ASTCache
+{
+public:
+	static ASTCache *instance() { if (!inst) inst = new ASTCache; return inst; }
+
+	void setCacheDir(const std::string &dir) { this->cachedir = dir; }
+	const std::string &cacheDir() const { return this->cachedir; }
+	bool isEnabled() const { return !this->cachedir.empty(); }
+
+	class FileModule *load(const std::string &filename, const std::string &text);
+	void store(const std::string &filename, const std::string &text, const class FileModule &module);
+
+private:
+	ASTCache() {}
+	~ASTCache() {}
+
+	class Writer;
+	class Reader;
+
+	std::string cacheFile(const std::string &filename, const std::string &text) const;
+
+	static ASTCache *inst;
+	std::string cachedir;
+};
@@ -1,6 +1,7 @@
 #include "CGALCache.h"
 #include "printutils.h"
 #include "CGAL_Nef_polyhedron.h"
+#include <vector>
 
 CGALCache *CGALCache::inst = NULL;
 
@@ -19,7 +20,8 @@ shared_ptr<const CGAL_Nef_polyhedron> CGALCache::get(const std::string &id) cons
 
 bool CGALCache::insert(const std::string &id, const shared_ptr<const CGAL_Nef_polyhedron> &N)
 {
-	bool inserted = this->cache.insert(id, new cache_entry(N), N ? N->memsize() : 0);
+	bool inserted = this->cache.insert(id, new cache_entry(this, id, N), N ? N->memsize() : 0);
+	if (inserted && N) this->ids.emplace(N.get(), id);
 #ifdef DEBUG
 	if (inserted) PRINTB("CGAL Cache insert: %s (%d bytes)", id.substr(0, 40) % (N ? N->memsize() : 0));
 	else PRINTB("CGAL Cache insert failed: %s (%d bytes)", id.substr(0, 40) % (N ? N->memsize() : 0));
@@ -27,6 +29,24 @@ bool CGALCache::insert(const std::string &id, const shared_ptr<const CGAL_Nef_po
 	return inserted;
 }
 
+/*!
+	Reinserts the entries holding N with its current size, after something
+	was attached to it, like the PolySet extracted by CGALUtils::getPolySet().
+*/
+void CGALCache::updateSize(const CGAL_Nef_polyhedron &N)
+{
+	std::vector<std::string> entries;
+	auto range = this->ids.equal_range(&N);
+	for (auto it = range.first; it != range.second; ++it) entries.push_back(it->second);
+	for (const auto &id : entries) {
+		// Reinserting may have evicted entries further down the list
+		const cache_entry *entry = this->cache[id];
+		if (!entry) continue;
+		shared_ptr<const CGAL_Nef_polyhedron> cached = entry->N;
+		insert(id, cached);
+	}
+}
+
 size_t CGALCache::maxSize() const
 {
 	return this->cache.maxCost();
@@ -48,8 +68,20 @@ void CGALCache::print()
 	PRINTB("CGAL cache size in bytes: %d", this->cache.totalCost());
 }
 
-CGALCache::cache_entry::cache_entry(const shared_ptr<const CGAL_Nef_polyhedron> &N)
-	: N(N)
+CGALCache::cache_entry::cache_entry(CGALCache *owner, const std::string &id, const shared_ptr<const CGAL_Nef_polyhedron> &N)
+	: owner(owner), id(id), N(N)
 {
 	if (print_messages_stack.size() > 0) this->msg = print_messages_stack.back();
 }
+
+CGALCache::cache_entry::~cache_entry()
+{
+	if (!this->N) return;
+	auto range = this->owner->ids.equal_range(this->N.get());
+	for (auto it = range.first; it != range.second; ++it) {
+		if (it->second == this->id) {
+			this->owner->ids.erase(it);
+			break;
+		}
+	}
+}
@@ -2,6 +2,7 @@
 
 #include "cache.h"
 #include "memory.h"
+#include <unordered_map>
 
 /*!
 */
@@ -15,6 +16,7 @@ public:
 	bool contains(const std::string &id) const { return this->cache.contains(id); }
 	shared_ptr<const class CGAL_Nef_polyhedron> get(const std::string &id) const;
 	bool insert(const std::string &id, const shared_ptr<const CGAL_Nef_polyhedron> &N);
+	void updateSize(const CGAL_Nef_polyhedron &N);
 	size_t maxSize() const;
 	void setMaxSize(size_t limit);
 	void clear();
@@ -24,11 +26,15 @@ private:
 	static CGALCache *inst;
 
 	struct cache_entry {
+		CGALCache *owner;
+		std::string id;
 		shared_ptr<const CGAL_Nef_polyhedron> N;
 		std::string msg;
-		cache_entry(const shared_ptr<const CGAL_Nef_polyhedron> &N);
-		~cache_entry() { }
+		cache_entry(CGALCache *owner, const std::string &id, const shared_ptr<const CGAL_Nef_polyhedron> &N);
+		~cache_entry();
 	};
 
+	// Ids of the entries holding each polyhedron, for updateSize()
+	std::unordered_multimap<const CGAL_Nef_polyhedron *, std::string> ids;
 	Cache<std::string, cache_entry> cache;
 };
@@ -12,6 +12,7 @@ CGAL_Nef_polyhedron::CGAL_Nef_polyhedron(CGAL_Nef_polyhedron3 *p)
 
 // Copy constructor
 CGAL_Nef_polyhedron::CGAL_Nef_polyhedron(const CGAL_Nef_polyhedron &src)
+	: polyset(src.polyset)
 {
 	if (src.p3) this->p3.reset(new CGAL_Nef_polyhedron3(*src.p3));
 }
@@ -19,24 +20,28 @@ CGAL_Nef_polyhedron::CGAL_Nef_polyhedron(const CGAL_Nef_polyhedron &src)
 CGAL_Nef_polyhedron& CGAL_Nef_polyhedron::operator+=(const CGAL_Nef_polyhedron &other)
 {
 	(*this->p3) += (*other.p3);
+	this->polyset.reset();
 	return *this;
 }
 
 CGAL_Nef_polyhedron& CGAL_Nef_polyhedron::operator*=(const CGAL_Nef_polyhedron &other)
 {
 	(*this->p3) *= (*other.p3);
+	this->polyset.reset();
 	return *this;
 }
 
 CGAL_Nef_polyhedron& CGAL_Nef_polyhedron::operator-=(const CGAL_Nef_polyhedron &other)
 {
 	(*this->p3) -= (*other.p3);
+	this->polyset.reset();
 	return *this;
 }
 
 CGAL_Nef_polyhedron &CGAL_Nef_polyhedron::minkowski(const CGAL_Nef_polyhedron &other)
 {
 	(*this->p3) = CGAL::minkowski_sum_3(*this->p3, *other.p3);
+	this->polyset.reset();
 	return *this;
 }
 
@@ -46,6 +51,7 @@ size_t CGAL_Nef_polyhedron::memsize() const
 
 	size_t memsize = sizeof(CGAL_Nef_polyhedron);
 	memsize += this->p3->bytes();
+	if (this->polyset) memsize += this->polyset->memsize();
 	return memsize;
 }
 
@@ -156,6 +162,7 @@ void CGAL_Nef_polyhedron::transform( const Transform3d &matrix )
 				matrix(1,0), matrix(1,1), matrix(1,2), matrix(1,3),
 				matrix(2,0), matrix(2,1), matrix(2,2), matrix(2,3), matrix(3,3));
 			this->p3->transform(t);
+			this->polyset.reset();
 		}
 	}
 }
@@ -22,7 +22,7 @@ public:
 	virtual bool isEmpty() const;
 	virtual Geometry *copy() const { return new CGAL_Nef_polyhedron(*this); }
 
-	void reset() { p3.reset(); }
+	void reset() { p3.reset(); polyset.reset(); }
 	CGAL_Nef_polyhedron &operator+=(const CGAL_Nef_polyhedron &other);
 	CGAL_Nef_polyhedron &operator*=(const CGAL_Nef_polyhedron &other);
 	CGAL_Nef_polyhedron &operator-=(const CGAL_Nef_polyhedron &other);
@@ -33,4 +33,7 @@ public:
 	void resize(const Vector3d &newsize, const Eigen::Matrix<bool,3,1> &autosize);
 
 	shared_ptr<CGAL_Nef_polyhedron3> p3;
+	// PolySet extracted from p3 by CGALUtils::getPolySet(), or a marker for a
+	// failed extraction. Reset when p3 is modified.
+	mutable shared_ptr<const class PolySet> polyset;
 };
@@ -119,3 +119,15 @@ void DrawingCallback::curve_to(const Vector2d &c1, const Vector2d &c2, const Vec
 	}
 	pen = to;
 }
+
+// Outlines already flattened by an earlier glyph, placed like drawn ones
+void DrawingCallback::add_outlines(const std::vector<Outline2d> &outlines)
+{
+	for (const auto &o : outlines) {
+		move_to(o.vertices.front());
+		for (size_t idx = 1;idx < o.vertices.size();idx++) {
+			add_vertex(o.vertices[idx]);
+		}
+		pen = o.vertices.back();
+	}
+}
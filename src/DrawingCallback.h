@@ -45,6 +45,7 @@ public:
     void line_to(const Vector2d &to);
     void curve_to(const Vector2d &c1, const Vector2d &to);
     void curve_to(const Vector2d &c1, const Vector2d &c2, const Vector2d &to);
+    void add_outlines(const std::vector<Outline2d> &outlines);
 private:
     Vector2d pen;
     Vector2d offset;
@@ -0,0 +1,224 @@
+#include "FileWatcher.h"
+#include "printutils.h"
+
+#include <vector>
+#include <boost/filesystem.hpp>
+namespace fs = boost::filesystem;
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
+FileWatcher *FileWatcher::inst = NULL;
+
+#ifdef __linux__
+/*!
+	inotify only sees changes made through the local kernel, so changes made
+	by other clients of a network filesystem would go unnoticed.
+*/
+static bool is_network_fs(const std::string &dir)
+{
+	struct statfs st;
+	if (statfs(dir.c_str(), &st) != 0) return false;
+	switch ((unsigned long)st.f_type) {
+	case 0x6969:     // NFS_SUPER_MAGIC
+	case 0x517B:     // SMB_SUPER_MAGIC
+	case 0xFF534D42: // CIFS_MAGIC_NUMBER
+	case 0xFE534D42: // SMB2_MAGIC_NUMBER
+		return true;
+	default:
+		return false;
+	}
+}
+#endif
+
+FileWatcher::FileWatcher() : fd(-1), current(1)
+{
+#ifdef __linux__
+	this->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+	disable();
+}
+
+/*!
+	Stops watching; from now on changedSince() is always true.
+*/
+void FileWatcher::disable()
+{
+#ifdef __linux__
+	if (this->fd >= 0) {
+		PRINTD("FileWatcher: falling back to polling");
+		close(this->fd);
+	}
+#endif
+	this->fd = -1;
+}
+
+/*!
+	Records that dependent depends on filename, and starts watching filename.
+*/
+void FileWatcher::addDependency(const std::string &filename, const std::string &dependent)
+{
+	boost::mutex::scoped_lock lock(this->mutex);
+	this->dependents[filename].insert(dependent);
+	addWatch(filename);
+	if (this->polled.count(filename)) markPolled(dependent);
+}
+
+/*!
+	Starts watching filename. Callers should do this before reading the file,
+	so changes made while it's being read aren't missed.
+*/
+void FileWatcher::watch(const std::string &filename)
+{
+	boost::mutex::scoped_lock lock(this->mutex);
+	addWatch(filename);
+}
+
+void FileWatcher::addWatch(const std::string &filename)
+{
+#ifdef __linux__
+	if (this->fd < 0 || this->files.count(filename) || this->polled.count(filename)) return;
+	if (!addWatches(filename)) return;
+	this->files.insert(filename);
+	this->changed[filename] = this->current;
+#endif
+}
+
+/*!
+	Watches the directory of filename and, if filename is a symbolic link,
+	the directories of the files it leads to, since editing those doesn't
+	touch the directory holding the link. Returns false if filename is polled
+	or watching was disabled instead.
+*/
+bool FileWatcher::addWatches(const std::string &filename)
+{
+#ifdef __linux__
+	fs::path path(filename);
+	// Same limit as the kernel's for nested links
+	for (int links = 0; links <= 40; links++) {
+		// Watch the directory rather than the file, so files being replaced by
+		// editors or appearing later are noticed too
+		std::string dir = path.parent_path().string();
+		if (is_network_fs(dir.empty() ? "." : dir)) {
+			PRINTDB("FileWatcher: polling '%s' on a network filesystem", filename);
+			markPolled(filename);
+			return false;
+		}
+		int wd = inotify_add_watch(this->fd, dir.empty() ? "." : dir.c_str(),
+															 IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |
+															 IN_MOVED_FROM | IN_MOVED_TO | IN_MOVE_SELF | IN_ONLYDIR);
+		if (wd < 0) {
+			// Files we can't watch could hide changes of everything depending on them
+			PRINTDB("FileWatcher: can't watch '%s': %s", dir % strerror(errno));
+			disable();
+			return false;
+		}
+		this->watches[wd].insert(dir);
+		if (path.string() != filename) this->targets[path.string()].insert(filename);
+
+		boost::system::error_code ec;
+		if (!fs::is_symlink(fs::symlink_status(path, ec))) break;
+		fs::path target = fs::read_symlink(path, ec);
+		if (ec) break;
+		path = target.is_absolute() ? target : path.parent_path() / target;
+	}
+#endif
+	return true;
+}
+
+/*!
+	Marks filename and everything depending on it as polled: changedSince()
+	is always true for them, so callers keep checking timestamps.
+*/
+void FileWatcher::markPolled(const std::string &filename)
+{
+	std::vector<std::string> todo(1, filename);
+	while (!todo.empty()) {
+		std::string file = todo.back();
+		todo.pop_back();
+		if (!this->polled.insert(file).second) continue;
+		auto it = this->dependents.find(file);
+		if (it != this->dependents.end()) todo.insert(todo.end(), it->second.begin(), it->second.end());
+	}
+}
+
+/*!
+	Processes pending change notifications and returns the current generation.
+*/
+unsigned long FileWatcher::update()
+{
+	boost::mutex::scoped_lock lock(this->mutex);
+#ifdef __linux__
+	std::vector<std::string> modified;
+	char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	ssize_t len;
+	while (this->fd >= 0 && (len = read(this->fd, buf, sizeof(buf))) > 0) {
+		for (char *ptr = buf; ptr < buf + len; ) {
+			const struct inotify_event *event = (const struct inotify_event *)ptr;
+			ptr += sizeof(struct inotify_event) + event->len;
+
+			// Lost events, or a watched directory went away
+			if (event->mask & (IN_Q_OVERFLOW | IN_IGNORED | IN_MOVE_SELF)) {
+				disable();
+				break;
+			}
+			if (event->len == 0) continue;
+			for (const auto &dir : this->watches[event->wd]) {
+				std::string filename = (fs::path(dir) / event->name).string();
+				if (this->files.count(filename)) modified.push_back(filename);
+				auto it = this->targets.find(filename);
+				if (it != this->targets.end()) modified.insert(modified.end(), it->second.begin(), it->second.end());
+			}
+		}
+	}
+	if (modified.empty()) return this->current;
+
+	// Links may have been pointed elsewhere
+	for (const auto &filename : modified) {
+		if (this->fd >= 0 && this->files.count(filename) && !this->polled.count(filename)) addWatches(filename);
+	}
+
+	// Mark the modified files and everything depending on them
+	this->current++;
+	std::unordered_set<std::string> visited;
+	while (!modified.empty()) {
+		std::string filename = modified.back();
+		modified.pop_back();
+		if (!visited.insert(filename).second) continue;
+		this->changed[filename] = this->current;
+		auto it = this->dependents.find(filename);
+		if (it != this->dependents.end()) {
+			modified.insert(modified.end(), it->second.begin(), it->second.end());
+		}
+	}
+#endif
+	return this->current;
+}
+
+unsigned long FileWatcher::generation()
+{
+	boost::mutex::scoped_lock lock(this->mutex);
+	return this->current;
+}
+
+/*!
+	Returns false only if filename is watched and neither it nor anything it
+	depends on changed after the given generation. Files on network
+	filesystems, and files depending on them, are never reported unchanged.
+*/
+bool FileWatcher::changedSince(const std::string &filename, unsigned long generation)
+{
+	boost::mutex::scoped_lock lock(this->mutex);
+	if (this->fd < 0 || !this->files.count(filename) || this->polled.count(filename)) return true;
+	auto it = this->changed.find(filename);
+	return it == this->changed.end() || it->second > generation;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <boost/thread/mutex.hpp>
+
+/*!
+	Tracks changes to the dependencies reported through handle_dep().
+
+	handle_dep() records which file depends on which, building a dependency
+	graph. On Linux, the directories of all dependencies, and of the files
+	symbolic links among them point to, are watched using inotify. When a
+	file changes, the file and everything depending on it, transitively, is
+	marked with a new generation number.
+
+	Callers remember the generation returned by update() when they checked
+	a file, and only need to look at it again if changedSince() says so.
+	Where inotify isn't available, changedSince() is always true, and callers
+	fall back to polling file timestamps. The same goes for files on network
+	filesystems, which inotify doesn't see remote changes of, and for
+	everything depending on them.
+*/
+class FileWatcher
+{
+public:
+	static FileWatcher *instance() { if (!inst) inst = new FileWatcher; return inst; }
+
+	void addDependency(const std::string &filename, const std::string &dependent);
+	void watch(const std::string &filename);
+	unsigned long update();
+	unsigned long generation();
+	bool changedSince(const std::string &filename, unsigned long generation);
+	bool isEnabled() const { return this->fd >= 0; }
+
+private:
+	FileWatcher();
+	~FileWatcher();
+
+	void addWatch(const std::string &filename);
+	bool addWatches(const std::string &filename);
+	void markPolled(const std::string &filename);
+	void disable();
+
+	static FileWatcher *inst;
+
+	boost::mutex mutex;
+	int fd;
+	unsigned long current;
+
+	// Watched files
+	std::unordered_set<std::string> files;
+	// Files which are polled instead of watched
+	std::unordered_set<std::string> polled;
+	// Generation of the last change of each file in the graph
+	std::unordered_map<std::string, unsigned long> changed;
+	// Files depending on each file
+	std::unordered_map<std::string, std::unordered_set<std::string>> dependents;
+	// Files reached through symbolic links, and the watched files leading to them
+	std::unordered_map<std::string, std::unordered_set<std::string>> targets;
+	// Watch descriptors and the directory names they were added for
+	std::unordered_map<int, std::unordered_set<std::string>> watches;
+};
@@ -25,6 +25,11 @@
  */
 
 #include <iostream>
+#include <fstream>
+
+#include <sys/stat.h>
+#include <string.h>
+#include <unistd.h>
 
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
@@ -94,30 +99,29 @@ void FontCache::defaultInitHandler(FontCacheInitializer *initializer, void *)
 	initializer->run();
 }
 
-FontCache::FontCache()
-{
-	this->init_ok = false;
+std::string FontCache::snapshot_file;
 
-	// If we've got a bundled fonts.conf, initialize fontconfig with our own config
-	// by overriding the built-in fontconfig path.
-	// For system installs and dev environments, we leave this alone
-	fs::path fontdir(PlatformUtils::resourcePath("fonts"));
-	if (fs::is_regular_file(fontdir / "fonts.conf")) {
-		PlatformUtils::setenv("FONTCONFIG_PATH", boosty::stringy(boosty::absolute(fontdir)).c_str(), 0);
-	}
+// Bump when the snapshot format changes
+static const char *SNAPSHOT_MAGIC = "OpenSCAD font cache 1";
 
-	// Just load the configs. We'll build the fonts once all configs are loaded
-	this->config = FcInitLoadConfig();
-	if (!this->config) {
-		PRINT("WARNING: Can't initialize fontconfig library, text() objects will not be rendered");
-		return;
-	}
+static long get_mtime(const std::string &path)
+{
+	struct stat st;
+	memset(&st, 0, sizeof(struct stat));
+	if (stat(path.c_str(), &st) != 0) return -1;
+	return st.st_mtime;
+}
+
+/*!
+	Returns the font directories OpenSCAD adds to the fontconfig configuration.
+*/
+static std::vector<std::string> get_font_dirs()
+{
+	std::vector<std::string> dirs;
 
-	// Add the built-in fonts & config
 	fs::path builtinfontpath(PlatformUtils::resourcePath("fonts"));
 	if (fs::is_directory(builtinfontpath)) {
-		FcConfigParseAndLoad(this->config, reinterpret_cast<const FcChar8 *>(boosty::stringy(builtinfontpath).c_str()), false);
-		add_font_dir(boosty::stringy(boosty::canonical(builtinfontpath)));
+		dirs.push_back(boosty::stringy(boosty::canonical(builtinfontpath)));
 	}
 
 	const char *home = getenv("HOME");
@@ -125,7 +129,7 @@ FontCache::FontCache()
 	// Add Linux font folders, the system folders are expected to be
 	// configured by the system configuration for fontconfig.
 	if (home) {
-		add_font_dir(std::string(home) + "/.fonts");
+		dirs.push_back(std::string(home) + "/.fonts");
 	}
 
 	const char *env_font_path = getenv("OPENSCAD_FONT_PATH");
@@ -136,15 +140,88 @@ FontCache::FontCache()
 		for (string_split_iterator it = boost::make_split_iterator(paths, boost::first_finder(sep, boost::is_iequal())); it != string_split_iterator(); it++) {
 			const fs::path p(boost::copy_range<std::string>(*it));
 			if (fs::exists(p) && fs::is_directory(p)) {
-				std::string path = boosty::absolute(p).string();
-				add_font_dir(path);
+				dirs.push_back(boosty::absolute(p).string());
 			}
 		}
 	}
+	return dirs;
+}
+
+FontFace::FontFace(FT_Face face, const std::string &file, boost::recursive_mutex &library_mutex)
+	: face(face), file(file), library_mutex(library_mutex)
+{
+}
+
+FontFace::~FontFace()
+{
+	boost::recursive_mutex::scoped_lock lock(this->library_mutex);
+	FT_Done_Face(this->face);
+}
+
+size_t FontFace::get_size() const
+{
+	return this->face->stream ? this->face->stream->size : 0;
+}
+
+FontCache::FontCache()
+	: initialized(false), init_ok(false), cache_size(0), hits(0), misses(0), config(NULL), library(NULL)
+{
+	this->font_dirs = get_font_dirs();
+
+	// Everything else which decides the fontconfig configuration
+	const char *env[] = { "FONTCONFIG_PATH", "FONTCONFIG_FILE" };
+	this->snapshot_key = boost::algorithm::join(this->font_dirs, ":");
+	for (const char *name : env) {
+		const char *value = getenv(name);
+		this->snapshot_key += std::string("|") + (value ? value : "");
+	}
+
+	load_snapshot();
+}
+
+/*!
+	Loads the fontconfig configuration and builds the font database. This is
+	done on first use, unless the snapshot can answer the lookups.
+*/
+void FontCache::init()
+{
+	boost::recursive_mutex::scoped_lock lock(this->mutex);
+	if (this->initialized) return;
+	this->initialized = true;
+
+	// If we've got a bundled fonts.conf, initialize fontconfig with our own config
+	// by overriding the built-in fontconfig path.
+	// For system installs and dev environments, we leave this alone
+	fs::path fontdir(PlatformUtils::resourcePath("fonts"));
+	if (fs::is_regular_file(fontdir / "fonts.conf")) {
+		PlatformUtils::setenv("FONTCONFIG_PATH", boosty::stringy(boosty::absolute(fontdir)).c_str(), 0);
+	}
+
+	// Just load the configs. We'll build the fonts once all configs are loaded
+	this->config = FcInitLoadConfig();
+	if (!this->config) {
+		PRINT("WARNING: Can't initialize fontconfig library, text() objects will not be rendered");
+		return;
+	}
+
+	// Add the built-in fonts & config
+	fs::path builtinfontpath(PlatformUtils::resourcePath("fonts"));
+	if (fs::is_directory(builtinfontpath)) {
+		FcConfigParseAndLoad(this->config, reinterpret_cast<const FcChar8 *>(boosty::stringy(builtinfontpath).c_str()), false);
+	}
+	for (const auto &dir : this->font_dirs) {
+		add_font_dir(dir);
+	}
 
 	FontCacheInitializer initializer(this->config);
 	cb_handler(&initializer, cb_userdata);
 
+	for (const auto &file : this->font_files) {
+		if (!FcConfigAppFontAddFile(this->config, reinterpret_cast<const FcChar8 *>(file.c_str()))) {
+			PRINTB("Can't register font '%s'", file);
+		}
+	}
+
 	// For use by LibraryInfo
 	FcStrList *dirs = FcConfigGetFontDirs(this->config);
 	while (FcChar8 *dir = FcStrListNext(dirs)) {
@@ -152,13 +229,127 @@ FontCache::FontCache()
 	}
 	FcStrListDone(dirs);
 
+	if (!init_library()) return;
+
+	this->init_ok = true;
+
+	if (!snapshot_file.empty() && !this->snapshot.valid && this->font_files.empty()) {
+		// Directory modification times change when fonts are added or removed
+		Snapshot snapshot;
+		for (const auto &dir : this->font_dirs) {
+			snapshot.paths.push_back(std::make_pair(dir, get_mtime(dir)));
+		}
+		for (const auto &dir : fontpath) {
+			snapshot.paths.push_back(std::make_pair(dir, get_mtime(dir)));
+		}
+		FcStrList *files = FcConfigGetConfigFiles(this->config);
+		while (FcChar8 *file = FcStrListNext(files)) {
+			std::string path((const char *)file);
+			snapshot.paths.push_back(std::make_pair(path, get_mtime(path)));
+		}
+		FcStrListDone(files);
+
+		FontInfoList *fonts = list_fonts_fontconfig();
+		snapshot.fonts = *fonts;
+		delete fonts;
+
+		snapshot.valid = true;
+		this->snapshot = snapshot;
+		save_snapshot();
+	}
+}
+
+bool FontCache::init_library()
+{
+	if (this->library) return true;
 	const FT_Error error = FT_Init_FreeType(&this->library);
 	if (error) {
+		this->library = NULL;
 		PRINT("WARNING: Can't initialize freetype library, text() objects will not be rendered");
-		return;
+		return false;
 	}
+	return true;
+}
 
-	this->init_ok = true;
+/*!
+	Font files registered by the design may change which fonts match, so
+	those are always resolved by fontconfig.
+*/
+bool FontCache::use_snapshot() const
+{
+	return this->snapshot.valid && this->font_files.empty();
+}
+
+void FontCache::load_snapshot()
+{
+	if (snapshot_file.empty()) return;
+
+	std::ifstream ifs(snapshot_file.c_str());
+	std::string line;
+	if (!std::getline(ifs, line) || line != SNAPSHOT_MAGIC) return;
+
+	Snapshot snapshot;
+	bool key_ok = false;
+	while (std::getline(ifs, line)) {
+		std::vector<std::string> fields;
+		boost::split(fields, line, boost::is_any_of("\t"));
+		if (fields[0] == "key" && fields.size() == 2) {
+			key_ok = fields[1] == this->snapshot_key;
+		} else if (fields[0] == "path" && fields.size() == 3) {
+			snapshot.paths.push_back(std::make_pair(fields[2], atol(fields[1].c_str())));
+		} else if (fields[0] == "font" && fields.size() == 4) {
+			snapshot.fonts.push_back(FontInfo(fields[1], fields[2], fields[3]));
+		} else if (fields[0] == "match" && fields.size() == 4) {
+			snapshot.matches[fields[3]] = std::make_pair(fields[2], atoi(fields[1].c_str()));
+		} else {
+			return;
+		}
+	}
+	if (!key_ok) return;
+
+	for (const auto &path : snapshot.paths) {
+		if (get_mtime(path.first) != path.second) {
+			PRINTDB("Font snapshot is outdated: %s", path.first);
+			return;
+		}
+	}
+	snapshot.valid = true;
+	this->snapshot = snapshot;
+}
+
+void FontCache::save_snapshot() const
+{
+	if (snapshot_file.empty()) return;
+
+	// Write to a temporary file and rename, so concurrent processes never
+	// see a partial snapshot
+	std::string tmpfile = str(boost::format("%s.%d.tmp") % snapshot_file % getpid());
+	try {
+		{
+			std::ofstream ofs(tmpfile.c_str());
+			if (!ofs.is_open()) return;
+			ofs << SNAPSHOT_MAGIC << "\n";
+			ofs << "key\t" << this->snapshot_key << "\n";
+			for (const auto &path : this->snapshot.paths) {
+				ofs << "path\t" << path.second << "\t" << path.first << "\n";
+			}
+			for (const auto &font : this->snapshot.fonts) {
+				ofs << "font\t" << font.get_family() << "\t" << font.get_style() << "\t" << font.get_file() << "\n";
+			}
+			for (const auto &match : this->snapshot.matches) {
+				ofs << "match\t" << match.second.second << "\t" << match.second.first << "\t" << match.first << "\n";
+			}
+			if (!ofs.good()) {
+				ofs.close();
+				fs::remove(tmpfile);
+				return;
+			}
+		}
+		fs::rename(tmpfile, snapshot_file);
+	}
+	catch (const fs::filesystem_error &e) {
+		PRINTDB("Font snapshot: %s", e.what());
+	}
 }
 
 FontCache::~FontCache()
@@ -167,6 +358,8 @@ FontCache::~FontCache()
 
 FontCache * FontCache::instance()
 {
+	static boost::mutex instance_mutex;
+	boost::mutex::scoped_lock lock(instance_mutex);
 	if (!self) {
 		self = new FontCache();
 	}
@@ -181,6 +374,9 @@ void FontCache::registerProgressHandler(InitHandlerFunc *handler, void *userdata
 
 void FontCache::register_font_file(const std::string &path)
 {
+	boost::recursive_mutex::scoped_lock lock(this->mutex);
+	this->font_files.push_back(path);
+	if (!this->config) return;
 	if (!FcConfigAppFontAddFile(this->config, reinterpret_cast<const FcChar8 *> (path.c_str()))) {
 		PRINTB("Can't register font '%s'", path);
 	}
@@ -196,7 +392,20 @@ void FontCache::add_font_dir(const std::string &path)
 	}
 }
 
-FontInfoList *FontCache::list_fonts() const
+FontInfoList *FontCache::list_fonts()
+{
+	boost::recursive_mutex::scoped_lock lock(this->mutex);
+	if (use_snapshot()) {
+		return new FontInfoList(this->snapshot.fonts);
+	}
+	init();
+	if (!this->config) {
+		return new FontInfoList();
+	}
+	return list_fonts_fontconfig();
+}
+
+FontInfoList *FontCache::list_fonts_fontconfig() const
 {
 	FcObjectSet *object_set = FcObjectSetBuild(FC_FAMILY, FC_STYLE, FC_FILE, (char *) 0);
 	FcPattern *pattern = FcPatternCreate();
@@ -227,67 +436,104 @@ FontInfoList *FontCache::list_fonts() const
 	return list;
 }
 
-bool FontCache::is_init_ok() const
+bool FontCache::is_init_ok()
 {
+	boost::recursive_mutex::scoped_lock lock(this->mutex);
+	if (use_snapshot()) {
+		return init_library();
+	}
+	init();
 	return this->init_ok;
 }
 
 void FontCache::clear()
 {
+	boost::recursive_mutex::scoped_lock lock(this->mutex);
 	this->cache.clear();
+	this->lru.clear();
+	this->cache_size = 0;
+}
+
+void FontCache::print()
+{
+	boost::recursive_mutex::scoped_lock lock(this->mutex);
+	PRINTB("Fonts in cache: %d", this->lru.size());
+	PRINTB("Font cache size in bytes: %d", this->cache_size);
+	PRINTB("Font lookups: %d hits, %d misses", this->hits % this->misses);
 }
 
 void FontCache::dump_cache(const std::string &info)
 {
 	std::cout << info << ":";
-	for (cache_t::iterator it = this->cache.begin(); it != this->cache.end(); it++) {
-		std::cout << " " << (*it).first << " (" << (*it).second.second << ")";
+	for (lru_t::iterator it = this->lru.begin(); it != this->lru.end(); it++) {
+		std::cout << " " << (*it).first << " (" << (*it).second->get_size() << ")";
 	}
 	std::cout << std::endl;
 }
 
+/*!
+	Evicts the least recently used faces until the cache fits its size limit.
+	The most recently used face is always kept.
+*/
 void FontCache::check_cleanup()
 {
-	if (this->cache.size() < MAX_NR_OF_CACHE_ENTRIES) {
-		return;
-	}
-
-	cache_t::iterator pos = this->cache.begin()++;
-	for (cache_t::iterator it = this->cache.begin(); it != this->cache.end(); it++) {
-		if ((*pos).second.second > (*it).second.second) {
-			pos = it;
-		}
+	while (this->cache_size > MAX_CACHE_SIZE && this->lru.size() > 1) {
+		const lru_t::value_type &victim = this->lru.back();
+		this->cache_size -= victim.second->get_size();
+		this->cache.erase(victim.first);
+		this->lru.pop_back();
 	}
-	FT_Done_Face((*pos).second.first);
-	this->cache.erase(pos);
 }
 
-FT_Face FontCache::get_font(const std::string &font)
+FontFacePtr FontCache::get_font(const std::string &font)
 {
-	FT_Face face;
+	boost::recursive_mutex::scoped_lock lock(this->mutex);
 	cache_t::iterator it = this->cache.find(font);
-	if (it == this->cache.end()) {
-		face = find_face(font);
-		if (!face) {
-			return NULL;
-		}
-		check_cleanup();
-	} else {
-		face = (*it).second.first;
+	if (it != this->cache.end()) {
+		this->hits++;
+		this->lru.splice(this->lru.begin(), this->lru, it->second);
+		return it->second->second;
 	}
-	this->cache[font] = cache_entry_t(face, time(NULL));
-	return face;
+
+	this->misses++;
+	std::string file;
+	FT_Face face = find_face(font, file);
+	if (!face) {
+		return FontFacePtr();
+	}
+	FontFacePtr entry(new FontFace(face, file, this->mutex));
+	this->lru.push_front(std::make_pair(font, entry));
+	this->cache[font] = this->lru.begin();
+	this->cache_size += entry->get_size();
+	check_cleanup();
+	return entry;
 }
 
-FT_Face FontCache::find_face(const std::string &font) const
+/*!
+	Opens the face for a font name. file is set to the font file it was
+	opened from.
+*/
+FT_Face FontCache::find_face(const std::string &font, std::string &file)
 {
 	std::string trimmed(font);
 	boost::algorithm::trim(trimmed);
 
 	const std::string lookup = trimmed.empty() ? DEFAULT_FONT : trimmed;
 	PRINTDB("font = \"%s\", lookup = \"%s\"", font % lookup);
-	FT_Face face = find_face_fontconfig(lookup);
-	PRINTDB("result = \"%s\", style = \"%s\"", face->family_name % face->style_name);
+	FT_Face face = NULL;
+	if (use_snapshot() && init_library()) {
+		auto match = this->snapshot.matches.find(lookup);
+		if (match != this->snapshot.matches.end()) {
+			face = open_face(match->second.first, match->second.second);
+			if (face) file = match->second.first;
+		}
+	}
+	if (!face) {
+		face = find_face_fontconfig(lookup, file);
+	}
+	if (face) {
+		PRINTDB("result = \"%s\", style = \"%s\"", face->family_name % face->style_name);
+	}
 	return face;
 }
 
@@ -301,8 +547,13 @@ void FontCache::init_pattern(FcPattern *pattern) const
 	FcPatternAdd(pattern, FC_SCALABLE, true_value, true);
 }
 
-FT_Face FontCache::find_face_fontconfig(const std::string &font) const
+FT_Face FontCache::find_face_fontconfig(const std::string &font, std::string &file)
 {
+	init();
+	if (!this->init_ok) {
+		return NULL;
+	}
+
 	FcResult result;
 
 	FcPattern *pattern = FcNameParse((unsigned char *)font.c_str());
@@ -323,12 +574,28 @@ FT_Face FontCache::find_face_fontconfig(const std::string &font) const
 		return NULL;
 	}
 	
-	FT_Face face;
-	FT_Error error = FT_New_Face(this->library, (const char *) file_value.u.s, font_index.u.i, &face);
+	file = (const char *) file_value.u.s;
+	int index = font_index.u.i;
 
 	FcPatternDestroy(pattern);
 	FcPatternDestroy(match);
 
+	FT_Face face = open_face(file, index);
+	if (face && use_snapshot()) {
+		this->snapshot.matches[font] = std::make_pair(file, index);
+		save_snapshot();
+	}
+	return face;
+}
+
+FT_Face FontCache::open_face(const std::string &file, int index) const
+{
+	FT_Face face;
+	FT_Error error = FT_New_Face(this->library, file.c_str(), index, &face);
+	if (error) {
+		return NULL;
+	}
+
 	for (int a = 0; a < face->num_charmaps; a++) {
 		FT_CharMap charmap = face->charmaps[a];
 		PRINTDB("charmap = %d: platform = %d, encoding = %d", a % charmap->platform_id % charmap->encoding_id);
@@ -356,7 +623,7 @@ FT_Face FontCache::find_face_fontconfig(const std::string &font) const
 			PRINTB("Warning: Could not select a char map for font %s/%s", face->family_name % face->style_name);
 	}
 	
-	return error ? NULL : face;
+	return face;
 }
 
 bool FontCache::try_charmap(FT_Face face, int platform_id, int encoding_id) const
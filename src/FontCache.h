@@ -26,10 +26,15 @@
 #pragma once
 
 #include <map>
+#include <list>
+#include <unordered_map>
 #include <string>
 #include <iostream>
 
-#include <time.h>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/recursive_mutex.hpp>
+
+#include "memory.h"
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
@@ -72,29 +77,66 @@ private:
     FcConfig *config;
 };
 
+/**
+ * A face shared by the FontCache. FreeType faces can only be used by one
+ * thread at a time, so the mutex must be held while using the face. The
+ * face stays valid while referenced, even if the cache evicts it meanwhile.
+ */
+class FontFace {
+public:
+    FontFace(FT_Face face, const std::string &file, boost::recursive_mutex &library_mutex);
+    virtual ~FontFace();
+
+    FT_Face get_face() const { return face; }
+    // The font file the face was opened from
+    const std::string &get_file() const { return file; }
+    size_t get_size() const;
+
+    boost::mutex mutex;
+private:
+    FT_Face face;
+    std::string file;
+    boost::recursive_mutex &library_mutex;
+};
+
+typedef shared_ptr<FontFace> FontFacePtr;
+
+/**
+ * Fonts are only looked up once text needs to be rendered or the fonts are
+ * listed. Building the fontconfig database can take a long time, so if a
+ * snapshot file is set, the font list and the fonts matched for each font
+ * name are also stored there. As long as no font directory or fontconfig
+ * file has been modified since, fonts are then opened without loading
+ * fontconfig at all.
+ */
 class FontCache {
 public:
     const static std::string DEFAULT_FONT;
-    const static unsigned int MAX_NR_OF_CACHE_ENTRIES = 3;
+    // Faces are accounted with the size of their font file
+    const static size_t MAX_CACHE_SIZE = 64 * 1024 * 1024;
     
     FontCache();
     virtual ~FontCache();
 
-    bool is_init_ok() const;
-    FT_Face get_font(const std::string &font);
+    void init();
+    bool is_init_ok();
+    FontFacePtr get_font(const std::string &font);
     bool is_windows_symbol_font(const FT_Face &face) const;
     void register_font_file(const std::string &path);
     void clear();
-    FontInfoList *list_fonts() const;
+    void print();
+    FontInfoList *list_fonts();
     
     static FontCache *instance();
+    static void setSnapshotFile(const std::string &file) { snapshot_file = file; }
 
     typedef void (InitHandlerFunc)(FontCacheInitializer *initializer, void *userdata);
     static void registerProgressHandler(InitHandlerFunc *handler, void *userdata = NULL);
 
 private:
-    typedef std::pair<FT_Face, time_t> cache_entry_t;
-    typedef std::map<std::string, cache_entry_t> cache_t;
+    // Faces by font name, most recently used first
+    typedef std::list<std::pair<std::string, FontFacePtr>> lru_t;
+    typedef std::unordered_map<std::string, lru_t::iterator> cache_t;
 
     static FontCache *self;
     static InitHandlerFunc *cb_handler;
@@ -102,10 +144,37 @@ private:
 
     static void defaultInitHandler(FontCacheInitializer *delegate, void *userdata);
 
+    struct Snapshot {
+        Snapshot() : valid(false) {}
+        bool valid;
+        // Paths the font list depends on, with their modification times
+        std::vector<std::pair<std::string, long>> paths;
+        FontInfoList fonts;
+        // Font file and face index matched for each font name
+        std::map<std::string, std::pair<std::string, int>> matches;
+    };
+    static std::string snapshot_file;
+
+    bool initialized;
     bool init_ok;
+    // Guards the cache and the FreeType library
+    boost::recursive_mutex mutex;
+    lru_t lru;
     cache_t cache;
+    size_t cache_size;
+    size_t hits, misses;
     FcConfig *config;
     FT_Library library;
+    std::vector<std::string> font_files;
+    std::vector<std::string> font_dirs;
+    Snapshot snapshot;
+    std::string snapshot_key;
+
+    bool init_library();
+    bool use_snapshot() const;
+    void load_snapshot();
+    void save_snapshot() const;
+    FontInfoList *list_fonts_fontconfig() const;
 
     void check_cleanup();
     void dump_cache(const std::string &info);
@@ -113,8 +182,9 @@ private:
     void add_font_dir(const std::string &path);
     void init_pattern(FcPattern *pattern) const;
     
-    FT_Face find_face(const std::string &font) const;
-    FT_Face find_face_fontconfig(const std::string &font) const;
+    FT_Face find_face(const std::string &font, std::string &file);
+    FT_Face find_face_fontconfig(const std::string &font, std::string &file);
+    FT_Face open_face(const std::string &file, int index) const;
     bool try_charmap(FT_Face face, int platform_id, int encoding_id) const;
 };
 
@@ -33,6 +33,8 @@
 #include <fontconfig/fontconfig.h>
 
 #include "printutils.h"
+#include "cache.h"
+#include "memory.h"
 
 #include "FontCache.h"
 #include "DrawingCallback.h"
@@ -48,6 +50,54 @@ static inline Vector2d get_scaled_vector(const FT_Vector *ft_vector, double scal
 
 const double FreetypeRenderer::scale = 1000;
 
+/*!
+	Glyph indices and positions HarfBuzz produced for a string.
+*/
+struct FreetypeRenderer::ShapedText {
+	struct Glyph {
+		FT_UInt index;
+		hb_glyph_position_t pos;
+	};
+	std::vector<Glyph> glyphs;
+	hb_direction_t direction;
+	bool invalid_utf8;
+};
+
+/*!
+	Flattened outlines of a glyph relative to its origin, with its control
+	box. If the glyph couldn't be loaded, error holds the message format.
+*/
+struct FreetypeRenderer::GlyphOutline {
+	GlyphOutline() : error(NULL) {}
+	std::vector<Outline2d> outlines;
+	FT_BBox bbox;
+	const char *error;
+};
+
+// Shaping results and glyph outlines are shared by all text() nodes, so
+// repeated strings and characters are only processed once. Entries stay
+// valid while being placed even if evicted meanwhile. Costs are in bytes.
+static boost::mutex cache_mutex;
+Cache<std::string, shared_ptr<const FreetypeRenderer::ShapedText>> FreetypeRenderer::shaping_cache(4 * 1024 * 1024);
+Cache<std::string, shared_ptr<const FreetypeRenderer::GlyphOutline>> FreetypeRenderer::glyph_cache(16 * 1024 * 1024);
+
+// Faces are shared, so every user sets the size again while holding the lock
+static FT_Error set_char_size(FT_Face face, FT_F26Dot6 char_size)
+{
+	return FT_Set_Char_Size(face, 0, char_size, 100, 100);
+}
+
+/*!
+	Identifies a face at a char size independently of the font name which
+	selected it and of the address FontCache happens to keep it at. Faces
+	are told apart by font file and index, since different files may well
+	contain faces with the same names.
+*/
+static std::string get_font_key(const FontFace &font, FT_F26Dot6 char_size)
+{
+	return str(boost::format("%s|%d|%d") % font.get_file() % font.get_face()->face_index % char_size);
+}
+
 FreetypeRenderer::FreetypeRenderer()
 {
 	funcs.move_to = outline_move_to_func;
@@ -193,28 +243,30 @@ void FreetypeRenderer::detect_properties(FreetypeRenderer::Params &params) const
 	params.set_direction(hb_direction_to_string(direction));
 }
 
-std::vector<const Geometry *> FreetypeRenderer::render(const FreetypeRenderer::Params &params) const
+void FreetypeRenderer::clear_cache()
 {
-	FT_Face face;
-	FT_Error error;
-	DrawingCallback callback(params.segments);
-	
-	FontCache *cache = FontCache::instance();
-	if (!cache->is_init_ok()) {
-		return std::vector<const Geometry *>();
-	}
+	boost::mutex::scoped_lock lock(cache_mutex);
+	shaping_cache.clear();
+	glyph_cache.clear();
+}
 
-	face = cache->get_font(params.font);
-	if (face == NULL) {
-		return std::vector<const Geometry *>();
-	}
-	
-	error = FT_Set_Char_Size(face, 0, params.size * scale, 100, 100);
-	if (error) {
-		PRINTB("Can't set font size for font %s", params.font);
-		return std::vector<const Geometry *>();
+shared_ptr<const FreetypeRenderer::ShapedText> FreetypeRenderer::shape(FontFace &font, FT_F26Dot6 char_size, const std::string &font_key, const FreetypeRenderer::Params &params) const
+{
+	std::string key = str(boost::format("%s|%s|%s|%s|%s")
+		% font_key % params.direction % params.script % params.language % params.text);
+	{
+		boost::mutex::scoped_lock lock(cache_mutex);
+		const shared_ptr<const ShapedText> *cached = shaping_cache[key];
+		if (cached) return *cached;
 	}
-	
+
+	boost::mutex::scoped_lock face_lock(font.mutex);
+	FT_Face face = font.get_face();
+	set_char_size(face, char_size);
+
+	ShapedText *shaped = new ShapedText();
+	shaped->invalid_utf8 = false;
+
 	hb_font_t *hb_ft_font = hb_ft_font_create(face, NULL);
 
 	hb_buffer_t *hb_buf = hb_buffer_create();
@@ -242,7 +294,7 @@ std::vector<const Geometry *> FreetypeRenderer::render(const FreetypeRenderer::P
 				p = g_utf8_next_char(p);
 			}
 		} else {
-			PRINTB("Warning: Ignoring text with invalid UTF-8 encoding: \"%s\"", params.text.c_str());
+			shaped->invalid_utf8 = true;
 		}
 	} else {
 		hb_buffer_add_utf8(hb_buf, params.text.c_str(), strlen(params.text.c_str()), 0, strlen(params.text.c_str()));
@@ -253,64 +305,145 @@ std::vector<const Geometry *> FreetypeRenderer::render(const FreetypeRenderer::P
         hb_glyph_info_t *glyph_info = hb_buffer_get_glyph_infos(hb_buf, &glyph_count);
         hb_glyph_position_t *glyph_pos = hb_buffer_get_glyph_positions(hb_buf, &glyph_count);
 
-	GlyphArray glyph_array;
+	shaped->glyphs.resize(glyph_count);
 	for (unsigned int idx = 0;idx < glyph_count;idx++) {
-		FT_UInt glyph_index = glyph_info[idx].codepoint;
-		error = FT_Load_Glyph(face, glyph_index, FT_LOAD_DEFAULT);
-		if (error) {
-			PRINTB("Could not load glyph %u for char at index %u in text '%s'", glyph_index % idx % params.text);
-			continue;
+		shaped->glyphs[idx].index = glyph_info[idx].codepoint;
+		shaped->glyphs[idx].pos = glyph_pos[idx];
+	}
+	shaped->direction = hb_buffer_get_direction(hb_buf);
+
+	hb_buffer_destroy(hb_buf);
+        hb_font_destroy(hb_ft_font);
+
+	shared_ptr<const ShapedText> result(shaped);
+	boost::mutex::scoped_lock lock(cache_mutex);
+	shaping_cache.insert(key, new shared_ptr<const ShapedText>(result), sizeof(ShapedText) + key.size() + glyph_count * sizeof(ShapedText::Glyph));
+	return result;
+}
+
+shared_ptr<const FreetypeRenderer::GlyphOutline> FreetypeRenderer::get_glyph(FontFace &font, FT_F26Dot6 char_size, const std::string &font_key, FT_UInt glyph_index, unsigned long segments) const
+{
+	std::string key = str(boost::format("%s|%d|%d") % font_key % glyph_index % segments);
+	{
+		boost::mutex::scoped_lock lock(cache_mutex);
+		const shared_ptr<const GlyphOutline> *cached = glyph_cache[key];
+		if (cached) return *cached;
+	}
+
+	boost::mutex::scoped_lock face_lock(font.mutex);
+	FT_Face face = font.get_face();
+	set_char_size(face, char_size);
+
+	GlyphOutline *glyph_outline = new GlyphOutline();
+	size_t cost = sizeof(GlyphOutline) + key.size();
+	FT_Glyph glyph;
+	if (FT_Load_Glyph(face, glyph_index, FT_LOAD_DEFAULT)) {
+		glyph_outline->error = "Could not load glyph %u for char at index %u in text '%s'";
+	} else if (FT_Get_Glyph(face->glyph, &glyph)) {
+		glyph_outline->error = "Could not get glyph %u for char at index %u in text '%s'";
+	} else {
+		FT_Glyph_Get_CBox(glyph, FT_GLYPH_BBOX_GRIDFIT, &glyph_outline->bbox);
+
+		DrawingCallback callback(segments);
+		callback.start_glyph();
+		FT_Outline outline = reinterpret_cast<FT_OutlineGlyph>(glyph)->outline;
+		FT_Outline_Decompose(&outline, &funcs, &callback);
+		callback.finish_glyph();
+		FT_Done_Glyph(glyph);
+
+		for (const auto &geom : callback.get_result()) {
+			const Polygon2d *polygon = static_cast<const Polygon2d *>(geom);
+			glyph_outline->outlines = polygon->outlines();
+			delete polygon;
+		}
+		for (const auto &o : glyph_outline->outlines) {
+			cost += sizeof(Outline2d) + o.vertices.size() * sizeof(Vector2d);
 		}
+	}
+
+	shared_ptr<const GlyphOutline> result(glyph_outline);
+	boost::mutex::scoped_lock lock(cache_mutex);
+	glyph_cache.insert(key, new shared_ptr<const GlyphOutline>(result), cost);
+	return result;
+}
+
+std::vector<const Geometry *> FreetypeRenderer::render(const FreetypeRenderer::Params &params) const
+{
+	FT_Error error;
+	DrawingCallback callback(params.segments);
+	
+	FontCache *cache = FontCache::instance();
+	if (!cache->is_init_ok()) {
+		return std::vector<const Geometry *>();
+	}
+
+	FontFacePtr font = cache->get_font(params.font);
+	if (!font) {
+		return std::vector<const Geometry *>();
+	}
+	FT_Face face = font->get_face();
+	
+	FT_F26Dot6 char_size = params.size * scale;
+	{
+		boost::mutex::scoped_lock face_lock(font->mutex);
+		error = set_char_size(face, char_size);
+	}
+	if (error) {
+		PRINTB("Can't set font size for font %s", params.font);
+		return std::vector<const Geometry *>();
+	}
+	
+	const std::string font_key = get_font_key(*font, char_size);
+	shared_ptr<const ShapedText> shaped = shape(*font, char_size, font_key, params);
+	if (shaped->invalid_utf8) {
+		PRINTB("Warning: Ignoring text with invalid UTF-8 encoding: \"%s\"", params.text.c_str());
+	}
 
-		FT_Glyph glyph;
-		error = FT_Get_Glyph(face->glyph, &glyph);
-		if (error) {
-			PRINTB("Could not get glyph %u for char at index %u in text '%s'", glyph_index % idx % params.text);
+	std::vector<shared_ptr<const GlyphOutline>> glyph_array;
+	std::vector<const hb_glyph_position_t *> glyph_pos;
+	for (unsigned int idx = 0;idx < shaped->glyphs.size();idx++) {
+		FT_UInt glyph_index = shaped->glyphs[idx].index;
+		shared_ptr<const GlyphOutline> glyph = get_glyph(*font, char_size, font_key, glyph_index, params.segments);
+		if (glyph->error) {
+			PRINTB(glyph->error, glyph_index % idx % params.text);
 			continue;
 		}
-		const GlyphData *glyph_data = new GlyphData(glyph, idx, &glyph_pos[idx]);
-		glyph_array.push_back(glyph_data);
+		glyph_array.push_back(glyph);
+		glyph_pos.push_back(&shaped->glyphs[idx].pos);
 	}
 
 	double width = 0, ascend = 0, descend = 0;
-	for (GlyphArray::iterator it = glyph_array.begin();it != glyph_array.end();it++) {
-		const GlyphData *glyph = (*it);
-		
-		FT_BBox bbox;
-		FT_Glyph_Get_CBox(glyph->get_glyph(), FT_GLYPH_BBOX_GRIDFIT, &bbox);
+	for (size_t i = 0;i < glyph_array.size();i++) {
+		const FT_BBox &bbox = glyph_array[i]->bbox;
 		
-		if (HB_DIRECTION_IS_HORIZONTAL(hb_buffer_get_direction(hb_buf))) {
+		if (HB_DIRECTION_IS_HORIZONTAL(shaped->direction)) {
 			double asc = std::max(0.0, bbox.yMax / 64.0 / 16.0);
 			double desc = std::max(0.0, -bbox.yMin / 64.0 / 16.0);
-			width += glyph->get_x_advance() * params.spacing;
+			width += glyph_pos[i]->x_advance / 64.0 / 16.0 * params.spacing;
 			ascend = std::max(ascend, asc);
 			descend = std::max(descend, desc);
 		} else {
 			double w_bbox = (bbox.xMax - bbox.xMin) / 64.0 / 16.0;
 			width = std::max(width, w_bbox);
-			ascend += glyph->get_y_advance() * params.spacing;
+			ascend += glyph_pos[i]->y_advance / 64.0 / 16.0 * params.spacing;
 		}
 	}
 	
 	double x_offset = calc_x_offset(params.halign, width);
 	double y_offset = calc_y_offset(params.valign, ascend, descend);
 
-	for (GlyphArray::iterator it = glyph_array.begin();it != glyph_array.end();it++) {
-		const GlyphData *glyph = (*it);
+	for (size_t i = 0;i < glyph_array.size();i++) {
+		const hb_glyph_position_t *pos = glyph_pos[i];
 		
 		callback.start_glyph();
-		callback.set_glyph_offset(x_offset + glyph->get_x_offset(), y_offset + glyph->get_y_offset());
-		FT_Outline outline = reinterpret_cast<FT_OutlineGlyph>(glyph->get_glyph())->outline;
-		FT_Outline_Decompose(&outline, &funcs, &callback);
+		callback.set_glyph_offset(x_offset + pos->x_offset / 64.0 / 16.0, y_offset + pos->y_offset / 64.0 / 16.0);
+		callback.add_outlines(glyph_array[i]->outlines);
 
-		double adv_x  = glyph->get_x_advance() * params.spacing;
-		double adv_y  = glyph->get_y_advance() * params.spacing;
+		double adv_x  = pos->x_advance / 64.0 / 16.0 * params.spacing;
+		double adv_y  = pos->y_advance / 64.0 / 16.0 * params.spacing;
 		callback.add_glyph_advance(adv_x, adv_y);
 		callback.finish_glyph();
 	}
-
-	hb_buffer_destroy(hb_buf);
-        hb_font_destroy(hb_ft_font);
 	
 	return callback.get_result();
 }
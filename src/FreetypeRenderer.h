@@ -29,11 +29,15 @@
 #include <vector>
 #include <ostream>
 
+#include "memory.h"
+
 #include <hb.h>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
 
+template <class Key, class T> class Cache;
+
 class FreetypeRenderer {
 public:
     class Params {
@@ -104,39 +108,19 @@ public:
 
         void detect_properties(FreetypeRenderer::Params &params) const;
 	std::vector<const class Geometry *> render(const FreetypeRenderer::Params &params) const;
+	static void clear_cache();
 private:
 	  const static double scale;
     FT_Outline_Funcs funcs;
-    
-    class GlyphData {
-    public:
-        GlyphData(FT_Glyph glyph, unsigned int idx, hb_glyph_position_t *glyph_pos) : glyph(glyph), idx(idx), glyph_pos(glyph_pos) {}
-        unsigned int get_idx() const { return idx; };
-        FT_Glyph get_glyph() const { return glyph; };
-        double get_x_offset() const { return glyph_pos->x_offset / 64.0 / 16.0; };
-        double get_y_offset() const { return glyph_pos->y_offset / 64.0 / 16.0; };
-        double get_x_advance() const { return glyph_pos->x_advance / 64.0 / 16.0; };
-        double get_y_advance() const { return glyph_pos->y_advance / 64.0 / 16.0; };
-    private:
-        FT_Glyph glyph;
-        unsigned int idx;
-        hb_glyph_position_t *glyph_pos;
-    };
 
-    struct done_glyph : public std::unary_function<const GlyphData *, void> {
-        void operator() (const GlyphData *glyph_data) {
-            FT_Done_Glyph(glyph_data->get_glyph());
-            delete glyph_data;
-        }
-    };
-
-    class GlyphArray : public std::vector<const GlyphData *> {
-    public:
-        virtual ~GlyphArray() {
-            std::for_each(begin(), end(), done_glyph());
-        }
-    };
+    struct ShapedText;
+    struct GlyphOutline;
+    static Cache<std::string, shared_ptr<const ShapedText>> shaping_cache;
+    static Cache<std::string, shared_ptr<const GlyphOutline>> glyph_cache;
 
+    shared_ptr<const ShapedText> shape(class FontFace &font, FT_F26Dot6 char_size, const std::string &font_key, const FreetypeRenderer::Params &params) const;
+    shared_ptr<const GlyphOutline> get_glyph(class FontFace &font, FT_F26Dot6 char_size, const std::string &font_key, FT_UInt glyph_index, unsigned long segments) const;
+    
     bool is_ignored_script(const hb_script_t script) const;
     hb_script_t get_script(const FreetypeRenderer::Params &params, hb_glyph_info_t *glyph_info, unsigned int glyph_count) const;
     hb_direction_t get_direction(const FreetypeRenderer::Params &params, const hb_script_t script) const;
@@ -32,6 +32,32 @@ bool GeometryCache::insert(const std::string &id, const shared_ptr<const Geometr
 	return inserted;
 }
 
+shared_ptr<const Geometry> GeometryCache::getNef(const std::string &id) const
+{
+	cache_entry *entry = this->cache[id];
+	return entry ? entry->nef : shared_ptr<const Geometry>();
+}
+
+/*!
+	Stores the Nef polyhedron converted from the geometry cached as id.
+	The entry is reinserted with the size of both, so the conversion is
+	dropped when the geometry is evicted.
+*/
+bool GeometryCache::insertNef(const std::string &id, const shared_ptr<const Geometry> &N)
+{
+	cache_entry *entry = this->cache[id];
+	if (!entry || !N) return false;
+	size_t cost = (entry->geom ? entry->geom->memsize() : 0) + N->memsize();
+	if (cost > maxSize()) return false;
+	cache_entry *newentry = new cache_entry(*entry);
+	newentry->nef = N;
+	bool inserted = this->cache.insert(id, newentry, cost);
+#ifdef DEBUG
+	PRINTDB("Geometry Cache Nef insert: %s (%d bytes)", id.substr(0, 40) % N->memsize());
+#endif
+	return inserted;
+}
+
 size_t GeometryCache::maxSize() const
 {
 	return this->cache.maxCost();
@@ -14,6 +14,9 @@ public:
 	bool contains(const std::string &id) const { return this->cache.contains(id); }
 	shared_ptr<const class Geometry> get(const std::string &id) const;
 	bool insert(const std::string &id, const shared_ptr<const Geometry> &geom);
+	// Nef polyhedron converted from a cached PolySet, kept together with it
+	shared_ptr<const class Geometry> getNef(const std::string &id) const;
+	bool insertNef(const std::string &id, const shared_ptr<const Geometry> &N);
 	size_t maxSize() const;
 	void setMaxSize(size_t limit);
 	void clear() { cache.clear(); }
@@ -24,6 +27,7 @@ private:
 
 	struct cache_entry {
 		shared_ptr<const class Geometry> geom;
+		shared_ptr<const class Geometry> nef;
 		std::string msg;
 		cache_entry(const shared_ptr<const Geometry> &geom);
 		~cache_entry() { }
@@ -26,6 +26,7 @@
 #include "svg.h"
 #include "calc.h"
 #include "dxfdata.h"
+#include "parallel.h"
 
 #include <algorithm>
 
@@ -60,15 +61,14 @@ shared_ptr<const Geometry> GeometryEvaluator::evaluateGeometry(const AbstractNod
 
 		if (!allownef) {
 			if (shared_ptr<const CGAL_Nef_polyhedron> N = dynamic_pointer_cast<const CGAL_Nef_polyhedron>(this->root)) {
-				PolySet *ps = new PolySet(3);
-				ps->setConvexity(N->getConvexity());
-				this->root.reset(ps);
-				if (!N->isEmpty()) {
-					bool err = CGALUtils::createPolySetFromNefPolyhedron3(*N->p3, *ps);
-					if (err) {
-						PRINT("ERROR: Nef->PolySet failed");
-					}
+				shared_ptr<const PolySet> ps = CGALUtils::getPolySet(*N);
+				if (!ps) {
+					PRINT("ERROR: Nef->PolySet failed");
+					PolySet *empty = new PolySet(3);
+					empty->setConvexity(N->getConvexity());
+					ps.reset(empty);
 				}
+				this->root = ps;
 			}
 		}
 		smartCacheInsert(node, this->root);
@@ -132,6 +132,20 @@ GeometryEvaluator::ResultObject GeometryEvaluator::applyToChildren3D(const Abstr
 		return ResultObject(CGALUtils::applyMinkowski(actualchildren));
 	}
 
+	// Converting to Nef polyhedra can trigger CGAL assertions just like the
+	// operation itself, so they're handled like in CGALUtils::applyOperator()
+	CGAL::Failure_behaviour old_behaviour = CGAL::set_error_behaviour(CGAL::THROW_EXCEPTION);
+	try {
+		for(auto &item : children) item.second = getNefChild(*item.first, item.second);
+	}
+	catch (const CGAL::Failure_exception &e) {
+		CGAL::set_error_behaviour(old_behaviour);
+		std::string opstr = op == OPENSCAD_INTERSECTION ? "intersection" : op == OPENSCAD_DIFFERENCE ? "difference" : op == OPENSCAD_UNION ? "union" : "UNKNOWN";
+		PRINTB("ERROR: CGAL error in CGALUtils::applyBinaryOperator %s: %s", opstr % e.what());
+		return ResultObject(new CGAL_Nef_polyhedron);
+	}
+	CGAL::set_error_behaviour(old_behaviour);
+
 	CGAL_Nef_polyhedron *N = CGALUtils::applyOperator(children, op);
 	// FIXME: Clarify when we can return NULL and what that means
 	if (!N) N = new CGAL_Nef_polyhedron;
@@ -269,6 +283,25 @@ shared_ptr<const Geometry> GeometryEvaluator::smartCacheGet(const AbstractNode &
 	return geom;
 }
 
+/*!
+	Returns the given child geometry as a Nef polyhedron. A PolySet child is
+	only converted the first time; the result is cached with the PolySet so
+	later CGAL operations on the same child can reuse it.
+*/
+shared_ptr<const Geometry> GeometryEvaluator::getNefChild(const AbstractNode &node, const shared_ptr<const Geometry> &geom)
+{
+	const PolySet *ps = dynamic_cast<const PolySet *>(geom.get());
+	if (!ps) return geom;
+
+	const std::string &key = this->tree.getIdString(node);
+	shared_ptr<const Geometry> N = GeometryCache::instance()->getNef(key);
+	if (!N) {
+		N.reset(CGALUtils::createNefPolyhedronFromGeometry(*ps));
+		GeometryCache::instance()->insertNef(key, N);
+	}
+	return N;
+}
+
 /*!
 	Returns a list of 3D Geometry children of the given node.
 	May return empty geometries, but not NULL objects
@@ -576,13 +609,11 @@ Response GeometryEvaluator::visit(State &state, const TransformNode &node)
 							node.matrix(0,0), node.matrix(0,1), node.matrix(0,3),
 							node.matrix(1,0), node.matrix(1,1), node.matrix(1,3),
 							node.matrix(3,0), node.matrix(3,1), node.matrix(3,3);
-						newpoly->transform(mat2);
 						// A 2D transformation may flip the winding order of a polygon.
-						// If that happens with a sanitized polygon, we need to reverse
-						// the winding order for it to be correct.
-						if (newpoly->isSanitized() && mat2.matrix().determinant() <= 0) {
-							geom.reset(ClipperUtils::sanitize(*newpoly));
-						}
+						// Polygon2d::transform() restores it for sanitized polygons,
+						// so no need to sanitize again.
+						newpoly->transform(mat2);
+						geom = newpoly;
 					}
 					else if (geom->getDimension() == 3) {
 						shared_ptr<const PolySet> ps = dynamic_pointer_cast<const PolySet>(geom);
@@ -770,22 +801,25 @@ Response GeometryEvaluator::visit(State &state, const LinearExtrudeNode &node)
 	return ContinueTraversal;
 }
 
-static void fill_ring(std::vector<Vector3d> &ring, const Outline2d &o, double a, bool flip)
+/*!
+	Computes the vertices of all rings of an outline into one array, ring-major:
+	vertex i of ring j ends up at index j*outline_size + i.
+	sin_a/cos_a hold the precomputed angle of each ring.
+*/
+static void fill_rings(std::vector<Vector3d> &rings, const Outline2d &o,
+											 const std::vector<double> &sin_a, const std::vector<double> &cos_a, bool flip)
 {
-	if (flip) {
-		unsigned int l = o.vertices.size()-1;
-		for (unsigned int i=0 ;i<o.vertices.size();i++) {
-			ring[i][0] = o.vertices[l-i][0] * sin(a);
-			ring[i][1] = o.vertices[l-i][0] * cos(a);
-			ring[i][2] = o.vertices[l-i][1];
-		}
-	} else {
-		for (unsigned int i=0 ;i<o.vertices.size();i++) {
-			ring[i][0] = o.vertices[i][0] * sin(a);
-			ring[i][1] = o.vertices[i][0] * cos(a);
-			ring[i][2] = o.vertices[i][1];
-		}
-	}
+	const size_t n = o.vertices.size();
+	rings.resize(sin_a.size() * n);
+	Parallel::for_each_index(0, sin_a.size(), [&](size_t j) {
+			Vector3d *ring = &rings[j * n];
+			for (size_t i = 0; i < n; i++) {
+				const Vector2d &v = o.vertices[flip ? n - 1 - i : i];
+				ring[i][0] = v[0] * sin_a[j];
+				ring[i][1] = v[0] * cos_a[j];
+				ring[i][2] = v[1];
+			}
+		}, std::max<size_t>(1, 4096 / std::max<size_t>(n, 1)));
 }
 
 /*!
@@ -857,29 +891,43 @@ static Geometry *rotatePolygon(const RotateExtrudeNode &node, const Polygon2d &p
 		delete ps_end;
 	}
 
+	// The ring angles are shared by all outlines, so compute the trig once.
+	// For full revolutions the last ring coincides with the first one and is
+	// not stored separately, so the seam shares its vertices.
+	size_t num_rings = (node.angle == 360) ? fragments : fragments + 1;
+	std::vector<double> sin_a(num_rings), cos_a(num_rings);
+	for (size_t j = 0; j < num_rings; j++) {
+		double a;
+		if (node.angle == 360)
+			a = -M_PI/2 + (j*2*M_PI) / fragments; // start on the -X axis, for legacy support
+		else
+			a = M_PI/2 - j*(node.angle*M_PI/180) / fragments; // start on the X axis
+		sin_a[j] = sin(a);
+		cos_a[j] = cos(a);
+	}
+
+	size_t num_quads = 0;
+	for(const auto &o : poly.outlines()) num_quads += o.vertices.size() * fragments;
+	ps->polygons.reserve(ps->polygons.size() + 2 * num_quads);
+
+	std::vector<Vector3d> rings;
 	for(const auto &o : poly.outlines()) {
-		std::vector<Vector3d> rings[2];
-		rings[0].resize(o.vertices.size());
-		rings[1].resize(o.vertices.size());
+		const size_t n = o.vertices.size();
+		fill_rings(rings, o, sin_a, cos_a, flip_faces);
 
-		fill_ring(rings[0], o, (node.angle == 360) ? -M_PI/2 : M_PI/2, flip_faces); // first ring
 		for (int j = 0; j < fragments; j++) {
-			double a;
-			if (node.angle == 360)
-			    a = -M_PI/2 + ((j+1)%fragments*2*M_PI) / fragments; // start on the -X axis, for legacy support
-			else
-				a = M_PI/2 - (j+1)*(node.angle*M_PI/180) / fragments; // start on the X axis
-			fill_ring(rings[(j+1)%2], o, a, flip_faces);
-
-			for (size_t i=0;i<o.vertices.size();i++) {
+			const Vector3d *ring0 = &rings[j * n];
+			const Vector3d *ring1 = &rings[((j+1) % num_rings) * n];
+			for (size_t i=0;i<n;i++) {
+				size_t i1 = (i+1) % n;
 				ps->append_poly();
-				ps->insert_vertex(rings[j%2][i]);
-				ps->insert_vertex(rings[(j+1)%2][(i+1)%o.vertices.size()]);
-				ps->insert_vertex(rings[j%2][(i+1)%o.vertices.size()]);
+				ps->append_vertex(ring0[i1]);
+				ps->append_vertex(ring1[i1]);
+				ps->append_vertex(ring0[i]);
 				ps->append_poly();
-				ps->insert_vertex(rings[j%2][i]);
-				ps->insert_vertex(rings[(j+1)%2][i]);
-				ps->insert_vertex(rings[(j+1)%2][(i+1)%o.vertices.size()]);
+				ps->append_vertex(ring1[i1]);
+				ps->append_vertex(ring1[i]);
+				ps->append_vertex(ring0[i]);
 			}
 		}
 	}
@@ -956,63 +1004,26 @@ Response GeometryEvaluator::visit(State &state, const ProjectionNode &node)
 					// FIXME: Don't use deep access to modinst members
 					if (chnode->modinst->isBackground()) continue;
 
-					const Polygon2d *poly = NULL;
-
-// CGAL version of Geometry projection
-// Causes crashes in createNefPolyhedronFromGeometry() for this model:
-// projection(cut=false) {
-//    cube(10);
-//    difference() {
-//      sphere(10);
-//      cylinder(h=30, r=5, center=true);
-//    }
-// }
-#if 0
-					shared_ptr<const PolySet> chPS = dynamic_pointer_cast<const PolySet>(chgeom);
-					const PolySet *ps2d = NULL;
-					shared_ptr<const CGAL_Nef_polyhedron> chN = dynamic_pointer_cast<const CGAL_Nef_polyhedron>(chgeom);
-					if (chN) chPS.reset(chN->convertToPolyset());
-					if (chPS) ps2d = PolysetUtils::flatten(*chPS);
-					if (ps2d) {
-						CGAL_Nef_polyhedron *N2d = CGALUtils::createNefPolyhedronFromGeometry(*ps2d);
-						poly = N2d->convertToPolygon2d();
-					}
-#endif
-
-// Clipper version of Geometry projection
-// Clipper doesn't handle meshes very well.
-// It's better in V6 but not quite there. FIXME: stand-alone example.
-#if 1
-					// project chgeom -> polygon2d
+					// Project chgeom with Clipper. A CGAL version crashed in
+					// createNefPolyhedronFromGeometry() for some models.
+					// Clipper doesn't handle meshes very well.
+					// It's better in V6 but not quite there. FIXME: stand-alone example.
 					shared_ptr<const PolySet> chPS = dynamic_pointer_cast<const PolySet>(chgeom);
 					if (!chPS) {
 						shared_ptr<const CGAL_Nef_polyhedron> chN = dynamic_pointer_cast<const CGAL_Nef_polyhedron>(chgeom);
 						if (chN) {
-							PolySet *ps = new PolySet(3);
-							bool err = CGALUtils::createPolySetFromNefPolyhedron3(*chN->p3, *ps);
-							if (err) {
-								PRINT("ERROR: Nef->PolySet failed");
-							}
-							else {
-								chPS.reset(ps);
-							}
+							chPS = CGALUtils::getPolySet(*chN);
+							if (!chPS) PRINT("ERROR: Nef->PolySet failed");
 						}
 					}
-					if (chPS) poly = PolysetUtils::project(*chPS);
-#endif
-
-					if (poly) {
-						ClipperLib::Paths result = ClipperUtils::fromPolygon2d(*poly);
+					if (chPS) {
+						// Faces are culled and unioned in spatially sorted chunks in parallel.
 						// Using NonZero ensures that we don't create holes from polygons sharing
 						// edges since we're unioning a mesh
-						result = ClipperUtils::process(result, 
-																					 ClipperLib::ctUnion, 
-																					 ClipperLib::pftNonZero);
+						ClipperLib::Paths result = ClipperUtils::unionPaths(ClipperUtils::fromPolySetProjection(*chPS));
 						// Add correctly winded polygons to the main clipper
 						sumclipper.AddPaths(result, ClipperLib::ptSubject, true);
 					}
-
-					delete poly;
 				}
 				ClipperLib::PolyTree sumresult;
 				// This is key - without StrictlySimple, we tend to get self-intersecting results
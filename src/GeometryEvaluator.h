@@ -60,6 +60,7 @@ private:
 	bool isSmartCached(const AbstractNode &node);
 	std::vector<const class Polygon2d *> collectChildren2D(const AbstractNode &node);
 	Geometry::Geometries collectChildren3D(const AbstractNode &node);
+	shared_ptr<const Geometry> getNefChild(const AbstractNode &node, const shared_ptr<const Geometry> &geom);
 	Polygon2d *applyMinkowski2D(const AbstractNode &node);
 	Polygon2d *applyHull2D(const AbstractNode &node);
 	Geometry *applyHull3D(const AbstractNode &node);
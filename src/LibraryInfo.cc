@@ -7,6 +7,7 @@
 
 #include "version_check.h"
 #include "PlatformUtils.h"
+#include "FontCache.h"
 #include "openscad.h"
 #define STRINGIFY(x) #x
 #define TOSTRING(x) STRINGIFY(x)
@@ -114,6 +115,9 @@ std::string LibraryInfo::info()
 		s << "  " << *it << "\n";
 	}
 
+	// The font path is only known once fontconfig is loaded
+	FontCache::instance()->init();
+
 	s << "\nOPENSCAD_FONT_PATH: " << (env_font_path == NULL ? "<not set>" : env_font_path)
 	  << "\nOpenSCAD font path:\n";
 	
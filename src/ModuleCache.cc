@@ -1,7 +1,10 @@
 #include "ModuleCache.h"
+#include "ASTCache.h"
 #include "module.h"
 #include "printutils.h"
 #include "openscad.h"
+#include "FileWatcher.h"
+#include "parallel.h"
 
 #include "boosty.h"
 #include <boost/format.hpp>
@@ -20,6 +23,107 @@
 
 ModuleCache *ModuleCache::inst = NULL;
 
+/*!
+	Reads the given library file and parses it, or loads it from the AST cache.
+	Sets opened to false if the file couldn't be read.
+
+	Doesn't touch the module cache, so this can run on worker threads.
+*/
+static FileModule *compile_file(const std::string &filename, bool &opened)
+{
+	FileWatcher::instance()->watch(filename);
+	std::stringstream textbuf;
+	{
+		std::ifstream ifs(filename.c_str());
+		if (!ifs.is_open()) {
+			PRINTB("WARNING: Can't open library file '%s'\n", filename);
+			opened = false;
+			return NULL;
+		}
+		textbuf << ifs.rdbuf();
+	}
+	textbuf << "\n" << commandline_commands;
+	opened = true;
+
+	std::string text = textbuf.str();
+	FileModule *lib_mod = ASTCache::instance()->load(filename, text);
+	if (lib_mod) {
+		PRINTDB("  loaded cached module: %p", lib_mod);
+		return lib_mod;
+	}
+
+	// Parser messages are collected to tell whether the parse was clean
+	PrintCapture output;
+	{
+		PrintCapture::Scope capture(output);
+		lib_mod = dynamic_cast<FileModule*>(parse(text.c_str(), fs::path(filename), false));
+	}
+	PRINTDB("  compiled module: %p", lib_mod);
+	// Only cache clean parses, since loading doesn't repeat warnings
+	if (lib_mod && output.empty()) {
+		ASTCache::instance()->store(filename, text, *lib_mod);
+	}
+	output.replay();
+	return lib_mod;
+}
+
+/*!
+	Returns true if the given file needs to be (re)compiled by evaluate().
+	cache_id is set to the file's current cache ID.
+*/
+bool ModuleCache::needsCompile(const std::string &filename, std::string &cache_id)
+{
+	auto it = this->entries.find(filename);
+	if (it != this->entries.end() &&
+			!FileWatcher::instance()->changedSince(filename, it->second.generation)) return false;
+	FileModule *lib_mod = (it != this->entries.end()) ? it->second.module : NULL;
+	if (lib_mod && lib_mod->isHandlingDependencies()) return false;
+
+	struct stat st;
+	memset(&st, 0, sizeof(struct stat));
+	if (stat(filename.c_str(), &st) != 0) return false;
+	cache_id = str(boost::format("%x.%x") % st.st_mtime % st.st_size);
+
+	if (it == this->entries.end() || it->second.cache_id != cache_id) return true;
+	return lib_mod && lib_mod->includesChanged();
+}
+
+/*!
+	Compiles those of the given (absolute) files which evaluate() would compile,
+	using worker threads. The resulting modules are picked up by evaluate(),
+	which still handles the cache entries and dependencies in order.
+*/
+void ModuleCache::prepare(const std::vector<std::string> &filenames)
+{
+	std::vector<std::string> todo;
+	std::vector<std::string> cache_ids;
+	for (const auto &filename : filenames) {
+		std::string cache_id;
+		if (needsCompile(filename, cache_id) && !this->prepared.count(filename)) {
+			todo.push_back(filename);
+			cache_ids.push_back(cache_id);
+		}
+	}
+	// A single file is cheaper to compile inline from evaluate()
+	if (todo.size() < 2) return;
+
+	// Make sure the cache exists before the workers use it
+	ASTCache::instance();
+
+	// Messages are captured per file and printed by evaluate() as it picks up
+	// the modules, so they come out in the same order as without prepare()
+	std::vector<prepared_module> modules(todo.size());
+	Parallel::for_each_index(0, todo.size(), [&](size_t i) {
+			PrintCapture::Scope capture(modules[i].output);
+			modules[i].module = compile_file(todo[i], modules[i].opened);
+		});
+
+	for (size_t i = 0; i < todo.size(); i++) {
+		modules[i].cache_id = cache_ids[i];
+		this->prepared[todo[i]] = std::move(modules[i]);
+	}
+}
+
 /*!
 	Reevaluate the given file and all it's dependencies and recompile anything
 	needing reevaluation. Updates the cache if necessary.
@@ -43,6 +147,17 @@ bool ModuleCache::evaluate(const std::string &filename, FileModule *&module)
 	// during evaluation, that would be really bad.
 	if (lib_mod && lib_mod->isHandlingDependencies()) return false;
 
+	// Files the watcher reports as unchanged don't need to be looked at;
+	// their dependencies are checked below
+	FileWatcher *watcher = FileWatcher::instance();
+	unsigned long generation = watcher->update();
+	if (found && !watcher->changedSince(filename, this->entries[filename].generation)) {
+		module = lib_mod;
+		std::unordered_set<std::string> visited;
+		registerDependencies(filename, visited);
+		return lib_mod ? lib_mod->handleDependencies() : false;
+	}
+
 	// Create cache ID
 	struct stat st;
 	memset(&st, 0, sizeof(struct stat));
@@ -59,6 +174,7 @@ bool ModuleCache::evaluate(const std::string &filename, FileModule *&module)
 	if (!found) {
 		entry.module = NULL;
 		entry.cache_id = cache_id;
+		entry.generation = 0;
 	}
   
 	bool shouldCompile = true;
@@ -66,6 +182,8 @@ bool ModuleCache::evaluate(const std::string &filename, FileModule *&module)
 		// Files should only be recompiled if the cache ID changed
 		if (entry.cache_id == cache_id) {
 			shouldCompile = false;
+			std::unordered_set<std::string> visited;
+			registerDependencies(filename, visited);
 			// Recompile if includes changed
 			if (lib_mod && lib_mod->includesChanged()) {
 				lib_mod = NULL;
@@ -90,33 +208,31 @@ bool ModuleCache::evaluate(const std::string &filename, FileModule *&module)
 		}
 #endif
 
-		std::stringstream textbuf;
-		{
-			std::ifstream ifs(filename.c_str());
-			if (!ifs.is_open()) {
-				PRINTB("WARNING: Can't open library file '%s'\n", filename);
-				return false;
+		FileModule *oldmodule = lib_mod;
+		bool opened;
+		auto prep = this->prepared.find(filename);
+		if (prep != this->prepared.end() && prep->second.cache_id == cache_id) {
+			lib_mod = prep->second.module;
+			opened = prep->second.opened;
+			prep->second.output.replay();
+			this->prepared.erase(prep);
+		}
+		else {
+			if (prep != this->prepared.end()) {
+				delete prep->second.module;
+				this->prepared.erase(prep);
 			}
-			textbuf << ifs.rdbuf();
+			lib_mod = compile_file(filename, opened);
 		}
-		textbuf << "\n" << commandline_commands;
-		
-		print_messages_push();
-		
-		FileModule *oldmodule = lib_mod;
-		
-        fs::path pathname = fs::path(filename);
-		lib_mod = dynamic_cast<FileModule*>(parse(textbuf.str().c_str(), pathname, false));
-		PRINTDB("  compiled module: %p", lib_mod);
+		if (!opened) return false;
 		
 		// We defer deletion so we can ensure that the new module won't
 		// have the same address as the old
 		if (oldmodule) delete oldmodule;
 		entry.module = lib_mod;
 		entry.cache_id = cache_id;
-		
-		print_messages_pop();
 	}
+	entry.generation = generation;
 	
 	module = lib_mod;
 	bool depschanged = lib_mod ? lib_mod->handleDependencies() : false;
@@ -124,9 +240,24 @@ bool ModuleCache::evaluate(const std::string &filename, FileModule *&module)
 	return shouldCompile || depschanged;
 }
 
+/*!
+	Registers the dependencies of a cached module, and of the cached
+	libraries it uses, which handleDependencies() may not look at again.
+*/
+void ModuleCache::registerDependencies(const std::string &filename, std::unordered_set<std::string> &visited)
+{
+	if (!visited.insert(filename).second) return;
+	FileModule *lib_mod = lookup(filename);
+	if (!lib_mod) return;
+	lib_mod->registerDependencies(filename);
+	for (const auto &lib : lib_mod->usedlibs) registerDependencies(lib, visited);
+}
+
 void ModuleCache::clear()
 {
 	this->entries.clear();
+	for (const auto &prep : this->prepared) delete prep.second.module;
+	this->prepared.clear();
 }
 
 FileModule *ModuleCache::lookup(const std::string &filename)
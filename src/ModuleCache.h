@@ -2,6 +2,9 @@
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "printutils.h"
 
 /*!
 	Caches FileModules based on their filenames
@@ -11,6 +14,7 @@ class ModuleCache
 public:
 	static ModuleCache *instance() { if (!inst) inst = new ModuleCache; return inst; }
 	bool evaluate(const std::string &filename, class FileModule *&module);
+	void prepare(const std::vector<std::string> &filenames);
 	class FileModule *lookup(const std::string &filename);
 	bool isCached(const std::string &filename);
 	size_t size() { return this->entries.size(); }
@@ -20,11 +24,24 @@ private:
 	ModuleCache() {}
 	~ModuleCache() {}
 
+	bool needsCompile(const std::string &filename, std::string &cache_id);
+	void registerDependencies(const std::string &filename, std::unordered_set<std::string> &visited);
+
 	static ModuleCache *inst;
 
 	struct cache_entry {
 		class FileModule *module;
 		std::string cache_id;
+		unsigned long generation; // FileWatcher generation of the last check
 	};
 	std::unordered_map<std::string, cache_entry> entries;
+
+	// Modules compiled ahead of evaluate() by prepare()
+	struct prepared_module {
+		class FileModule *module;
+		std::string cache_id;
+		bool opened;
+		PrintCapture output; // Messages from compiling, printed by evaluate()
+	};
+	std::unordered_map<std::string, prepared_module> prepared;
 };
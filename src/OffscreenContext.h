@@ -11,6 +11,7 @@
 
 struct OffscreenContext *create_offscreen_context(int w, int h);
 bool teardown_offscreen_context(OffscreenContext *ctx);
+bool resize_offscreen_context(OffscreenContext *ctx, int w, int h);
 bool save_framebuffer(OffscreenContext *ctx, const char * filename);
 bool save_framebuffer(OffscreenContext *ctx, std::ostream &output);
 std::string offscreen_context_getinfo(OffscreenContext *ctx);
@@ -9,6 +9,17 @@ void bind_offscreen_context(OffscreenContext *ctx)
 	if (ctx) fbo_bind(ctx->fbo);
 }
 
+/*!
+  Resize the framebuffer, so the context can be reused for images of another size.
+ */
+bool resize_offscreen_context(OffscreenContext *ctx, int w, int h)
+{
+	if (!ctx || !fbo_resize(ctx->fbo, w, h)) return false;
+	ctx->width = w;
+	ctx->height = h;
+	return true;
+}
+
 /*
    Capture framebuffer from OpenGL and write it to the given filename as PNG.
  */
@@ -45,6 +45,12 @@ bool teardown_offscreen_context(OffscreenContext *ctx)
   return true;
 }
 
+bool resize_offscreen_context(OffscreenContext *ctx, int w, int h)
+{
+  offscreen_context_init( *ctx, w, h );
+  return true;
+}
+
 bool save_framebuffer(OffscreenContext *ctx, char const * filename)
 {
         std::ofstream fstream(filename,std::ios::out|std::ios::binary);
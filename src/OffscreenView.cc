@@ -20,6 +20,13 @@ OffscreenView::~OffscreenView()
   teardown_offscreen_context(this->ctx);
 }
 
+bool OffscreenView::resize(int width, int height)
+{
+  if (!resize_offscreen_context(this->ctx, width, height)) return false;
+  GLView::resizeGL(width, height);
+  return true;
+}
+
 #ifdef ENABLE_OPENCSG
 void OffscreenView::display_opencsg_warning()
 {
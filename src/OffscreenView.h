@@ -14,6 +14,7 @@ public:
 	OffscreenView(int width, int height);
 	~OffscreenView();
 	bool save(std::ostream &output);
+	bool resize(int width, int height);
 	OffscreenContext *ctx;
 
 	// overrides
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdio.h>
+#include <stack>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+namespace fs = boost::filesystem;
+
+class FileModule;
+class LocalScope;
+
+/*!
+	State of a single parse() call, shared by the lexer and the parser.
+
+	Every parse owns its context and its flex scanner, so independent files
+	can be parsed concurrently from different threads.
+*/
+struct ParserContext
+{
+	ParserContext(const char *text, const fs::path &sourcefile)
+		: scanner(NULL), input_buffer(text), error_pos(-1), sourcefile(sourcefile),
+			rootmodule(NULL), column(1) {}
+	~ParserContext() {
+		for (auto f : openfiles) fclose(f);
+	}
+
+	// Filename of the source file currently being lexed.
+	fs::path currentSourceFile() const {
+		return filename_stack.empty() ? sourcefile : filename_stack.back();
+	}
+
+	void *scanner;
+	const char *input_buffer;
+	int error_pos;
+	fs::path sourcefile;
+
+	FileModule *rootmodule;
+	std::stack<LocalScope *> scope_stack;
+
+	// Lexer state for include<>
+	std::vector<fs::path> filename_stack;
+	std::vector<FILE*> openfiles;
+	std::vector<std::string> openfilenames;
+	std::string filename;
+	std::string filepath;
+
+	std::string stringcontents;
+	int column;
+};
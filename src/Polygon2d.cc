@@ -1,6 +1,8 @@
 #include "Polygon2d.h"
 #include "printutils.h"
 
+#include <algorithm>
+
 /*!
 	Class for holding 2D geometry.
 	
@@ -55,17 +57,25 @@ bool Polygon2d::isEmpty() const
 	return this->theoutlines.empty();
 }
 
+/*!
+	Transforms all outlines. A mirroring transformation flips the winding
+	order; for sanitized polygons, the outlines are reversed to restore it.
+	This keeps the polygon sanitized without another Clipper pass.
+*/
 void Polygon2d::transform(const Transform2d &mat)
 {
-	if (mat.matrix().determinant() == 0) {
+	double det = mat.matrix().determinant();
+	if (det == 0) {
 		PRINT("WARNING: Scaling a 2D object with 0 - removing object");
 		this->theoutlines.clear();
 		return;
 	}
+	bool reverse = this->sanitized && det < 0;
 	for(auto &o : this->theoutlines) {
 		for(auto &v : o.vertices) {
 			v = mat * v;
 		}
+		if (reverse) std::reverse(o.vertices.begin(), o.vertices.end());
 	}
 }
 
@@ -0,0 +1,608 @@
+#include "SoftwareRenderer.h"
+#include "polyset.h"
+#include "polyset-utils.h"
+#include "Polygon2d.h"
+#include "csgnode.h"
+#include "imageutils.h"
+#include "parallel.h"
+#include "printutils.h"
+#ifdef ENABLE_CGAL
+#include "CGAL_Nef_polyhedron.h"
+#include "cgalutils.h"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <limits>
+#include <map>
+#include <set>
+#include <cmath>
+
+namespace {
+	// Triangles are clipped against the near and far planes, and against a
+	// guard band of this many times the viewport to keep screen coordinates small
+	const double GUARD_BAND = 4.0;
+
+	Eigen::Matrix4d perspective(double fovy, double aspect, double znear, double zfar)
+	{
+		double f = 1.0 / tan(fovy / 2 * M_PI / 180);
+		Eigen::Matrix4d m = Eigen::Matrix4d::Zero();
+		m(0,0) = f / aspect;
+		m(1,1) = f;
+		m(2,2) = (zfar + znear) / (znear - zfar);
+		m(2,3) = 2 * zfar * znear / (znear - zfar);
+		m(3,2) = -1;
+		return m;
+	}
+
+	Eigen::Matrix4d ortho(double left, double right, double bottom, double top, double znear, double zfar)
+	{
+		Eigen::Matrix4d m = Eigen::Matrix4d::Identity();
+		m(0,0) = 2 / (right - left);
+		m(1,1) = 2 / (top - bottom);
+		m(2,2) = -2 / (zfar - znear);
+		m(0,3) = -(right + left) / (right - left);
+		m(1,3) = -(top + bottom) / (top - bottom);
+		m(2,3) = -(zfar + znear) / (zfar - znear);
+		return m;
+	}
+
+	Eigen::Matrix4d lookAt(const Vector3d &eye, const Vector3d &center, const Vector3d &up)
+	{
+		Vector3d f = (center - eye).normalized();
+		Vector3d s = f.cross(up).normalized();
+		Vector3d u = s.cross(f);
+		Eigen::Matrix4d m = Eigen::Matrix4d::Identity();
+		m.block<1,3>(0,0) = s.transpose();
+		m.block<1,3>(1,0) = u.transpose();
+		m.block<1,3>(2,0) = -f.transpose();
+		m.block<3,1>(0,3) = -m.block<3,3>(0,0) * eye;
+		return m;
+	}
+
+	Eigen::Matrix4d rotation(double angle, const Vector3d &axis)
+	{
+		Eigen::Matrix4d m = Eigen::Matrix4d::Identity();
+		m.block<3,3>(0,0) = Eigen::AngleAxisd(angle * M_PI / 180, axis).toRotationMatrix();
+		return m;
+	}
+
+	// Signed distances of a clip space point to the clipping planes
+	double planeDistance(const Eigen::Vector4d &p, int plane)
+	{
+		switch (plane) {
+		case 0: return p[3] + p[2];
+		case 1: return p[3] - p[2];
+		case 2: return GUARD_BAND * p[3] + p[0];
+		case 3: return GUARD_BAND * p[3] - p[0];
+		case 4: return GUARD_BAND * p[3] + p[1];
+		default: return GUARD_BAND * p[3] - p[1];
+		}
+	}
+	const int NUM_PLANES = 6;
+
+	bool lexicographicLess(const Eigen::Vector4d &a, const Eigen::Vector4d &b)
+	{
+		return std::lexicographical_compare(a.data(), a.data() + 4, b.data(), b.data() + 4);
+	}
+
+	// Sutherland-Hodgman clipping. Edge intersections are computed from the
+	// endpoints in a fixed order, so triangles sharing an edge get the same point.
+	void clipPolygon(std::vector<Eigen::Vector4d> &poly, std::vector<Eigen::Vector4d> &tmp)
+	{
+		for (int plane = 0; plane < NUM_PLANES && !poly.empty(); plane++) {
+			tmp.clear();
+			for (size_t i = 0; i < poly.size(); i++) {
+				const Eigen::Vector4d &a = poly[i];
+				const Eigen::Vector4d &b = poly[(i + 1) % poly.size()];
+				double da = planeDistance(a, plane), db = planeDistance(b, plane);
+				if (da >= 0) tmp.push_back(a);
+				if ((da >= 0) != (db >= 0)) {
+					if (lexicographicLess(b, a)) tmp.push_back(b + (db / (db - da)) * (a - b));
+					else tmp.push_back(a + (da / (da - db)) * (b - a));
+				}
+			}
+			poly.swap(tmp);
+		}
+	}
+
+	int64_t edgeFunction(int64_t ax, int64_t ay, int64_t bx, int64_t by, int64_t px, int64_t py)
+	{
+		return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+	}
+
+	// Pixels exactly on an edge belong to only one of the two triangles sharing it
+	bool ownsEdge(int64_t ax, int64_t ay, int64_t bx, int64_t by)
+	{
+		return by > ay || (by == ay && bx < ax);
+	}
+
+	// Like fixed-function GL, the lit color is clamped, not the shade, so
+	// brightly lit faces saturate towards full intensity
+	Color4f shaded(const Color4f &col, float shade)
+	{
+		return Color4f(std::min(1.0f, col[0] * shade), std::min(1.0f, col[1] * shade),
+									 std::min(1.0f, col[2] * shade), col[3]);
+	}
+
+	// Blends col over dst with col's alpha, like glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)
+	void blend(Color4f &dst, const Color4f &col)
+	{
+		if (col[3] >= 1) dst.head<3>() = col.head<3>();
+		else dst.head<3>() = col.head<3>() * col[3] + dst.head<3>() * (1 - col[3]);
+	}
+
+	Color4f leafColor(const Color4f &leaf, const Color4f &base)
+	{
+		return Color4f(leaf[0] >= 0 ? leaf[0] : base[0],
+									 leaf[1] >= 0 ? leaf[1] : base[1],
+									 leaf[2] >= 0 ? leaf[2] : base[2],
+									 leaf[3] >= 0 ? leaf[3] : base[3]);
+	}
+}
+
+SoftwareRenderer::SoftwareRenderer(unsigned int width, unsigned int height)
+	: width(std::max(width, 1u)), height(std::max(height, 1u)), colorscheme(&ColorMap::inst()->defaultColorScheme())
+{
+}
+
+void SoftwareRenderer::setColorScheme(const ColorScheme &cs)
+{
+	this->colorscheme = &cs;
+}
+
+void SoftwareRenderer::setColorScheme(const std::string &cs)
+{
+	const ColorScheme *colorscheme = ColorMap::inst()->findColorScheme(cs);
+	if (colorscheme) setColorScheme(*colorscheme);
+}
+
+// Same transformations as GLView::setupCamera()
+void SoftwareRenderer::setupMatrices()
+{
+	double aspect = double(this->width) / this->height;
+	this->projection.setIdentity();
+	this->modelview.setIdentity();
+	switch (this->cam.type) {
+	case Camera::GIMBAL:
+	case Camera::VECTOR: {
+		double dist = this->cam.type == Camera::GIMBAL ? this->cam.zoomValue() : (this->cam.center - this->cam.eye).norm();
+		if (this->cam.projection == Camera::PERSPECTIVE) {
+			this->projection = perspective(this->cam.fov, aspect, 0.1 * dist, 100 * dist);
+		}
+		else {
+			double h = dist * tan(this->cam.fov / 2 * M_PI / 180);
+			this->projection = ortho(-h * aspect, h * aspect, -h, h, -100 * dist, 100 * dist);
+		}
+		if (this->cam.type == Camera::GIMBAL) {
+			this->projection = this->projection * lookAt(Vector3d(0, -dist, 0), Vector3d(0, 0, 0), Vector3d(0, 0, 1));
+			this->modelview = rotation(this->cam.object_rot.x(), Vector3d::UnitX()) *
+				rotation(this->cam.object_rot.y(), Vector3d::UnitY()) *
+				rotation(this->cam.object_rot.z(), Vector3d::UnitZ());
+			this->modelview.block<3,1>(0,3) = this->modelview.block<3,3>(0,0) * this->cam.object_trans;
+		}
+		else {
+			Vector3d up(0, 0, 1);
+			if ((this->cam.eye - this->cam.center).cross(up).norm() < 0.001) up << 0, 1, 0;
+			this->modelview = lookAt(this->cam.eye, this->cam.center, up);
+		}
+		break;
+	}
+	default:
+		break;
+	}
+	// The GL views use a directional light in eye space (plus its opposite)
+	this->light = Vector3d(-1, -1, 1).normalized();
+
+	Color4f bgcol = ColorMap::getColor(*this->colorscheme, BACKGROUND_COLOR);
+	this->color.assign(size_t(this->width) * this->height, Color4f(bgcol[0], bgcol[1], bgcol[2], 1.0f));
+	this->depth.assign(size_t(this->width) * this->height, std::numeric_limits<float>::max());
+}
+
+void SoftwareRenderer::addTriangle(Object &obj, const Vector3d &p0, const Vector3d &p1, const Vector3d &p2) const
+{
+	Vector3d normal = (p1 - p0).cross(p2 - p0);
+	if (normal.isZero()) return;
+	float shade = 1.0f;
+	if (obj.lighting) {
+		Vector3d n = (this->modelview.block<3,3>(0,0) * normal).normalized();
+		// Ambient 0.2, plus whichever of the two opposite lights faces n
+		shade = 0.2 + std::fabs(n.dot(this->light));
+	}
+
+	Eigen::Matrix4d mvp = this->projection * this->modelview;
+	std::vector<Eigen::Vector4d> poly, tmp;
+	for (const Vector3d *p : {&p0, &p1, &p2}) poly.push_back(mvp * Eigen::Vector4d((*p)[0], (*p)[1], (*p)[2], 1.0));
+	bool inside = true;
+	for (int plane = 0; plane < NUM_PLANES && inside; plane++) {
+		for (const auto &p : poly) if (planeDistance(p, plane) < 0) inside = false;
+	}
+	if (!inside) clipPolygon(poly, tmp);
+	if (poly.size() < 3) return;
+
+	const int64_t S = 1 << SUBPIXEL_BITS;
+	std::vector<int64_t> xs, ys;
+	std::vector<double> zs;
+	for (const auto &p : poly) {
+		xs.push_back(llround((p[0] / p[3] + 1) / 2 * this->width * S));
+		ys.push_back(llround((1 - p[1] / p[3]) / 2 * this->height * S));
+		zs.push_back(p[2] / p[3]);
+	}
+
+	for (size_t i = 1; i + 1 < poly.size(); i++) {
+		size_t v[3] = {0, i, i + 1};
+		int64_t area = edgeFunction(xs[v[0]], ys[v[0]], xs[v[1]], ys[v[1]], xs[v[2]], ys[v[2]]);
+		if (area == 0) continue;
+		ScreenTriangle t;
+		// Image rows go downwards, so counter-clockwise front faces have negative area
+		t.front = area < 0;
+		if (t.front) std::swap(v[1], v[2]);
+		int64_t minx = std::numeric_limits<int64_t>::max(), maxx = std::numeric_limits<int64_t>::min();
+		int64_t miny = minx, maxy = maxx;
+		for (int j = 0; j < 3; j++) {
+			t.x[j] = xs[v[j]];
+			t.y[j] = ys[v[j]];
+			t.z[j] = zs[v[j]];
+			minx = std::min(minx, t.x[j]);
+			maxx = std::max(maxx, t.x[j]);
+			miny = std::min(miny, t.y[j]);
+			maxy = std::max(maxy, t.y[j]);
+		}
+		// Pixels whose centers lie within the bounding box
+		t.xmin = std::max(0, int(std::ceil(double(minx - S / 2) / S)));
+		t.xmax = std::min(int(this->width) - 1, int(std::floor(double(maxx - S / 2) / S)));
+		t.ymin = std::max(0, int(std::ceil(double(miny - S / 2) / S)));
+		t.ymax = std::min(int(this->height) - 1, int(std::floor(double(maxy - S / 2) / S)));
+		if (t.xmin > t.xmax || t.ymin > t.ymax) continue;
+		t.shade = shade;
+		obj.triangles.push_back(t);
+	}
+}
+
+void SoftwareRenderer::addPolySet(Object &obj, const PolySet &ps, const Transform3d &m, double thickness) const
+{
+	bool mirrored = m.matrix().determinant() < 0;
+	if (ps.getDimension() == 3) {
+		PolySet ps_tri(3);
+		PolysetUtils::tessellate_faces(ps, ps_tri);
+		for (const auto &p : ps_tri.polygons) {
+			if (p.size() != 3) continue;
+			if (mirrored) addTriangle(obj, m * p[0], m * p[2], m * p[1]);
+			else addTriangle(obj, m * p[0], m * p[1], m * p[2]);
+		}
+		return;
+	}
+
+	// 2D objects are drawn flat, or as a slab of the given thickness like
+	// PolySet::render_surface() does in previews. The sides are built from
+	// the edges not shared by two triangles.
+	std::vector<std::array<Vector2d, 3>> triangles;
+	for (const auto &p : ps.polygons) {
+		for (size_t i = 1; i + 1 < p.size(); i++) {
+			std::array<Vector2d, 3> t = {{p[0].head<2>(), p[i].head<2>(), p[i + 1].head<2>()}};
+			double area = (t[1] - t[0]).x() * (t[2] - t[0]).y() - (t[1] - t[0]).y() * (t[2] - t[0]).x();
+			if (area < 0) std::swap(t[1], t[2]);
+			triangles.push_back(t);
+		}
+	}
+	auto point = [&](const Vector2d &v, double z) -> Vector3d { return m * Vector3d(v[0], v[1], z); };
+	// In the order PolySet::render_surface() draws them: bottom, top, sides,
+	// which matters for transparent objects
+	double z = thickness / 2;
+	if (thickness != 0) {
+		for (const auto &t : triangles) {
+			if (mirrored) addTriangle(obj, point(t[0], -z), point(t[1], -z), point(t[2], -z));
+			else addTriangle(obj, point(t[0], -z), point(t[2], -z), point(t[1], -z));
+		}
+	}
+	for (const auto &t : triangles) {
+		if (thickness == 0 || !mirrored) addTriangle(obj, point(t[0], z), point(t[1], z), point(t[2], z));
+		else addTriangle(obj, point(t[0], z), point(t[2], z), point(t[1], z));
+	}
+	if (thickness == 0) return;
+
+	typedef std::pair<std::pair<double, double>, std::pair<double, double>> edge_t;
+	std::set<edge_t> edges;
+	for (const auto &t : triangles) {
+		for (int i = 0; i < 3; i++) {
+			const Vector2d &a = t[i], &b = t[(i + 1) % 3];
+			edges.insert(edge_t(std::make_pair(a[0], a[1]), std::make_pair(b[0], b[1])));
+		}
+	}
+	for (const auto &e : edges) {
+		if (edges.count(edge_t(e.second, e.first))) continue;
+		Vector2d a(e.first.first, e.first.second), b(e.second.first, e.second.second);
+		if (mirrored) {
+			addTriangle(obj, point(a, -z), point(b, z), point(b, -z));
+			addTriangle(obj, point(a, -z), point(a, z), point(b, z));
+		}
+		else {
+			addTriangle(obj, point(a, -z), point(b, -z), point(b, z));
+			addTriangle(obj, point(a, -z), point(b, z), point(a, z));
+		}
+	}
+}
+
+void SoftwareRenderer::addGeometry(Object &obj, const shared_ptr<const Geometry> &geom, const Transform3d &m, double thickness) const
+{
+	if (!geom) return;
+	if (shared_ptr<const PolySet> ps = dynamic_pointer_cast<const PolySet>(geom)) {
+		addPolySet(obj, *ps, m, thickness);
+	}
+	else if (shared_ptr<const Polygon2d> poly = dynamic_pointer_cast<const Polygon2d>(geom)) {
+		shared_ptr<const PolySet> ps(poly->tessellate());
+		addPolySet(obj, *ps, m, thickness);
+	}
+#ifdef ENABLE_CGAL
+	else if (shared_ptr<const CGAL_Nef_polyhedron> N = dynamic_pointer_cast<const CGAL_Nef_polyhedron>(geom)) {
+		if (!N->isEmpty()) {
+			shared_ptr<const PolySet> ps = CGALUtils::getPolySet(*N);
+			if (ps) addPolySet(obj, *ps, m, thickness);
+		}
+	}
+#endif
+}
+
+// Calls body(x, y, z) for each pixel in rows [ybegin, yend) whose center is covered by t
+template <typename Body>
+void SoftwareRenderer::rasterize(const ScreenTriangle &t, int ybegin, int yend, Body body) const
+{
+	const int64_t S = 1 << SUBPIXEL_BITS;
+	int y0 = std::max(t.ymin, ybegin), y1 = std::min(t.ymax + 1, yend);
+	if (y0 >= y1) return;
+
+	double area = double(edgeFunction(t.x[0], t.y[0], t.x[1], t.y[1], t.x[2], t.y[2]));
+	int64_t bias[3], step[3];
+	for (int i = 0; i < 3; i++) {
+		int a = (i + 1) % 3, b = (i + 2) % 3;
+		bias[i] = ownsEdge(t.x[a], t.y[a], t.x[b], t.y[b]) ? 0 : -1;
+		step[i] = -(t.y[b] - t.y[a]) * S;
+	}
+	for (int y = y0; y < y1; y++) {
+		int64_t px = int64_t(t.xmin) * S + S / 2, py = int64_t(y) * S + S / 2;
+		int64_t w[3];
+		for (int i = 0; i < 3; i++) {
+			int a = (i + 1) % 3, b = (i + 2) % 3;
+			w[i] = edgeFunction(t.x[a], t.y[a], t.x[b], t.y[b], px, py) + bias[i];
+		}
+		for (int x = t.xmin; x <= t.xmax; x++) {
+			if ((w[0] | w[1] | w[2]) >= 0) {
+				double z = ((w[0] - bias[0]) * t.z[0] + (w[1] - bias[1]) * t.z[1] + (w[2] - bias[2]) * t.z[2]) / area;
+				body(x, y, z);
+			}
+			for (int i = 0; i < 3; i++) w[i] += step[i];
+		}
+	}
+}
+
+// Draws the rows [ybegin, yend) of a triangle with a depth test where equal
+// depths pass, like GL_LEQUAL
+void SoftwareRenderer::drawTriangle(const ScreenTriangle &t, const Color4f &col, int ybegin, int yend)
+{
+	rasterize(t, ybegin, yend, [&](int x, int y, double z) {
+			size_t i = size_t(y) * this->width + x;
+			if (float(z) > this->depth[i]) return;
+			this->depth[i] = z;
+			blend(this->color[i], col);
+		});
+}
+
+// Draws objects with a depth buffer, blending colors that aren't opaque like
+// GL does. Triangles are drawn in order, except that with back_faces_last all
+// front faces are drawn first, like ThrownTogetherRenderer does with culling.
+void SoftwareRenderer::drawObjects(const std::vector<Object> &objects, bool back_faces_last)
+{
+	size_t bands = (this->height + BAND_HEIGHT - 1) / BAND_HEIGHT;
+	Parallel::for_each_index(0, bands, [&](size_t band) {
+			int ybegin = band * BAND_HEIGHT, yend = std::min<int>(ybegin + BAND_HEIGHT, this->height);
+			for (int pass = 0; pass < (back_faces_last ? 2 : 1); pass++) {
+				for (const auto &obj : objects) {
+					for (const auto &t : obj.triangles) {
+						if (back_faces_last && t.front != (pass == 0)) continue;
+						drawTriangle(t, shaded(t.front ? obj.front_color : obj.back_color, t.shade), ybegin, yend);
+					}
+				}
+			}
+		});
+}
+
+/*
+	Ray-based CSG: each pixel collects the surfaces of a product's objects
+	along its view ray and walks them front to back. The number of times
+	the ray is inside each object is tracked; the first surface where it
+	gets inside all intersected and outside all subtracted objects is
+	the visible one. Counts start at the value that keeps them from going
+	negative, which handles rays starting inside an object.
+*/
+void SoftwareRenderer::drawCSG(const std::vector<Object> &objects, const std::vector<std::vector<std::pair<int, bool>>> &products)
+{
+	size_t bands = (this->height + BAND_HEIGHT - 1) / BAND_HEIGHT;
+	Parallel::for_range(0, bands, [&](size_t bbegin, size_t bend) {
+			std::vector<std::vector<Fragment>> fragments(size_t(this->width) * BAND_HEIGHT);
+			std::vector<size_t> touched;
+			std::vector<int> count, lowest;
+			for (size_t band = bbegin; band < bend; band++) {
+				int ybegin = band * BAND_HEIGHT, yend = std::min<int>(ybegin + BAND_HEIGHT, this->height);
+				for (const auto &product : products) {
+					// Like OpenCSGRenderer, single objects are drawn without CSG
+					if (product.size() == 1) {
+						const Object &obj = objects[product[0].first];
+						for (const auto &t : obj.triangles) {
+							drawTriangle(t, shaded(obj.front_color, t.shade), ybegin, yend);
+						}
+						continue;
+					}
+					size_t num_intersections = 0;
+					for (size_t k = 0; k < product.size(); k++) {
+						if (!product[k].second) num_intersections++;
+						for (const auto &t : objects[product[k].first].triangles) {
+							rasterize(t, ybegin, yend, [&](int x, int y, double z) {
+									size_t i = size_t(y - ybegin) * this->width + x;
+									if (fragments[i].empty()) touched.push_back(i);
+									Fragment f = {float(z), t.shade, int(k), t.front};
+									fragments[i].push_back(f);
+								});
+						}
+					}
+					if (num_intersections == 0) touched.clear();
+					for (size_t i : touched) {
+						std::vector<Fragment> &frags = fragments[i];
+						std::sort(frags.begin(), frags.end());
+						count.assign(product.size(), 0);
+						lowest.assign(product.size(), 0);
+						for (const auto &f : frags) {
+							count[f.object] += f.front ? 1 : -1;
+							lowest[f.object] = std::min(lowest[f.object], count[f.object]);
+						}
+						size_t inside_intersections = 0, inside_subtractions = 0;
+						for (size_t k = 0; k < product.size(); k++) {
+							count[k] = -lowest[k];
+							if (count[k] > 0) (product[k].second ? inside_subtractions : inside_intersections)++;
+						}
+						size_t pixel = (ybegin + i / this->width) * size_t(this->width) + i % this->width;
+						for (const auto &f : frags) {
+							bool visible = inside_intersections == num_intersections && inside_subtractions == 0;
+							int &c = count[f.object];
+							size_t &inside = product[f.object].second ? inside_subtractions : inside_intersections;
+							if (f.front) {
+								if (c++ == 0) inside++;
+							}
+							else {
+								if (--c == 0) inside--;
+							}
+							if (!visible && inside_intersections == num_intersections && inside_subtractions == 0) {
+								if (f.depth <= this->depth[pixel]) {
+									this->depth[pixel] = f.depth;
+									blend(this->color[pixel], shaded(objects[product[f.object].first].front_color, f.shade));
+								}
+								break;
+							}
+						}
+						frags.clear();
+					}
+					touched.clear();
+				}
+			}
+		});
+}
+
+// Draws a line of the given width in pixels over everything, like GL lines
+// drawn without depth test
+void SoftwareRenderer::drawLine(const Vector3d &p0, const Vector3d &p1, const Color4f &col, double linewidth)
+{
+	Eigen::Matrix4d mvp = this->projection * this->modelview;
+	Eigen::Vector4d a = mvp * Eigen::Vector4d(p0[0], p0[1], p0[2], 1.0);
+	Eigen::Vector4d b = mvp * Eigen::Vector4d(p1[0], p1[1], p1[2], 1.0);
+	if (a[3] <= 0 || b[3] <= 0) return;
+	Vector2d sa((a[0] / a[3] + 1) / 2 * this->width, (1 - a[1] / a[3]) / 2 * this->height);
+	Vector2d sb((b[0] / b[3] + 1) / 2 * this->width, (1 - b[1] / b[3]) / 2 * this->height);
+	// One run of pixels across the line for each pixel center along its major axis
+	int major = std::fabs(sb[0] - sa[0]) >= std::fabs(sb[1] - sa[1]) ? 0 : 1, minor = 1 - major;
+	if (sa[major] > sb[major]) std::swap(sa, sb);
+	int size[2] = {int(this->width), int(this->height)};
+	int end = std::min(size[major], int(std::ceil(sb[major] - 0.5)));
+	for (int i = std::max(0, int(std::ceil(sa[major] - 0.5))); i < end; i++) {
+		double c = sa[minor] + (i + 0.5 - sa[major]) / (sb[major] - sa[major]) * (sb[minor] - sa[minor]);
+		int jend = std::min(size[minor], int(std::ceil(c + linewidth / 2 - 0.5)));
+		for (int j = std::max(0, int(std::ceil(c - linewidth / 2 - 0.5))); j < jend; j++) {
+			this->color[major == 0 ? size_t(j) * this->width + i : size_t(i) * this->width + j] = col;
+		}
+	}
+}
+
+// Draws like CGALRenderer: 2D results flat with their outlines, PolySets in the
+// material color and Nef polyhedra in the CGAL colors
+void SoftwareRenderer::renderGeometry(const shared_ptr<const Geometry> &geom)
+{
+	setupMatrices();
+	std::vector<Object> objects;
+	if (geom && geom->getDimension() == 2) {
+		Color4f col = ColorMap::getColor(*this->colorscheme, CGAL_FACE_2D_COLOR);
+		objects.push_back(Object(col, col, false));
+	}
+	else if (dynamic_pointer_cast<const PolySet>(geom)) {
+		Color4f col = ColorMap::getColor(*this->colorscheme, OPENCSG_FACE_FRONT_COLOR);
+		objects.push_back(Object(col, col));
+	}
+	else {
+		objects.push_back(Object(ColorMap::getColor(*this->colorscheme, CGAL_FACE_FRONT_COLOR),
+														 ColorMap::getColor(*this->colorscheme, CGAL_FACE_BACK_COLOR)));
+	}
+	addGeometry(objects.back(), geom, Transform3d::Identity(), 0);
+	drawObjects(objects, false);
+
+	if (shared_ptr<const Polygon2d> poly = dynamic_pointer_cast<const Polygon2d>(geom)) {
+		Color4f col = ColorMap::getColor(*this->colorscheme, CGAL_EDGE_2D_COLOR);
+		for (const auto &o : poly->outlines()) {
+			for (size_t i = 0; i < o.vertices.size(); i++) {
+				const Vector2d &v0 = o.vertices[i], &v1 = o.vertices[(i + 1) % o.vertices.size()];
+				drawLine(Vector3d(v0[0], v0[1], 0), Vector3d(v1[0], v1[1], 0), col, 2);
+			}
+		}
+	}
+}
+
+/*
+	Objects are colored like ThrownTogetherRenderer or OpenCSGRenderer do.
+	The background and highlight passes are drawn after the root products,
+	thrown together, or in CSG mode with CSG like the root products.
+*/
+void SoftwareRenderer::renderProducts(const CSGProducts *root_products,
+																			const CSGProducts *highlight_products,
+																			const CSGProducts *background_products, bool csg)
+{
+	setupMatrices();
+	Color4f material = ColorMap::getColor(*this->colorscheme, OPENCSG_FACE_FRONT_COLOR);
+	Color4f cutout = ColorMap::getColor(*this->colorscheme, OPENCSG_FACE_BACK_COLOR);
+	// Same as the defaults in Renderer
+	Color4f highlight(255, 81, 81, 128);
+	Color4f background(180, 180, 180, 128);
+
+	enum { ROOT, BACKGROUND, HIGHLIGHT };
+	const CSGProducts *passes[] = {root_products, background_products, highlight_products};
+	for (int pass = ROOT; pass <= HIGHLIGHT; pass++) {
+		if (!passes[pass]) continue;
+		std::vector<Object> objects;
+		std::vector<std::vector<std::pair<int, bool>>> products;
+		// Objects by geometry, matrix and whether they're subtracted
+		std::map<std::tuple<const Geometry *, const Transform3d *, bool>, int> objectids;
+		for (const auto &product : passes[pass]->products) {
+			std::vector<std::pair<int, bool>> indices;
+			for (int subtracted = 0; subtracted < 2; subtracted++) {
+				for (const auto &csgobj : subtracted ? product.subtractions : product.intersections) {
+					if (!csgobj.leaf->geom) continue;
+					auto key = std::make_tuple(csgobj.leaf->geom.get(), &csgobj.leaf->matrix, csg && subtracted);
+					auto it = objectids.find(key);
+					if (it != objectids.end()) {
+						if (csg) indices.push_back(std::make_pair(it->second, bool(subtracted)));
+						continue;
+					}
+					// Only thrown together shows highlighted objects in the other passes
+					Color4f col = pass == HIGHLIGHT || (!csg && (csgobj.flags & CSGNode::FLAG_HIGHLIGHT)) ? highlight :
+						leafColor(csgobj.leaf->color, pass == BACKGROUND ? background : subtracted ? cutout : material);
+					// Thrown together shows back faces of the root products in magenta
+					objects.push_back(Object(col, csg || pass != ROOT ? col : Color4f(255, 0, 255)));
+					addGeometry(objects.back(), csgobj.leaf->geom, csgobj.leaf->matrix, subtracted ? 1.1 : 1.0);
+					objectids[key] = objects.size() - 1;
+					indices.push_back(std::make_pair(objects.size() - 1, bool(subtracted)));
+				}
+			}
+			products.push_back(indices);
+		}
+		if (csg) drawCSG(objects, products);
+		else drawObjects(objects, pass == ROOT);
+	}
+}
+
+bool SoftwareRenderer::save(std::ostream &output) const
+{
+	std::vector<unsigned char> pixels(size_t(this->width) * this->height * 4);
+	for (size_t i = 0; i < this->color.size(); i++) {
+		for (int c = 0; c < 3; c++) {
+			pixels[i * 4 + c] = (unsigned char)lround(std::max(0.0f, std::min(1.0f, this->color[i][c])) * 255);
+		}
+		pixels[i * 4 + 3] = 255;
+	}
+	return write_png(output, &pixels[0], this->width, this->height);
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "linalg.h"
+#include "memory.h"
+#include "colormap.h"
+#include "Camera.h"
+#include <vector>
+#include <iostream>
+
+/*!
+	CPU rasterizer for exporting images without an OpenGL context, selected
+	with --render-backend=software.
+
+	The camera, lighting and colors follow the GL views. Image rows are
+	rasterized in parallel bands, so the result doesn't depend on the
+	number of threads.
+
+	Previews come in two modes:
+	- Thrown together: all objects are drawn with a depth buffer.
+	- CSG: the products are evaluated per pixel. Each pixel collects the
+	  surfaces of all objects of a product along its view ray, and the
+	  first point inside all intersected and outside all subtracted
+	  objects is shown. This gives the same image as OpenCSG.
+*/
+class SoftwareRenderer
+{
+public:
+	SoftwareRenderer(unsigned int width, unsigned int height);
+
+	void setCamera(const Camera &cam) { this->cam = cam; }
+	void setColorScheme(const ColorScheme &cs);
+	void setColorScheme(const std::string &cs);
+
+	// Renders a geometry evaluation result, like CGALRenderer
+	void renderGeometry(const shared_ptr<const class Geometry> &geom);
+	// Renders CSG products like ThrownTogetherRenderer or, if csg is set, like OpenCSGRenderer
+	void renderProducts(const class CSGProducts *root_products,
+											const CSGProducts *highlight_products,
+											const CSGProducts *background_products, bool csg);
+
+	bool save(std::ostream &output) const;
+
+private:
+	// A triangle in screen coordinates. x and y are fixed point with SUBPIXEL_BITS
+	// fractional bits, z is the normalized device depth.
+	struct ScreenTriangle {
+		int64_t x[3], y[3];
+		double z[3];
+		int xmin, xmax, ymin, ymax;
+		float shade;
+		bool front;
+	};
+
+	// The triangles of one object and the colors it is drawn with
+	struct Object {
+		Object(const Color4f &front_color, const Color4f &back_color, bool lighting = true)
+			: front_color(front_color), back_color(back_color), lighting(lighting) {}
+		std::vector<ScreenTriangle> triangles;
+		Color4f front_color, back_color;
+		bool lighting;
+	};
+
+	struct Fragment {
+		float depth;
+		float shade;
+		int object;
+		bool front;
+		bool operator<(const Fragment &other) const { return depth < other.depth; }
+	};
+
+	void setupMatrices();
+	void addTriangle(Object &obj, const Vector3d &p0, const Vector3d &p1, const Vector3d &p2) const;
+	void addPolySet(Object &obj, const class PolySet &ps, const Transform3d &m, double thickness) const;
+	void addGeometry(Object &obj, const shared_ptr<const Geometry> &geom, const Transform3d &m, double thickness) const;
+
+	template <typename Body>
+	void rasterize(const ScreenTriangle &t, int ybegin, int yend, Body body) const;
+	void drawTriangle(const ScreenTriangle &t, const Color4f &col, int ybegin, int yend);
+	void drawObjects(const std::vector<Object> &objects, bool back_faces_last);
+	void drawCSG(const std::vector<Object> &objects, const std::vector<std::vector<std::pair<int, bool>>> &products);
+	void drawLine(const Vector3d &p0, const Vector3d &p1, const Color4f &col, double linewidth);
+
+	static const int SUBPIXEL_BITS = 8;
+	static const int BAND_HEIGHT = 16;
+
+	unsigned int width, height;
+	Camera cam;
+	const ColorScheme *colorscheme;
+	Eigen::Matrix4d modelview, projection;
+	Vector3d light;
+	std::vector<Color4f> color;
+	std::vector<float> depth;
+};
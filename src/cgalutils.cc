@@ -4,6 +4,7 @@
 #ifdef ENABLE_CGAL
 
 #include "cgalutils.h"
+#include "CGALCache.h"
 #include "polyset.h"
 #include "printutils.h"
 #include "Polygon2d.h"
@@ -30,6 +31,7 @@
 #include "Reindexer.h"
 #include "hash.h"
 #include "GeometryUtils.h"
+#include "parallel.h"
 
 #include <map>
 #include <queue>
@@ -39,26 +41,39 @@ static CGAL_Nef_polyhedron *createNefPolyhedronFromPolySet(const PolySet &ps)
 	if (ps.isEmpty()) return new CGAL_Nef_polyhedron();
 	assert(ps.getDimension() == 3);
 
-	// Since is_convex doesn't work well with non-planar faces,
-	// we tessellate the polyset before checking.
 	PolySet psq(ps);
 	psq.quantizeVertices();
-	PolySet ps_tri(3, psq.convexValue());
-	PolysetUtils::tessellate_faces(psq, ps_tri);
-	if (ps_tri.is_convex()) {
+
+	// The tessellated polyset is only needed when convexity isn't known yet,
+	// since is_convex doesn't work well with non-planar faces, or as a fallback
+	// for faces which aren't planar.
+	shared_ptr<PolySet> ps_tri;
+	auto tessellated = [&]() -> const PolySet & {
+		if (!ps_tri) {
+			ps_tri.reset(new PolySet(3, psq.convexValue()));
+			PolysetUtils::tessellate_faces(psq, *ps_tri);
+		}
+		return *ps_tri;
+	};
+
+	bool convex;
+	if (psq.isEmpty() || psq.convexValue()) convex = true;
+	else if (!psq.convexValue()) convex = false;
+	else convex = tessellated().is_convex();
+	if (convex) {
 		typedef CGAL::Epick K;
 		// Collect point cloud
-		// FIXME: Use unordered container (need hash)
-		// NB! CGAL's convex_hull_3() doesn't like std::set iterators, so we use a list
-		// instead.
-		std::list<K::Point_3> points;
+		std::vector<K::Point_3> points;
+		size_t numverts = 0;
+		for(const auto &poly : psq.polygons) numverts += poly.size();
+		points.reserve(numverts);
 		for(const auto &poly : psq.polygons) {
 			for(const auto &p : poly) {
 				points.push_back(vector_convert<K::Point_3>(p));
 			}
 		}
 
-		if (points.size() <= 3) return new CGAL_Nef_polyhedron();;
+		if (points.size() <= 3) return new CGAL_Nef_polyhedron();
 
 		// Apply hull
 		CGAL::Polyhedron_3<K> r;
@@ -92,7 +107,7 @@ static CGAL_Nef_polyhedron *createNefPolyhedronFromPolySet(const PolySet &ps)
 	}
 	if (plane_error) try {
 			CGAL_Polyhedron P;
-			bool err = CGALUtils::createPolyhedronFromPolySet(ps_tri, P);
+			bool err = CGALUtils::createPolyhedronFromPolySet(tessellated(), P);
             if (!err) {
                 PRINTDB("Polyhedron is closed: %d", P.is_closed());
                 PRINTDB("Polyhedron is valid: %d", P.is_valid(false, 0));
@@ -309,9 +324,13 @@ namespace CGALUtils {
 			PRINTB("Error: Non-manifold mesh encountered: %d unconnected edges", unconnected);
 		}
 		// 3. Triangulate each face
+		//    Faces are tessellated in parallel, each into its own triangle list.
+		//    The lists are concatenated in face order, so the result doesn't depend
+		//    on the number of threads.
 		const Vector3f *verts = allVertices.getArray();
-		std::vector<IndexedTriangle> allTriangles;
-		for(const auto &faces : polygons) {
+		std::vector<std::vector<IndexedTriangle>> facetriangles(polygons.size());
+		Parallel::for_each_index(0, polygons.size(), [&](size_t i) {
+			const std::vector<IndexedFace> &faces = polygons[i];
 #if 0 // For debugging
 			std::cerr << "---\n";
 			for(const auto &poly : faces) {
@@ -320,23 +339,8 @@ namespace CGALUtils {
 				}
 				std::cerr << "\n";
 			}
-#if 0 // debug
-			std::cerr.precision(20);
-			for(const auto &poly : faces) {
-				for(auto i : poly) {
-					std::cerr << verts[i][0] << "," << verts[i][1] << "," << verts[i][2] << "\n";
-				}
-				std::cerr << "\n";
-			}
-#endif // debug
 			std::cerr << "-\n";
 #endif // debug
-#if 0 // For debugging
-		std::cerr.precision(20);
-		for (size_t i=0;i<allVertices.size();i++) {
-			std::cerr << verts[i][0] << ", " << verts[i][1] << ", " << verts[i][2] << "\n";
-		}		
-#endif // debug
 
 			/* at this stage, we have a sequence of polygons. the first
 				 is the "outside edge' or 'body' or 'border', and the rest of the
@@ -350,17 +354,24 @@ namespace CGALUtils {
 			// See http://cgal-discuss.949826.n4.nabble.com/Nef3-Wrong-normal-vector-reported-causes-triangulator-crash-tt4660282.html
 			// CGAL::Vector_3<CGAL_Kernel3> nvec = plane.orthogonal_vector();
 			// K::Vector_3 normal(CGAL::to_double(nvec.x()), CGAL::to_double(nvec.y()), CGAL::to_double(nvec.z()));
-			std::vector<IndexedTriangle> triangles;
-			bool err = GeometryUtils::tessellatePolygonWithHoles(verts, faces, triangles, NULL);
-			if (!err) {
-				for(const auto &t : triangles) {
-					assert(t[0] >= 0 && t[0] < (int)allVertices.size());
-					assert(t[1] >= 0 && t[1] < (int)allVertices.size());
-					assert(t[2] >= 0 && t[2] < (int)allVertices.size());
-					allTriangles.push_back(t);
-				}
+			// Faces which fail to tessellate are left out
+			std::vector<IndexedTriangle> &triangles = facetriangles[i];
+			if (GeometryUtils::tessellatePolygonWithHoles(verts, faces, triangles, NULL)) triangles.clear();
+			for(const auto &t : triangles) {
+				assert(t[0] >= 0 && t[0] < (int)allVertices.size());
+				assert(t[1] >= 0 && t[1] < (int)allVertices.size());
+				assert(t[2] >= 0 && t[2] < (int)allVertices.size());
 			}
+		}, 64);
+
+		std::vector<IndexedTriangle> allTriangles;
+		size_t numtriangles = 0;
+		for(const auto &triangles : facetriangles) numtriangles += triangles.size();
+		allTriangles.reserve(numtriangles);
+		for(const auto &triangles : facetriangles) {
+			allTriangles.insert(allTriangles.end(), triangles.begin(), triangles.end());
 		}
+		std::vector<std::vector<IndexedTriangle>>().swap(facetriangles);
 
 #if 0 // For debugging
 		for(const auto &t : allTriangles) {
@@ -373,6 +384,7 @@ namespace CGALUtils {
 			PRINTB("Error: Non-manifold triangle mesh created: %d unconnected edges", unconnected2);
 		}
 
+		ps.polygons.reserve(ps.polygons.size() + allTriangles.size());
 		for(const auto &t : allTriangles) {
 			ps.append_poly();
 			ps.append_vertex(verts[t[0]]);
@@ -390,6 +402,30 @@ namespace CGALUtils {
 		return err;
 	}
 #endif // createPolySetFromNefPolyhedron3
+
+/*!
+	Returns N as a PolySet. The PolySet is only extracted once and kept with
+	N, so exporting or projecting the same result again doesn't repeat the
+	extraction. Returns NULL if the extraction failed; failures are kept as
+	well, so they aren't retried and reported again.
+*/
+	shared_ptr<const PolySet> getPolySet(const CGAL_Nef_polyhedron &N)
+	{
+		// Kept with N in place of the PolySet if the extraction failed
+		static const shared_ptr<const PolySet> failed(new PolySet(3));
+
+		if (!N.polyset) {
+			PolySet *ps = new PolySet(3);
+			ps->setConvexity(N.getConvexity());
+			shared_ptr<const PolySet> result(ps);
+			if (!N.isEmpty() && createPolySetFromNefPolyhedron3(*N.p3, *ps)) result = failed;
+			N.polyset = result;
+			// N may be cached, its size changed
+			CGALCache::instance()->updateSize(N);
+		}
+		return N.polyset == failed ? shared_ptr<const PolySet>() : N.polyset;
+	}
+
 #if 0
 	bool createPolySetFromNefPolyhedron3(const CGAL_Nef_polyhedron3 &N, PolySet &ps)
 	{
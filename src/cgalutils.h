@@ -36,6 +36,7 @@ namespace CGALUtils {
 
 	CGAL_Nef_polyhedron *createNefPolyhedronFromGeometry(const class Geometry &geom);
 	bool createPolySetFromNefPolyhedron3(const CGAL_Nef_polyhedron3 &N, PolySet &ps);
+	shared_ptr<const PolySet> getPolySet(const CGAL_Nef_polyhedron &N);
 
 	bool tessellatePolygon(const PolygonK &polygon,
 												 Polygons &triangles,
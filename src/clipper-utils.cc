@@ -1,8 +1,15 @@
 #include "clipper-utils.h"
 #include "printutils.h"
+#include "parallel.h"
+#include "polyset.h"
+
+#include <limits>
 
 namespace ClipperUtils {
 
+	// Minimum number of operands per task when splitting work across threads
+	static const size_t PARALLEL_THRESHOLD = 32;
+
 	ClipperLib::Path fromOutline2d(const Outline2d &outline, bool keep_orientation) {
 		ClipperLib::Path p;
 		for(const auto &v : outline.vertices) {
@@ -23,6 +30,92 @@ namespace ClipperUtils {
 		return result;
 	}
 
+	struct ProjectedEdge {
+		ClipperLib::IntPoint a, b;
+		int dir;
+		bool operator<(const ProjectedEdge &o) const {
+			if (a.X != o.a.X) return a.X < o.a.X;
+			if (a.Y != o.a.Y) return a.Y < o.a.Y;
+			if (b.X != o.b.X) return b.X < o.b.X;
+			return b.Y < o.b.Y;
+		}
+		bool sameAs(const ProjectedEdge &o) const { return a == o.a && b == o.b; }
+	};
+
+	// Returns true if every projected edge is cancelled by an edge running the other way
+	static bool isClosedProjection(const ClipperLib::Paths &faces)
+	{
+		std::vector<ProjectedEdge> edges;
+		for(const auto &face : faces) {
+			for (size_t i = 0; i < face.size(); i++) {
+				const ClipperLib::IntPoint &p1 = face[i];
+				const ClipperLib::IntPoint &p2 = face[(i + 1) % face.size()];
+				if (p1 == p2) continue;
+				bool fwd = p1.X < p2.X || (p1.X == p2.X && p1.Y < p2.Y);
+				edges.push_back({fwd ? p1 : p2, fwd ? p2 : p1, fwd ? 1 : -1});
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+		int sum = 0;
+		for (size_t i = 0; i < edges.size(); i++) {
+			sum += edges[i].dir;
+			if (i + 1 == edges.size() || !edges[i].sameAs(edges[i + 1])) {
+				if (sum != 0) return false;
+			}
+		}
+		return true;
+	}
+
+	// Exact test for clockwise or degenerate triangles. Triangles too large for
+	// exact 64-bit arithmetic are never reported.
+	static bool isBackFacingTriangle(const ClipperLib::Path &tri)
+	{
+		const ClipperLib::cInt range = 0x3FFFFFFF;
+		for(const auto &p : tri) {
+			if (p.X > range || p.Y > range || -p.X > range || -p.Y > range) return false;
+		}
+		ClipperLib::cInt cross = (tri[1].X - tri[0].X) * (tri[2].Y - tri[0].Y) -
+			(tri[1].Y - tri[0].Y) * (tri[2].X - tri[0].X);
+		return cross <= 0;
+	}
+
+	/*!
+		Projects all faces of the given PolySet onto the XY plane.
+		All returned faces are oriented counter-clockwise, so their union
+		using the NonZero fill rule is the footprint of the PolySet.
+
+		If the projected faces form a closed surface (every edge is matched by
+		an edge in the opposite direction), each point covered by a back-facing
+		triangle is also covered by a front-facing face. Back-facing and
+		degenerate triangles are then dropped, which typically halves the
+		number of paths to union. Orientation is decided in Clipper's integer
+		coordinates, so this is exact.
+	 */
+	ClipperLib::Paths fromPolySetProjection(const PolySet &ps)
+	{
+		ClipperLib::Paths faces(ps.polygons.size());
+		Parallel::for_each_index(0, faces.size(), [&](size_t i) {
+				ClipperLib::Path &face = faces[i];
+				face.reserve(ps.polygons[i].size());
+				for(const auto &v : ps.polygons[i]) {
+					face.push_back(ClipperLib::IntPoint(v[0]*CLIPPER_SCALE, v[1]*CLIPPER_SCALE));
+				}
+			}, 1024);
+
+		bool cull = isClosedProjection(faces);
+		size_t n = 0;
+		for (size_t i = 0; i < faces.size(); i++) {
+			ClipperLib::Path &face = faces[i];
+			if (face.size() < 3) continue;
+			if (cull && face.size() == 3 && isBackFacingTriangle(face)) continue;
+			if (!ClipperLib::Orientation(face)) std::reverse(face.begin(), face.end());
+			if (n != i) faces[n].swap(face);
+			n++;
+		}
+		faces.resize(n);
+		return faces;
+	}
+
 	Polygon2d *sanitize(const Polygon2d &poly) {
 		return toPolygon2d(sanitize(ClipperUtils::fromPolygon2d(poly)));
 	}
@@ -89,6 +182,108 @@ namespace ClipperUtils {
 		return result;
 	}
 
+	static void addOperand(ClipperLib::Clipper &clipper, const ClipperLib::Path &path) {
+		clipper.AddPath(path, ClipperLib::ptSubject, true);
+	}
+
+	static void addOperand(ClipperLib::Clipper &clipper, const ClipperLib::Paths &paths) {
+		clipper.AddPaths(paths, ClipperLib::ptSubject, true);
+	}
+
+	static void lowerCorner(const ClipperLib::Path &path, ClipperLib::IntPoint &corner) {
+		for(const auto &p : path) {
+			corner.X = std::min(corner.X, p.X);
+			corner.Y = std::min(corner.Y, p.Y);
+		}
+	}
+
+	static void lowerCorner(const ClipperLib::Paths &paths, ClipperLib::IntPoint &corner) {
+		for(const auto &path : paths) lowerCorner(path, corner);
+	}
+
+	/*!
+		Unions a set of operands (either single paths or sets of paths).
+
+		Small inputs are handled by a single Clipper execution. Larger inputs are
+		sorted by the lower left corner of their bounding box, so each chunk
+		holds operands which are close to each other, and the chunks are unioned in
+		parallel. The partial results are then merged pairwise in a reduction tree.
+		Clipper objects are independent, so each task uses its own.
+	 */
+	template<typename Operand>
+	static ClipperLib::Paths unionOperands(const std::vector<Operand> &operandsvector)
+	{
+		std::vector<const Operand *> operands;
+		std::vector<ClipperLib::IntPoint> corners;
+		for(const auto &operand : operandsvector) {
+			if (operand.empty()) continue;
+			ClipperLib::IntPoint corner(std::numeric_limits<ClipperLib::cInt>::max(),
+																	std::numeric_limits<ClipperLib::cInt>::max());
+			lowerCorner(operand, corner);
+			operands.push_back(&operand);
+			corners.push_back(corner);
+		}
+
+		size_t numchunks = std::min<size_t>(Parallel::maxThreads() * 2, operands.size() / PARALLEL_THRESHOLD);
+		if (numchunks <= 1) {
+			ClipperLib::Clipper clipper;
+			for(const auto &operand : operands) addOperand(clipper, *operand);
+			ClipperLib::Paths result;
+			clipper.Execute(ClipperLib::ctUnion, result, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+			return result;
+		}
+
+		std::vector<size_t> order(operands.size());
+		for (size_t i = 0; i < order.size(); i++) order[i] = i;
+		std::sort(order.begin(), order.end(), [&corners](size_t a, size_t b) {
+				if (corners[a].X != corners[b].X) return corners[a].X < corners[b].X;
+				return corners[a].Y < corners[b].Y;
+			});
+
+		std::vector<ClipperLib::Paths> partial(numchunks);
+		size_t chunksize = (order.size() + numchunks - 1) / numchunks;
+		Parallel::for_each_index(0, numchunks, [&](size_t c) {
+				ClipperLib::Clipper clipper;
+				size_t end = std::min(order.size(), (c + 1) * chunksize);
+				for (size_t i = c * chunksize; i < end; i++) {
+					addOperand(clipper, *operands[order[i]]);
+				}
+				clipper.Execute(ClipperLib::ctUnion, partial[c], ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+			});
+
+		// Neighbouring chunks are spatially adjacent, merge them pairwise
+		while (partial.size() > 1) {
+			std::vector<ClipperLib::Paths> merged((partial.size() + 1) / 2);
+			Parallel::for_each_index(0, merged.size(), [&](size_t m) {
+					if (2*m + 1 == partial.size()) {
+						merged[m].swap(partial[2*m]);
+						return;
+					}
+					ClipperLib::Clipper clipper;
+					clipper.AddPaths(partial[2*m], ClipperLib::ptSubject, true);
+					clipper.AddPaths(partial[2*m + 1], ClipperLib::ptSubject, true);
+					clipper.Execute(ClipperLib::ctUnion, merged[m], ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+				});
+			partial.swap(merged);
+		}
+		return partial.front();
+	}
+
+	ClipperLib::Paths unionPaths(const std::vector<ClipperLib::Paths> &pathsvector)
+	{
+		return unionOperands(pathsvector);
+	}
+
+	/*!
+		Unions paths as individual operands using the NonZero fill rule.
+		Useful for large numbers of small, overlapping paths like projected
+		mesh faces.
+	 */
+	ClipperLib::Paths unionPaths(const ClipperLib::Paths &paths)
+	{
+		return unionOperands(paths);
+	}
+
 	/*!
 		Apply the clipper operator to the given paths.
 
@@ -115,10 +310,24 @@ namespace ClipperUtils {
 			return ClipperUtils::toPolygon2d(result);
 		}
 
-		bool first = true;
-		for(const auto &paths : pathsvector) {
-			clipper.AddPaths(paths, first ? ClipperLib::ptSubject : ClipperLib::ptClip, true);
-			if (first) first = false;
+		if ((clipType == ClipperLib::ctUnion || clipType == ClipperLib::ctDifference) &&
+				pathsvector.size() > 2 * PARALLEL_THRESHOLD) {
+			// Many operands: Union the clip operands separately, in parallel
+			if (clipType == ClipperLib::ctUnion) {
+				clipper.AddPaths(unionPaths(pathsvector), ClipperLib::ptSubject, true);
+			}
+			else {
+				std::vector<ClipperLib::Paths> clips(pathsvector.begin() + 1, pathsvector.end());
+				clipper.AddPaths(pathsvector[0], ClipperLib::ptSubject, true);
+				clipper.AddPaths(unionPaths(clips), ClipperLib::ptClip, true);
+			}
+		}
+		else {
+			bool first = true;
+			for(const auto &paths : pathsvector) {
+				clipper.AddPaths(paths, first ? ClipperLib::ptSubject : ClipperLib::ptClip, true);
+				if (first) first = false;
+			}
 		}
 		ClipperLib::PolyTree sumresult;
 		clipper.Execute(clipType, sumresult, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
@@ -136,12 +345,14 @@ namespace ClipperUtils {
 	Polygon2d *apply(const std::vector<const Polygon2d*> &polygons, 
 									 ClipperLib::ClipType clipType)
 	{
-		std::vector<ClipperLib::Paths> pathsvector;
-		for(const auto &polygon : polygons) {
-			ClipperLib::Paths polypaths = fromPolygon2d(*polygon);
-			if (!polygon->isSanitized()) ClipperLib::PolyTreeToPaths(sanitize(polypaths), polypaths);
-			pathsvector.push_back(polypaths);
-		}
+		// Conversion and sanitizing are independent per polygon
+		std::vector<ClipperLib::Paths> pathsvector(polygons.size());
+		Parallel::for_each_index(0, polygons.size(), [&](size_t i) {
+				const Polygon2d *polygon = polygons[i];
+				ClipperLib::Paths &polypaths = pathsvector[i];
+				polypaths = fromPolygon2d(*polygon);
+				if (!polygon->isSanitized()) ClipperLib::PolyTreeToPaths(sanitize(polypaths), polypaths);
+			}, PARALLEL_THRESHOLD);
 		Polygon2d *res = apply(pathsvector, clipType);
         assert(res);
 		return res;
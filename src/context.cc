@@ -42,6 +42,9 @@ static bool is_config_variable(const std::string &name) {
 	return name[0] == '$' && name != "$children";
 }
 
+// Stack used instead of the parent's stack, see Context::ForkedStack
+static thread_local Context::Stack *forked_stack = NULL;
+
 /*!
 	Initializes this context. Optionally initializes a context for an 
 	external library. Note that if parent is null, a new stack will be
@@ -52,7 +55,7 @@ Context::Context(const Context *parent)
 {
 	if (parent) {
 		assert(parent->ctx_stack && "Parent context stack was null!");
-		this->ctx_stack = parent->ctx_stack;
+		this->ctx_stack = forked_stack ? forked_stack : parent->ctx_stack;
 		this->document_path = parent->document_path;
 	}
 	else {
@@ -69,6 +72,17 @@ Context::~Context()
 	if (!parent) delete this->ctx_stack;
 }
 
+Context::ForkedStack::ForkedStack(const Context *ctx)
+	: stack(*ctx->ctx_stack), previous(forked_stack)
+{
+	forked_stack = &this->stack;
+}
+
+Context::ForkedStack::~ForkedStack()
+{
+	forked_stack = this->previous;
+}
+
 /*!
 	Initialize context from a module argument list and a evaluation context
 	which may pass variables which will be preferred over default values.
@@ -100,6 +114,15 @@ void Context::set_variable(const std::string &name, const ValuePtr &value)
 	else this->variables[name] = value;
 }
 
+/*!
+	Returns the storage of a variable of this context, creating it if needed.
+	The reference stays valid for the lifetime of the context.
+*/
+ValuePtr &Context::variable_ref(const std::string &name)
+{
+	return is_config_variable(name) ? this->config_variables[name] : this->variables[name];
+}
+
 void Context::set_variable(const std::string &name, const Value &value)
 {
 	set_variable(name, ValuePtr(value));
@@ -127,6 +150,19 @@ void Context::apply_variables(const Context &other)
 	}
 }
 
+/*!
+	Takes over the variables of other, as if this was a fresh context for a
+	call made from here. Config variables are added rather than replaced, since
+	they would still be visible from the previous call through the context stack.
+*/
+void Context::replace_variables(Context &other)
+{
+	this->variables.swap(other.variables);
+	for(const auto &var : other.config_variables) {
+		this->config_variables[var.first] = var.second;
+	}
+}
+
 ValuePtr Context::lookup_variable(const std::string &name, bool silent) const
 {
 	if (!this->ctx_stack) {
@@ -181,6 +217,14 @@ ValuePtr Context::evaluate_function(const std::string &name, const EvalContext *
 	return ValuePtr::undefined;
 }
 
+/*!
+	Returns the function evaluate_function() would call, without calling it.
+*/
+const AbstractFunction *Context::findFunction(const std::string &name) const
+{
+	return this->parent ? this->parent->findFunction(name) : NULL;
+}
+
 AbstractNode *Context::instantiate_module(const ModuleInstantiation &inst, EvalContext *evalctx) const
 {
 	if (this->parent) return this->parent->instantiate_module(inst, evalctx);
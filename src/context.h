@@ -14,19 +14,38 @@ public:
 	Context(const Context *parent = NULL);
 	virtual ~Context();
 
+	/*!
+		While in scope, contexts created by the current thread go on a copy of
+		the stack of ctx instead of the stack of their parent. This allows
+		evaluating on another thread, as long as the original stack doesn't
+		change meanwhile.
+	*/
+	class ForkedStack
+	{
+	public:
+		ForkedStack(const Context *ctx);
+		~ForkedStack();
+	private:
+		Stack stack;
+		Stack *previous;
+	};
+
 	const Context *getParent() const { return this->parent; }
 	virtual ValuePtr evaluate_function(const std::string &name, const class EvalContext *evalctx) const;
+	virtual const class AbstractFunction *findFunction(const std::string &name) const;
 	virtual class AbstractNode *instantiate_module(const class ModuleInstantiation &inst, EvalContext *evalctx) const;
 
 	void setVariables(const AssignmentList &args,
 										const class EvalContext *evalctx = NULL);
 
 	void set_variable(const std::string &name, const ValuePtr &value);
+	ValuePtr &variable_ref(const std::string &name);
 	void set_variable(const std::string &name, const Value &value);
 	void set_constant(const std::string &name, const ValuePtr &value);
 	void set_constant(const std::string &name, const Value &value);
 
         void apply_variables(const Context &other);
+	void replace_variables(Context &other);
 	ValuePtr lookup_variable(const std::string &name, bool silent = false) const;
 	bool has_local_variable(const std::string &name) const;
 
@@ -31,7 +31,14 @@
 #include "expression.h"
 #include "builtin.h"
 #include "printutils.h"
+#include "feature.h"
+#include "parallel.h"
+#include "stackcheck.h"
+#include "PlatformUtils.h"
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <exception>
 #include <sstream>
 
 class ControlModule : public AbstractModule
@@ -54,8 +61,11 @@ public: // methods
 
 	virtual AbstractNode *instantiate(const Context *ctx, const ModuleInstantiation *inst, EvalContext *evalctx) const;
 
-	static void for_eval(AbstractNode &node, const ModuleInstantiation &inst, size_t l, 
+	static void for_eval(std::vector<AbstractNode *> &children, const ModuleInstantiation &inst, size_t l, 
 						 const Context *ctx, const EvalContext *evalctx);
+	static bool for_eval_parallel(std::vector<AbstractNode *> &children, const ModuleInstantiation &inst,
+																const std::string &it_name, const ValuePtr &it_values,
+																const Context *ctx, const EvalContext *evalctx);
 
 	static const EvalContext* getLastModuleCtx(const EvalContext *evalctx);
 	
@@ -66,12 +76,18 @@ private: // data
 
 }; // class ControlModule
 
-void ControlModule::for_eval(AbstractNode &node, const ModuleInstantiation &inst, size_t l, 
+// Set while instantiating loop iterations in parallel; nested loops run sequentially
+static thread_local bool in_parallel_for = false;
+// Minimum estimated time in seconds for the iterations handed to one thread
+static const double MIN_PARALLEL_WORK = 0.001;
+
+void ControlModule::for_eval(std::vector<AbstractNode *> &children, const ModuleInstantiation &inst, size_t l, 
 							const Context *ctx, const EvalContext *evalctx)
 {
 	if (evalctx->numArgs() > l) {
 		const std::string &it_name = evalctx->getArgName(l);
 		ValuePtr it_values = evalctx->getArgValue(l, ctx);
+		if (l == 0 && for_eval_parallel(children, inst, it_name, it_values, ctx, evalctx)) return;
 		Context c(ctx);
 		if (it_values->type() == Value::RANGE) {
 			RangeType range = it_values->toRange();
@@ -81,19 +97,25 @@ void ControlModule::for_eval(AbstractNode &node, const ModuleInstantiation &inst
 			} else {
 				for (RangeType::iterator it = range.begin();it != range.end();it++) {
 					c.set_variable(it_name, ValuePtr(*it));
-					for_eval(node, inst, l+1, &c, evalctx);
+					for_eval(children, inst, l+1, &c, evalctx);
 				}
 			}
 		}
+		else if (const std::vector<double> *numbers = it_values->toNumbers()) {
+			for (double d : *numbers) {
+				c.set_variable(it_name, ValuePtr(d));
+				for_eval(children, inst, l+1, &c, evalctx);
+			}
+		}
 		else if (it_values->type() == Value::VECTOR) {
 			for (size_t i = 0; i < it_values->toVector().size(); i++) {
 				c.set_variable(it_name, it_values->toVector()[i]);
-				for_eval(node, inst, l+1, &c, evalctx);
+				for_eval(children, inst, l+1, &c, evalctx);
 			}
 		}
 		else if (it_values->type() != Value::UNDEFINED) {
 			c.set_variable(it_name, it_values);
-			for_eval(node, inst, l+1, &c, evalctx);
+			for_eval(children, inst, l+1, &c, evalctx);
 		}
 	} else if (l > 0) {
 		// At this point, the for loop variables have been set and we can initialize
@@ -104,8 +126,119 @@ void ControlModule::for_eval(AbstractNode &node, const ModuleInstantiation &inst
 		}
 		
 		std::vector<AbstractNode *> instantiatednodes = inst.instantiateChildren(&c);
-		node.children.insert(node.children.end(), instantiatednodes.begin(), instantiatednodes.end());
+		children.insert(children.end(), instantiatednodes.begin(), instantiatednodes.end());
+	}
+}
+
+/*!
+	Instantiates the iterations of the outermost loop variable on worker threads,
+	if enabled and the first iteration suggests the others take long enough.
+	Returns false if the caller needs to evaluate the loop.
+
+	Every iteration runs on its own context stack, collects its console output
+	and numbers its nodes from zero. The results are merged in iteration order,
+	so the node tree, node indices and output are the same as when evaluated
+	sequentially. If an iteration fails, the output of the iterations up to it
+	is printed and its exception is rethrown.
+*/
+bool ControlModule::for_eval_parallel(std::vector<AbstractNode *> &children, const ModuleInstantiation &inst,
+																			const std::string &it_name, const ValuePtr &it_values,
+																			const Context *ctx, const EvalContext *evalctx)
+{
+	if (!Feature::ExperimentalParallelFor.is_enabled() || in_parallel_for || Parallel::maxThreads() < 2) {
+		return false;
+	}
+
+	std::vector<ValuePtr> values;
+	if (it_values->type() == Value::RANGE) {
+		RangeType range = it_values->toRange();
+		if (range.numValues() >= 10000) return false; // Let the sequential code warn
+		for (RangeType::iterator it = range.begin();it != range.end();it++) {
+			values.push_back(ValuePtr(*it));
+		}
+	}
+	else if (const std::vector<double> *numbers = it_values->toNumbers()) {
+		for (double d : *numbers) values.push_back(ValuePtr(d));
+	}
+	else if (it_values->type() == Value::VECTOR) {
+		const Value::VectorType &vec = it_values->toVector();
+		values.assign(vec.begin(), vec.end());
 	}
+	if (values.size() < 2) return false;
+
+	// The first iteration is instantiated here, and its time taken as the
+	// estimate for the others. Loops too cheap to be worth handing to at
+	// least two threads finish sequentially.
+	Context first(ctx);
+	auto start = std::chrono::steady_clock::now();
+	first.set_variable(it_name, values[0]);
+	for_eval(children, inst, 1, &first, evalctx);
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	size_t grainsize = elapsed > 0 ? size_t(MIN_PARALLEL_WORK / elapsed) + 1 : values.size();
+	if ((values.size() - 1) / grainsize < 2) {
+		for (size_t i = 1; i < values.size(); i++) {
+			first.set_variable(it_name, values[i]);
+			for_eval(children, inst, 1, &first, evalctx);
+		}
+		return true;
+	}
+	values.erase(values.begin());
+
+	struct Iteration {
+		std::vector<AbstractNode *> nodes;
+		size_t numindices = 0;
+		PrintCapture output;
+		std::exception_ptr error;
+	};
+	std::vector<Iteration> iterations(values.size());
+	std::atomic<size_t> failed(values.size());
+
+	const std::deque<std::string> modulestack = Module::get_stack();
+	const boost::thread::id caller = boost::this_thread::get_id();
+	Parallel::for_range(0, values.size(), [&](size_t begin, size_t end) {
+			if (boost::this_thread::get_id() != caller) {
+				StackCheck::inst()->init();
+				Module::set_stack(modulestack);
+			}
+			in_parallel_for = true;
+			size_t idx_counter = AbstractNode::indexCounter();
+			for (size_t i = begin; i < end && i < failed; i++) {
+				Iteration &iteration = iterations[i];
+				AbstractNode::resetIndexCounter(0);
+				try {
+					PrintCapture::Scope capture(iteration.output);
+					Context::ForkedStack stack(ctx);
+					Context c(ctx);
+					c.set_variable(it_name, values[i]);
+					for_eval(iteration.nodes, inst, 1, &c, evalctx);
+				}
+				catch (...) {
+					iteration.error = std::current_exception();
+					size_t prev = failed;
+					while (i < prev && !failed.compare_exchange_weak(prev, i)) {}
+				}
+				iteration.numindices = AbstractNode::indexCounter();
+			}
+			AbstractNode::resetIndexCounter(idx_counter);
+			in_parallel_for = false;
+		}, grainsize, PlatformUtils::stackLimit() + STACK_BUFFER_SIZE);
+
+	size_t idx_counter = AbstractNode::indexCounter();
+	for (size_t i = 0; i < iterations.size(); i++) {
+		Iteration &iteration = iterations[i];
+		if (i > failed) {
+			for(auto node : iteration.nodes) delete node;
+			continue;
+		}
+		iteration.output.replay();
+		for(auto node : iteration.nodes) node->shiftIndex(idx_counter);
+		idx_counter += iteration.numindices;
+		children.insert(children.end(), iteration.nodes.begin(), iteration.nodes.end());
+	}
+	AbstractNode::resetIndexCounter(idx_counter);
+
+	if (failed < iterations.size()) std::rethrow_exception(iterations[failed].error);
+	return true;
 }
 
 const EvalContext* ControlModule::getLastModuleCtx(const EvalContext *evalctx)
@@ -305,12 +438,12 @@ AbstractNode *ControlModule::instantiate(const Context* /*ctx*/, const ModuleIns
 
 	case FOR:
 		node = new GroupNode(inst);
-		for_eval(*node, *inst, 0, evalctx, evalctx);
+		for_eval(node->children, *inst, 0, evalctx, evalctx);
 		break;
 
 	case INT_FOR:
 		node = new AbstractIntersectionNode(inst);
-		for_eval(*node, *inst, 0, evalctx, evalctx);
+		for_eval(node->children, *inst, 0, evalctx, evalctx);
 		break;
 
 	case IF: {
@@ -38,6 +38,8 @@
 #include <algorithm>
 #include <sstream>
 #include <map>
+#include <set>
+#include <cstring>
 
 #include "value.h"
 #include "boost-utils.h"
@@ -64,6 +66,127 @@ struct Line {
 	Line(int i1 = -1, int i2 = -1) { idx[0] = i1; idx[1] = i2; disabled = false; }
 };
 
+namespace {
+	/*!
+		Splits a DXF file loaded into memory into lines. Lines are trimmed and
+		point into the buffer, so reading a group doesn't allocate.
+		Behaves like std::getline() followed by boost::trim().
+	*/
+	class DxfReader
+	{
+	public:
+		struct Token {
+			const char *begin, *end;
+			std::string str() const { return std::string(begin, end); }
+		};
+
+		DxfReader(const std::string &buf) : pos(buf.data()), end(buf.data() + buf.size()), at_eof(false) { }
+
+		bool eof() const { return at_eof; }
+
+		Token next() {
+			Token t;
+			t.begin = pos;
+			const char *nl = static_cast<const char *>(memchr(pos, '\n', end - pos));
+			if (nl) {
+				t.end = nl;
+				pos = nl + 1;
+			}
+			else {
+				t.end = pos = end;
+				at_eof = true;
+			}
+			while (t.begin < t.end && is_space(*t.begin)) t.begin++;
+			while (t.end > t.begin && is_space(t.end[-1])) t.end--;
+			return t;
+		}
+
+	private:
+		static bool is_space(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+		const char *pos, *end;
+		bool at_eof;
+	};
+
+	bool operator==(const DxfReader::Token &t, const char *s) {
+		size_t len = strlen(s);
+		return size_t(t.end - t.begin) == len && memcmp(t.begin, s, len) == 0;
+	}
+
+	/*!
+		Parses group codes, which are small integers. Anything else is left to
+		boost::lexical_cast so malformed codes are reported as before.
+	*/
+	int parse_int(const DxfReader::Token &t)
+	{
+		const char *p = t.begin;
+		bool negative = p < t.end && *p == '-';
+		if (p < t.end && (*p == '-' || *p == '+')) p++;
+		if (p == t.end || t.end - p > 9) return boost::lexical_cast<int>(t.str());
+		int value = 0;
+		for (; p < t.end; p++) {
+			if (*p < '0' || *p > '9') return boost::lexical_cast<int>(t.str());
+			value = value * 10 + (*p - '0');
+		}
+		return negative ? -value : value;
+	}
+
+	/*!
+		Parses a decimal number. Values with at most 19 significant digits
+		and a small exponent are converted exactly with a single
+		multiplication or division, everything else goes through
+		boost::lexical_cast, which also reports malformed values.
+	*/
+	double parse_double(const DxfReader::Token &t)
+	{
+		static const double powers_of_ten[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+		const char *p = t.begin;
+		bool negative = p < t.end && *p == '-';
+		if (p < t.end && (*p == '-' || *p == '+')) p++;
+
+		uint64_t mantissa = 0;
+		int digits = 0, significant = 0, exponent = 0;
+		bool fraction = false;
+		for (; p < t.end; p++) {
+			if (*p == '.' && !fraction) {
+				fraction = true;
+				continue;
+			}
+			if (*p < '0' || *p > '9') break;
+			digits++;
+			if (mantissa == 0 && *p == '0') {
+				if (fraction) exponent--;
+				continue;
+			}
+			if (++significant > 19) return boost::lexical_cast<double>(t.str());
+			mantissa = mantissa * 10 + (*p - '0');
+			if (fraction) exponent--;
+		}
+		if (digits > 0 && p < t.end && (*p == 'e' || *p == 'E')) {
+			p++;
+			bool negative_exponent = p < t.end && *p == '-';
+			if (p < t.end && (*p == '-' || *p == '+')) p++;
+			if (p == t.end || t.end - p > 4) return boost::lexical_cast<double>(t.str());
+			int e = 0;
+			for (; p < t.end && *p >= '0' && *p <= '9'; p++) e = e * 10 + (*p - '0');
+			exponent += negative_exponent ? -e : e;
+		}
+		if (digits == 0 || p != t.end) return boost::lexical_cast<double>(t.str());
+
+		double value;
+		if (mantissa == 0) value = 0;
+		else if (mantissa > (uint64_t(1) << 53) || exponent < -22 || exponent > 22) {
+			return boost::lexical_cast<double>(t.str());
+		}
+		else if (exponent < 0) value = double(mantissa) / powers_of_ten[-exponent];
+		else value = double(mantissa) * powers_of_ten[exponent];
+		return negative ? -value : value;
+	}
+}
+
 DxfData::DxfData()
 {
 }
@@ -77,13 +200,25 @@ DxfData::DxfData(double fn, double fs, double fa,
 {
 	handle_dep(filename); // Register ourselves as a dependency
 
-	std::ifstream stream(filename.c_str());
+	std::ifstream stream(filename.c_str(), std::ios::binary);
 	if (!stream.good()) {
 		PRINTB("WARNING: Can't open DXF file '%s'.", filename);
 		return;
 	}
-
-	Grid2d< std::vector<int>> grid(GRID_COARSE);
+	// The whole file is read at once and parsed in place
+	std::string buffer;
+	stream.seekg(0, std::ios::end);
+	buffer.resize(std::max(std::streamoff(stream.tellg()), std::streamoff(0)));
+	stream.seekg(0, std::ios::beg);
+	stream.read(&buffer[0], buffer.size());
+	buffer.resize(stream.gcount());
+	stream.close();
+	DxfReader reader(buffer);
+
+	// Grid cells are numbered from 1, cell_lines lists the lines touching each cell
+	Grid2d<int> grid(GRID_COARSE);
+	int num_cells = 0;
+	std::vector<std::pair<int, int>> cell_lines;
 	std::vector<Line> lines;                       // Global lines
 	std::unordered_map< std::string, std::vector<Line>> blockdata; // Lines in blocks
 
@@ -98,10 +233,12 @@ DxfData::DxfData(double fn, double fs, double fa,
 		if (in_entities_section &&                              \
 				!(layername.empty() || layername == layer))         \
 			break;                                                \
-		grid.align(_p1x, _p1y);                                 \
-		grid.align(_p2x, _p2y);                                 \
-		grid.data(_p1x, _p1y).push_back(lines.size());          \
-		grid.data(_p2x, _p2y).push_back(lines.size());          \
+		int &_c1 = grid.align(_p1x, _p1y);                      \
+		if (!_c1) _c1 = ++num_cells;                            \
+		cell_lines.push_back(std::make_pair(_c1, lines.size())); \
+		int &_c2 = grid.align(_p2x, _p2y);                      \
+		if (!_c2) _c2 = ++num_cells;                            \
+		cell_lines.push_back(std::make_pair(_c2, lines.size())); \
 		if (in_entities_section)                                \
 			lines.push_back(                                      \
 				Line(addPoint(_p1x, _p1y), addPoint(_p2x, _p2y)));	\
@@ -129,41 +266,45 @@ DxfData::DxfData(double fn, double fs, double fa,
 	//
 	// Parse DXF file. Will populate this->points, this->dims, lines and blockdata
 	//
-	while (!stream.eof())
+	while (!reader.eof())
 	{
-		std::string id_str, data;
-		std::getline(stream, id_str);
-		boost::trim(id_str);
-		std::getline(stream, data);
-		boost::trim(data);
+		DxfReader::Token id_str = reader.next();
+		DxfReader::Token data = reader.next();
 
 		int id;
     try {
-		  id = boost::lexical_cast<int>(id_str);
+		  id = parse_int(id_str);
     }
     catch (const boost::bad_lexical_cast &blc) {
-			if (!stream.eof()) {
-				PRINTB("WARNING: Illegal ID '%s' in `%s'", id_str % filename);
+			if (!reader.eof()) {
+				PRINTB("WARNING: Illegal ID '%s' in `%s'", id_str.str() % filename);
 			}
 			break;
   	}
     try {
+		// Numeric values are parsed once, before dispatching on the group code
+		double value = 0;
+		if ((id >= 10 && id <= 16) || (id >= 20 && id <= 26) ||
+				id == 40 || id == 41 || id == 42 || id == 50 || id == 51) {
+			value = parse_double(data);
+		}
+
 		if (id >= 10 && id <= 16) {
 			if (in_blocks_section)
-				coords[id-10][0] = boost::lexical_cast<double>(data);
+				coords[id-10][0] = value;
 			else if (id == 11 || id == 12 || id == 16)
-				coords[id-10][0] = boost::lexical_cast<double>(data) * scale;
+				coords[id-10][0] = value * scale;
 			else
-				coords[id-10][0] = (boost::lexical_cast<double>(data) - xorigin) * scale;
+				coords[id-10][0] = (value - xorigin) * scale;
 		}
 
 		if (id >= 20 && id <= 26) {
 			if (in_blocks_section)
-				coords[id-20][1] = boost::lexical_cast<double>(data);
+				coords[id-20][1] = value;
 			else if (id == 21 || id == 22 || id == 26)
-				coords[id-20][1] = boost::lexical_cast<double>(data) * scale;
+				coords[id-20][1] = value * scale;
 			else
-				coords[id-20][1] = (boost::lexical_cast<double>(data) - yorigin) * scale;
+				coords[id-20][1] = (value - yorigin) * scale;
 		}
 
 		switch (id)
@@ -263,17 +404,22 @@ DxfData::DxfData(double fn, double fs, double fa,
 			else if (mode == "INSERT") {
 				// scale is stored in ellipse_start|stop_angle, rotation in arc_start_angle;
 				// due to the parser code not checking entity type
-				int n = blockdata[iddata].size();
+				// Block lines are transformed in place, the block itself isn't copied
+				const std::vector<Line> &block = blockdata[iddata];
+				int n = block.size();
+				double a = arc_start_angle * M_PI / 180.0;
+				double cos_a = cos(a), sin_a = sin(a);
 				for (int i = 0; i < n; i++) {
-					double a = arc_start_angle * M_PI / 180.0;
-					double lx1 = this->points[blockdata[iddata][i].idx[0]][0] * ellipse_start_angle;
-					double ly1 = this->points[blockdata[iddata][i].idx[0]][1] * ellipse_stop_angle;
-					double lx2 = this->points[blockdata[iddata][i].idx[1]][0] * ellipse_start_angle;
-					double ly2 = this->points[blockdata[iddata][i].idx[1]][1] * ellipse_stop_angle;
-					double px1 = (cos(a)*lx1 - sin(a)*ly1) * scale + xverts.at(0);
-					double py1 = (sin(a)*lx1 + cos(a)*ly1) * scale + yverts.at(0);
-					double px2 = (cos(a)*lx2 - sin(a)*ly2) * scale + xverts.at(0);
-					double py2 = (sin(a)*lx2 + cos(a)*ly2) * scale + yverts.at(0);
+					const Vector2d p1 = this->points[block[i].idx[0]];
+					const Vector2d p2 = this->points[block[i].idx[1]];
+					double lx1 = p1[0] * ellipse_start_angle;
+					double ly1 = p1[1] * ellipse_stop_angle;
+					double lx2 = p2[0] * ellipse_start_angle;
+					double ly2 = p2[1] * ellipse_stop_angle;
+					double px1 = (cos_a*lx1 - sin_a*ly1) * scale + xverts.at(0);
+					double py1 = (sin_a*lx1 + cos_a*ly1) * scale + yverts.at(0);
+					double px2 = (cos_a*lx2 - sin_a*ly2) * scale + xverts.at(0);
+					double py2 = (sin_a*lx2 + cos_a*ly2) * scale + yverts.at(0);
 					ADD_LINE(px1, py1, px2, py2);
 				}
 			}
@@ -300,7 +446,7 @@ DxfData::DxfData(double fn, double fs, double fa,
 					(layername.empty() || layername == layer))) {
 				unsupported_entities_list[mode]++;
 			}
-			mode = data;
+			mode.assign(data.begin, data.end);
 			layer.erase();
 			name.erase();
 			iddata.erase();
@@ -317,76 +463,76 @@ DxfData::DxfData(double fn, double fs, double fa,
 			}
 			break;
 		case 1:
-			name = data;
+			name.assign(data.begin, data.end);
 			break;
 		case 2:
-			iddata = data;
+			iddata.assign(data.begin, data.end);
 			break;
 		case 8:
-			layer = data;
+			layer.assign(data.begin, data.end);
 			break;
 		case 10:
 			if (in_blocks_section)
-				xverts.push_back((boost::lexical_cast<double>(data)));
+				xverts.push_back(value);
 			else
-				xverts.push_back((boost::lexical_cast<double>(data) - xorigin) * scale);
+				xverts.push_back((value - xorigin) * scale);
 			break;
 		case 11:
 			if (in_blocks_section)
-				xverts.push_back((boost::lexical_cast<double>(data)));
+				xverts.push_back(value);
 			else
-				xverts.push_back((boost::lexical_cast<double>(data) - xorigin) * scale);
+				xverts.push_back((value - xorigin) * scale);
 			break;
 		case 20:
 			if (in_blocks_section)
-				yverts.push_back((boost::lexical_cast<double>(data)));
+				yverts.push_back(value);
 			else
-				yverts.push_back((boost::lexical_cast<double>(data) - yorigin) * scale);
+				yverts.push_back((value - yorigin) * scale);
 			break;
 		case 21:
 			if (in_blocks_section)
-				yverts.push_back((boost::lexical_cast<double>(data)));
+				yverts.push_back(value);
 			else
-				yverts.push_back((boost::lexical_cast<double>(data) - yorigin) * scale);
+				yverts.push_back((value - yorigin) * scale);
 			break;
 		case 40:
 			// CIRCLE, ARC: radius
 			// ELLIPSE: minor to major ratio
 			// DIMENSION (radial, diameter): Leader length
-			radius = boost::lexical_cast<double>(data);
+			radius = value;
 			if (!in_blocks_section) radius *= scale;
 			break;
 		case 41:
 			// ELLIPSE: start_angle
 			// INSERT: X scale
-			ellipse_start_angle = boost::lexical_cast<double>(data);
+			ellipse_start_angle = value;
 			break;
 		case 50:
 			// ARC: start_angle
 			// INSERT: rot angle
       // DIMENSION: linear and rotated: angle
-			arc_start_angle = boost::lexical_cast<double>(data);
+			arc_start_angle = value;
 			break;
 		case 42:
 			// ELLIPSE: stop_angle
 			// INSERT: Y scale
-			ellipse_stop_angle = boost::lexical_cast<double>(data);
+			ellipse_stop_angle = value;
 			break;
 		case 51: // ARC
-			arc_stop_angle = boost::lexical_cast<double>(data);
+			arc_stop_angle = value;
 			break;
 		case 70:
 			// LWPOLYLINE: polyline flag
 			// DIMENSION: dimension type
-			dimtype = boost::lexical_cast<int>(data);
+			dimtype = parse_int(data);
 			break;
 		}
     }
     catch (boost::bad_lexical_cast &blc) {
-	  	PRINTB("WARNING: Illegal value %s in '%s'", data % filename);
+	  	PRINTB("WARNING: Illegal value %s in '%s'", data.str() % filename);
   	}
     catch (const std::out_of_range& oor) {
-	  	PRINTB("WARNING: not enough input values for %s in '%s'", data % filename);
+	  	PRINTB("WARNING: not enough input values for %s in '%s'", data.str() % filename);
   	}
 	}
 
@@ -402,101 +548,117 @@ DxfData::DxfData(double fn, double fs, double fa,
 
 	// Extract paths from parsed data
 
-	typedef std::map<int, int> LineMap;
-	LineMap enabled_lines;
-	for (size_t i = 0; i < lines.size(); i++) {
-		enabled_lines[i] = i;
+	// Lines by grid cell: the lines of cell c are cell_line[cell_start[c]..cell_start[c+1]),
+	// in the order they were added. The cells of line l are line_cell[line_start[l]..line_start[l+1])
+	int num_lines = lines.size();
+	std::vector<int> cell_start(num_cells + 2, 0), line_start(num_lines + 1, 0);
+	for (const auto &cl : cell_lines) {
+		cell_start[cl.first + 1]++;
+		if (cl.second < num_lines) line_start[cl.second + 1]++;
 	}
-
-	// extract all open paths
-	while (enabled_lines.size() > 0)
+	for (int c = 0; c <= num_cells; c++) cell_start[c + 1] += cell_start[c];
+	for (int l = 0; l < num_lines; l++) line_start[l + 1] += line_start[l];
+	std::vector<int> cell_line(cell_lines.size()), line_cell(line_start[num_lines]);
 	{
-		int current_line, current_point;
-
-		for(const auto &l : enabled_lines) {
-			int idx = l.second;
-			for (int j = 0; j < 2; j++) {
-				std::vector<int> *lv = &grid.data(this->points[lines[idx].idx[j]][0], this->points[lines[idx].idx[j]][1]);
-				for (size_t ki = 0; ki < lv->size(); ki++) {
-					int k = lv->at(ki);
-					if (k == idx || lines[k].disabled)
-						continue;
-					goto next_open_path_j;
-				}
-				current_line = idx;
-				current_point = j;
-				goto create_open_path;
-			next_open_path_j:;
+		std::vector<int> cell_pos(cell_start), line_pos(line_start);
+		for (const auto &cl : cell_lines) {
+			cell_line[cell_pos[cl.first]++] = cl.second;
+			if (cl.second < num_lines) line_cell[line_pos[cl.second]++] = cl.first;
+		}
+	}
+	std::vector<std::pair<int, int>>().swap(cell_lines);
+
+	int num_enabled = num_lines;
+
+	// Returns an end of the line which no other enabled line touches, or -1
+	auto free_end = [&](int idx) {
+		for (int j = 0; j < 2; j++) {
+			const Vector2d &p = this->points[lines[idx].idx[j]];
+			int c = grid.data(p[0], p[1]);
+			bool shared = false;
+			for (int ki = cell_start[c]; ki < cell_start[c + 1]; ki++) {
+				int k = cell_line[ki];
+				if (k == idx || k >= num_lines || lines[k].disabled)
+					continue;
+				shared = true;
+				break;
 			}
+			if (!shared) return j;
 		}
-
-		break;
-
-	create_open_path:
-		this->paths.push_back(Path());
-		Path *this_path = &this->paths.back();
-
+		return -1;
+	};
+
+	// Follows the lines connected to the given end of current_line, disabling them.
+	// Enabled lines before next_line sharing a cell with a disabled line are added to touched
+	std::set<int> recheck;
+	int next_line = 0;
+	auto follow_path = [&](Path *this_path, int current_line, int current_point, std::set<int> *touched) {
 		this_path->indices.push_back(lines[current_line].idx[current_point]);
 		while (1) {
 			this_path->indices.push_back(lines[current_line].idx[!current_point]);
 			const Vector2d &ref_point = this->points[lines[current_line].idx[!current_point]];
 			lines[current_line].disabled = true;
-			enabled_lines.erase(current_line);
-			std::vector<int> *lv = &grid.data(ref_point[0], ref_point[1]);
-			for (size_t ki = 0; ki < lv->size(); ki++) {
-				int k = lv->at(ki);
-				if (lines[k].disabled)
-					continue;
-				if (grid.eq(ref_point[0], ref_point[1], this->points[lines[k].idx[0]][0], this->points[lines[k].idx[0]][1])) {
-					current_line = k;
-					current_point = 0;
-					goto found_next_line_in_open_path;
+			num_enabled--;
+			if (touched) {
+				for (int ci = line_start[current_line]; ci < line_start[current_line + 1]; ci++) {
+					int c = line_cell[ci];
+					for (int ki = cell_start[c]; ki < cell_start[c + 1]; ki++) {
+						int k = cell_line[ki];
+						if (k < next_line && !lines[k].disabled) touched->insert(k);
+					}
 				}
-				if (grid.eq(ref_point[0], ref_point[1], this->points[lines[k].idx[1]][0], this->points[lines[k].idx[1]][1])) {
-					current_line = k;
-					current_point = 1;
-					goto found_next_line_in_open_path;
+			}
+			int c = grid.data(ref_point[0], ref_point[1]);
+			bool found = false;
+			for (int ki = cell_start[c]; ki < cell_start[c + 1] && !found; ki++) {
+				int k = cell_line[ki];
+				if (k >= num_lines || lines[k].disabled)
+					continue;
+				for (int j = 0; j < 2; j++) {
+					if (grid.eq(ref_point[0], ref_point[1], this->points[lines[k].idx[j]][0], this->points[lines[k].idx[j]][1])) {
+						current_line = k;
+						current_point = j;
+						found = true;
+						break;
+					}
 				}
 			}
-			break;
-		found_next_line_in_open_path:;
+			if (!found) break;
+		}
+	};
+
+	// extract all open paths, always starting at the first line with a free end.
+	// Lines before next_line only need to be checked again once a line touching
+	// them has been disabled; those are collected in recheck.
+	while (num_enabled > 0)
+	{
+		int idx;
+		if (!recheck.empty() && *recheck.begin() < next_line) {
+			idx = *recheck.begin();
+			recheck.erase(recheck.begin());
 		}
+		else if (next_line < num_lines) {
+			idx = next_line++;
+		}
+		else break;
+		if (lines[idx].disabled) continue;
+		int current_point = free_end(idx);
+		if (current_point < 0) continue;
+
+		this->paths.push_back(Path());
+		follow_path(&this->paths.back(), idx, current_point, &recheck);
 	}
 
 	// extract all closed paths
-	while (enabled_lines.size() > 0)
+	next_line = 0;
+	while (num_enabled > 0)
 	{
-		int current_line = enabled_lines.begin()->second, current_point = 0;
+		while (lines[next_line].disabled) next_line++;
 
 		this->paths.push_back(Path());
 		Path *this_path = &this->paths.back();
 		this_path->is_closed = true;
-		
-		this_path->indices.push_back(lines[current_line].idx[current_point]);
-		while (1) {
-			this_path->indices.push_back(lines[current_line].idx[!current_point]);
-			const Vector2d &ref_point = this->points[lines[current_line].idx[!current_point]];
-			lines[current_line].disabled = true;
-			enabled_lines.erase(current_line);
-			std::vector<int> *lv = &grid.data(ref_point[0], ref_point[1]);
-			for (size_t ki = 0; ki < lv->size(); ki++) {
-				int k = lv->at(ki);
-				if (lines[k].disabled)
-					continue;
-				if (grid.eq(ref_point[0], ref_point[1], this->points[lines[k].idx[0]][0], this->points[lines[k].idx[0]][1])) {
-					current_line = k;
-					current_point = 0;
-					goto found_next_line_in_closed_path;
-				}
-					if (grid.eq(ref_point[0], ref_point[1], this->points[lines[k].idx[1]][0], this->points[lines[k].idx[1]][1])) {
-					current_line = k;
-					current_point = 1;
-					goto found_next_line_in_closed_path;
-				}
-			}
-			break;
-		found_next_line_in_closed_path:;
-		}
+		follow_path(this_path, next_line, 0, NULL);
 	}
 
 	fixup_path_direction();
@@ -38,8 +38,11 @@
 #include <cstdint>
 
 #include <boost/filesystem.hpp>
+#include <boost/thread/mutex.hpp>
 std::unordered_map<std::string, ValuePtr> dxf_dim_cache;
 std::unordered_map<std::string, ValuePtr> dxf_cross_cache;
+// The caches are shared by all threads evaluating functions
+static boost::mutex dxf_cache_mutex;
 namespace fs = boost::filesystem;
 
 ValuePtr builtin_dxf_dim(const Context *ctx, const EvalContext *evalctx)
@@ -79,6 +82,7 @@ ValuePtr builtin_dxf_dim(const Context *ctx, const EvalContext *evalctx)
 						<< "|" << yorigin <<"|" << scale << "|" << lastwritetime
 						<< "|" << filesize;
 	std::string key = keystream.str();
+	boost::mutex::scoped_lock lock(dxf_cache_mutex);
 	if (dxf_dim_cache.find(key) != dxf_dim_cache.end())
 		return dxf_dim_cache.find(key)->second;
 
@@ -169,6 +173,7 @@ ValuePtr builtin_dxf_cross(const Context *ctx, const EvalContext *evalctx)
 						<< "|" << scale << "|" << lastwritetime
 						<< "|" << filesize;
 	std::string key = keystream.str();
+	boost::mutex::scoped_lock lock(dxf_cache_mutex);
 
 	if (dxf_cross_cache.find(key) != dxf_cross_cache.end()) {
 		return dxf_cross_cache.find(key)->second;
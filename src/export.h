@@ -1,6 +1,8 @@
 #pragma once
 
 #include <iostream>
+#include <string>
+#include <vector>
 #include "Tree.h"
 #include "Camera.h"
 #include "memory.h"
@@ -28,7 +30,19 @@ void export_nef3(const shared_ptr<const Geometry> &geom, std::ostream &output);
 
 // void exportFile(const class Geometry *root_geom, std::ostream &output, FileFormat format);
 
+// A camera and the PNG file its image is exported to
+struct PngView {
+	PngView(const Camera &camera, const std::string &filename) : camera(camera), filename(filename) {}
+	Camera camera;
+	std::string filename;
+};
+
 void export_png(const shared_ptr<const class Geometry> &root_geom, Camera &c, std::ostream &output);
 void export_png(const shared_ptr<const class CGAL_Nef_polyhedron> &root_N, Camera &c, std::ostream &output);
 void export_png_with_opencsg(Tree &tree, Camera &c, std::ostream &output);
 void export_png_with_throwntogether(Tree &tree, Camera &c, std::ostream &output);
+
+// Export several images of the same model, reusing the renderer and the OpenGL context
+void export_png(const shared_ptr<const Geometry> &root_geom, std::vector<PngView> &views);
+void export_png_with_opencsg(Tree &tree, std::vector<PngView> &views);
+void export_png_with_throwntogether(Tree &tree, std::vector<PngView> &views);
@@ -60,11 +60,10 @@ static void append_geometry(const PolySet &ps, IndexedMesh &mesh)
 void append_geometry(const shared_ptr<const Geometry> &geom, IndexedMesh &mesh)
 {
 	if (const CGAL_Nef_polyhedron *N = dynamic_cast<const CGAL_Nef_polyhedron *>(geom.get())) {
-		PolySet ps(3);
-		bool err = CGALUtils::createPolySetFromNefPolyhedron3(*(N->p3), ps);
-		if (err) { PRINT("ERROR: Nef->PolySet failed"); }
+		shared_ptr<const PolySet> ps = CGALUtils::getPolySet(*N);
+		if (!ps) { PRINT("ERROR: Nef->PolySet failed"); }
 		else {
-			append_geometry(ps, mesh);
+			append_geometry(*ps, mesh);
 		}
 	}
 	else if (const PolySet *ps = dynamic_cast<const PolySet *>(geom.get())) {
@@ -1,8 +1,10 @@
 #include "export.h"
 #include "printutils.h"
 #include "OffscreenView.h"
+#include "SoftwareRenderer.h"
 #include "CsgInfo.h"
 #include <stdio.h>
+#include <fstream>
 #include "polyset.h"
 #include "rendersettings.h"
 
@@ -19,26 +21,97 @@ static void setupCamera(Camera &cam, const BoundingBox &bbox)
 	if (cam.viewall) cam.viewAll(bbox);
 }
 
-void export_png(const shared_ptr<const Geometry> &root_geom, Camera &cam, std::ostream &output)
+/*!
+	Writes an image with save() to output or, if output is NULL, to the
+	file of the view.
+*/
+template <typename Save>
+static void save_view(const PngView &view, std::ostream *output, Save save)
+{
+	if (output) {
+		save(*output);
+		return;
+	}
+	std::ofstream fstream(view.filename.c_str(), std::ios::out | std::ios::binary);
+	if (!fstream.is_open()) {
+		PRINTB("Can't open file \"%s\" for export", view.filename);
+		return;
+	}
+	save(fstream);
+}
+
+// The view is created at the size of the first image, and resized for the others
+static OffscreenView *create_view(const std::vector<PngView> &views)
 {
-	PRINTD("export_png geom");
-	OffscreenView *glview;
 	try {
-		glview = new OffscreenView(cam.pixel_width, cam.pixel_height);
+		return new OffscreenView(views[0].camera.pixel_width, views[0].camera.pixel_height);
 	} catch (int error) {
 		fprintf(stderr,"Can't create OpenGL OffscreenView. Code: %i.\n", error);
+		return NULL;
+	}
+}
+
+static bool resize_view(OffscreenView *glview, const Camera &cam)
+{
+	if (glview->cam.pixel_width == cam.pixel_width && glview->cam.pixel_height == cam.pixel_height) return true;
+	if (glview->resize(cam.pixel_width, cam.pixel_height)) return true;
+	PRINTB("Can't resize OpenGL OffscreenView to %dx%d.", cam.pixel_width % cam.pixel_height);
+	return false;
+}
+
+static void export_png_views(const shared_ptr<const Geometry> &root_geom, std::vector<PngView> &views, std::ostream *output = NULL)
+{
+	PRINTD("export_png geom");
+	if (views.empty()) return;
+	if (RenderSettings::inst()->software_rendering) {
+		BoundingBox bbox;
+		if (shared_ptr<const CGAL_Nef_polyhedron> N = dynamic_pointer_cast<const CGAL_Nef_polyhedron>(root_geom)) {
+			if (!N->isEmpty()) {
+				shared_ptr<const PolySet> ps = CGALUtils::getPolySet(*N);
+				if (ps) bbox = ps->getBoundingBox();
+				else PRINT("WARNING: Nef->PolySet failed, using an empty bounding box");
+			}
+		}
+		else if (root_geom) {
+			bbox = root_geom->getBoundingBox();
+		}
+		for (auto &view : views) {
+			setupCamera(view.camera, bbox);
+			SoftwareRenderer renderer(view.camera.pixel_width, view.camera.pixel_height);
+			renderer.setCamera(view.camera);
+			renderer.setColorScheme(RenderSettings::inst()->colorscheme);
+			renderer.renderGeometry(root_geom);
+			save_view(view, output, [&](std::ostream &out) { renderer.save(out); });
+		}
 		return;
 	}
+
+	OffscreenView *glview = create_view(views);
+	if (!glview) return;
 	CGALRenderer cgalRenderer(root_geom);
 
 	BoundingBox bbox = cgalRenderer.getBoundingBox();
-	setupCamera(cam, bbox);
-
-	glview->setCamera(cam);
 	glview->setRenderer(&cgalRenderer);
 	glview->setColorScheme(RenderSettings::inst()->colorscheme);
-	glview->paintGL();
-	glview->save(output);
+	for (auto &view : views) {
+		if (!resize_view(glview, view.camera)) continue;
+		setupCamera(view.camera, bbox);
+		glview->setCamera(view.camera);
+		glview->paintGL();
+		save_view(view, output, [&](std::ostream &out) { glview->save(out); });
+	}
+}
+
+void export_png(const shared_ptr<const Geometry> &root_geom, Camera &cam, std::ostream &output)
+{
+	std::vector<PngView> views(1, PngView(cam, ""));
+	export_png_views(root_geom, views, &output);
+	cam = views[0].camera;
+}
+
+void export_png(const shared_ptr<const Geometry> &root_geom, std::vector<PngView> &views)
+{
+	export_png_views(root_geom, views);
 }
 
 enum Previewer { OPENCSG, THROWNTOGETHER } previewer;
@@ -49,20 +122,34 @@ enum Previewer { OPENCSG, THROWNTOGETHER } previewer;
 #endif
 #include "ThrownTogetherRenderer.h"
 
-void export_png_preview_common(Tree &tree, Camera &cam, std::ostream &output, Previewer previewer = OPENCSG)
+void export_png_preview_common(Tree &tree, std::vector<PngView> &views, std::ostream *output, Previewer previewer = OPENCSG)
 {
 	PRINTD("export_png_preview_common");
+	if (views.empty()) return;
 	CsgInfo csgInfo = CsgInfo();
   csgInfo.compile_products(tree);
 
-	OffscreenView *glview;
-	try {
-		glview = new OffscreenView(cam.pixel_width, cam.pixel_height);
-	} catch (int error) {
-		fprintf(stderr,"Can't create OpenGL OffscreenView. Code: %i.\n", error);
+	if (RenderSettings::inst()->software_rendering) {
+		BoundingBox bbox;
+		if (csgInfo.root_products) bbox = csgInfo.root_products->getBoundingBox();
+		if (csgInfo.highlights_products) bbox.extend(csgInfo.highlights_products->getBoundingBox());
+		// Like OpenCSGRenderer::getBoundingBox(), unlike the thrown together one
+		if (previewer == OPENCSG && csgInfo.background_products) bbox.extend(csgInfo.background_products->getBoundingBox());
+		for (auto &view : views) {
+			setupCamera(view.camera, bbox);
+			SoftwareRenderer renderer(view.camera.pixel_width, view.camera.pixel_height);
+			renderer.setCamera(view.camera);
+			renderer.setColorScheme(RenderSettings::inst()->colorscheme);
+			renderer.renderProducts(csgInfo.root_products.get(), csgInfo.highlights_products.get(),
+															csgInfo.background_products.get(), previewer == OPENCSG);
+			save_view(view, output, [&](std::ostream &out) { renderer.save(out); });
+		}
 		return;
 	}
 
+	OffscreenView *glview = create_view(views);
+	if (!glview) return;
+
 #ifdef ENABLE_OPENCSG
 	OpenCSGRenderer openCSGRenderer(csgInfo.root_products, csgInfo.highlights_products, csgInfo.background_products, glview->shaderinfo);
 #endif
@@ -74,33 +161,56 @@ void export_png_preview_common(Tree &tree, Camera &cam, std::ostream &output, Pr
 	else
 #endif
 		glview->setRenderer(&thrownTogetherRenderer);
-#ifdef ENABLE_OPENCSG
 	BoundingBox bbox = glview->getRenderer()->getBoundingBox();
-	setupCamera(cam, bbox);
-
-	glview->setCamera(cam);
+#ifdef ENABLE_OPENCSG
 	OpenCSG::setContext(0);
 	OpenCSG::setOption(OpenCSG::OffscreenSetting, OpenCSG::FrameBufferObject);
 #endif
 	glview->setColorScheme(RenderSettings::inst()->colorscheme);
-	glview->paintGL();
-	glview->save(output);
+	for (auto &view : views) {
+		if (!resize_view(glview, view.camera)) continue;
+		setupCamera(view.camera, bbox);
+		glview->setCamera(view.camera);
+		glview->paintGL();
+		save_view(view, output, [&](std::ostream &out) { glview->save(out); });
+	}
 }
 
-void export_png_with_opencsg(Tree &tree, Camera &cam, std::ostream &output)
+static void export_png_with_opencsg_views(Tree &tree, std::vector<PngView> &views, std::ostream *output)
 {
 	PRINTD("export_png_w_opencsg");
 #ifdef ENABLE_OPENCSG
-	export_png_preview_common(tree, cam, output, OPENCSG);
+	export_png_preview_common(tree, views, output, OPENCSG);
 #else
-	fprintf(stderr,"This openscad was built without OpenCSG support\n");
+	if (RenderSettings::inst()->software_rendering) export_png_preview_common(tree, views, output, OPENCSG);
+	else fprintf(stderr,"This openscad was built without OpenCSG support\n");
 #endif
 }
 
+void export_png_with_opencsg(Tree &tree, Camera &cam, std::ostream &output)
+{
+	std::vector<PngView> views(1, PngView(cam, ""));
+	export_png_with_opencsg_views(tree, views, &output);
+	cam = views[0].camera;
+}
+
+void export_png_with_opencsg(Tree &tree, std::vector<PngView> &views)
+{
+	export_png_with_opencsg_views(tree, views, NULL);
+}
+
 void export_png_with_throwntogether(Tree &tree, Camera &cam, std::ostream &output)
 {
 	PRINTD("export_png_w_thrown");
-	export_png_preview_common(tree, cam, output, THROWNTOGETHER);
+	std::vector<PngView> views(1, PngView(cam, ""));
+	export_png_preview_common(tree, views, &output, THROWNTOGETHER);
+	cam = views[0].camera;
+}
+
+void export_png_with_throwntogether(Tree &tree, std::vector<PngView> &views)
+{
+	PRINTD("export_png_w_thrown");
+	export_png_preview_common(tree, views, NULL, THROWNTOGETHER);
 }
 
 #endif // ENABLE_CGAL
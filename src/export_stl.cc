@@ -152,11 +152,10 @@ static void append_stl(const CGAL_Nef_polyhedron &root_N, std::ostream &output)
 
 	bool usePolySet = true;
 	if (usePolySet) {
-		PolySet ps(3);
-		bool err = CGALUtils::createPolySetFromNefPolyhedron3(*(root_N.p3), ps);
-		if (err) { PRINT("ERROR: Nef->PolySet failed"); }
+		shared_ptr<const PolySet> ps = CGALUtils::getPolySet(root_N);
+		if (!ps) { PRINT("ERROR: Nef->PolySet failed"); }
 		else {
-			append_stl(ps, output);
+			append_stl(*ps, output);
 		}
 	}
 	else {
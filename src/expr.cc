@@ -30,6 +30,7 @@
 #include <assert.h>
 #include <sstream>
 #include <algorithm>
+#include <limits>
 #include "stl-utils.h"
 #include "printutils.h"
 #include "stackcheck.h"
@@ -39,19 +40,6 @@
 
 // unnamed namespace
 namespace {
-	Value::VectorType flatten(Value::VectorType const& vec) {
-		int n = 0;
-		for (unsigned int i = 0; i < vec.size(); i++) {
-			assert(vec[i]->type() == Value::VECTOR);
-			n += vec[i]->toVector().size();
-		}
-		Value::VectorType ret; ret.reserve(n);
-		for (unsigned int i = 0; i < vec.size(); i++) {
-			std::copy(vec[i]->toVector().begin(),vec[i]->toVector().end(),std::back_inserter(ret));
-		}
-		return ret;
-	}
-
 	void evaluate_sequential_assignment(const AssignmentList &assignment_list, Context *context) {
 		EvalContext ctx(context, assignment_list);
 		ctx.assignTo(*context);
@@ -398,19 +386,12 @@ ExpressionVector::ExpressionVector(Expression *expr) : Expression(expr)
 
 ValuePtr ExpressionVector::evaluate(const Context *context) const
 {
-	Value::VectorType vec;
+	VectorBuilder vec;
+	vec.reserve(this->children.size());
 	for(const auto &e : this->children) {
-		ValuePtr tmpval = e->evaluate(context);
-		if (e->isListComprehension()) {
-			const Value::VectorType result = tmpval->toVector();
-			for (size_t i = 0;i < result.size();i++) {
-				vec.push_back(result[i]);
-			}
-		} else {
-			vec.push_back(tmpval);
-		}
+		ExpressionLc::evaluateBody(e, context, vec);
 	}
-	return ValuePtr(vec);
+	return vec.build();
 }
 
 void ExpressionVector::print(std::ostream &stream) const
@@ -518,29 +499,39 @@ bool ExpressionLc::isListComprehension() const
 	return true;
 }
 
+ValuePtr ExpressionLc::evaluate(const Context *context) const
+{
+	VectorBuilder vec;
+	evaluateElements(context, vec);
+	return vec.build();
+}
+
+/*!
+	Nested comprehensions emit their elements directly into the output of
+	the outermost one, other expressions generate a single element.
+*/
+void ExpressionLc::evaluateBody(const Expression *expr, const Context *context, VectorBuilder &out)
+{
+	if (expr->isListComprehension()) {
+		static_cast<const ExpressionLc *>(expr)->evaluateElements(context, out);
+	} else {
+		out.push_back(expr->evaluate(context));
+	}
+}
+
 ExpressionLcIf::ExpressionLcIf(Expression *cond, Expression *exprIf, Expression *exprElse)
     : ExpressionLc(exprIf, exprElse), cond(cond)
 {
 }
 
-ValuePtr ExpressionLcIf::evaluate(const Context *context) const
+void ExpressionLcIf::evaluateElements(const Context *context, VectorBuilder &out) const
 {
     if (this->second) {
     	ExperimentalFeatureException::check(Feature::ExperimentalElseExpression);
     }
 
     const Expression *expr = this->cond->evaluate(context) ? this->first : this->second;
-
-	Value::VectorType vec;
-    if (expr) {
-        if (expr->isListComprehension()) {
-            return expr->evaluate(context);
-        } else {
-           vec.push_back(expr->evaluate(context));
-        }
-    }
-
-    return ValuePtr(vec);
+    if (expr) evaluateBody(expr, context, out);
 }
 
 void ExpressionLcIf::print(std::ostream &stream) const
@@ -556,37 +547,37 @@ ExpressionLcEach::ExpressionLcEach(Expression *expr)
 {
 }
 
-ValuePtr ExpressionLcEach::evaluate(const Context *context) const
+void ExpressionLcEach::evaluateElements(const Context *context, VectorBuilder &out) const
 {
 	ExperimentalFeatureException::check(Feature::ExperimentalEachExpression);
 
-	Value::VectorType vec;
-
     ValuePtr v = this->first->evaluate(context);
 
     if (v->type() == Value::RANGE) {
         RangeType range = v->toRange();
         uint32_t steps = range.numValues();
-        if (steps >= 1000000) {
+        if (steps == std::numeric_limits<uint32_t>::max()) {
             PRINTB("WARNING: Bad range parameter in for statement: too many elements (%lu).", steps);
         } else {
+            out.reserve(steps);
             for (RangeType::iterator it = range.begin();it != range.end();it++) {
-                vec.push_back(ValuePtr(*it));
+                out.push_back(*it);
             }
         }
     } else if (v->type() == Value::VECTOR) {
-        Value::VectorType vector = v->toVector();
-        for (size_t i = 0; i < v->toVector().size(); i++) {
-            vec.push_back(vector[i]);
+        if (this->first->isListComprehension()) {
+            // each of a comprehension flattens the elements it generated
+            for (const auto &item : v->toVector()) {
+                assert(item->type() == Value::VECTOR);
+                for (const auto &subitem : item->toVector()) out.push_back(subitem);
+            }
+        } else if (const std::vector<double> *numbers = v->toNumbers()) {
+            for (double d : *numbers) out.push_back(d);
+        } else {
+            for (const auto &item : v->toVector()) out.push_back(item);
         }
     } else if (v->type() != Value::UNDEFINED) {
-        vec.push_back(v);
-    }
-
-    if (this->first->isListComprehension()) {
-        return ValuePtr(flatten(vec));
-    } else {
-        return ValuePtr(vec);
+        out.push_back(v);
     }
 }
 
@@ -600,10 +591,8 @@ ExpressionLcFor::ExpressionLcFor(const AssignmentList &arglist, Expression *expr
 {
 }
 
-ValuePtr ExpressionLcFor::evaluate(const Context *context) const
+void ExpressionLcFor::evaluateElements(const Context *context, VectorBuilder &out) const
 {
-	Value::VectorType vec;
-
     EvalContext for_context(context, this->call_arguments);
 
     Context assign_context(context);
@@ -613,32 +602,40 @@ ValuePtr ExpressionLcFor::evaluate(const Context *context) const
     ValuePtr it_values = for_context.getArgValue(0, &assign_context);
 
     Context c(context);
+    // The loop variable is assigned in place, without looking it up again
+    ValuePtr &it_value = c.variable_ref(it_name);
+    bool flat = !this->first->isListComprehension();
 
     if (it_values->type() == Value::RANGE) {
         RangeType range = it_values->toRange();
         uint32_t steps = range.numValues();
-        if (steps >= 1000000) {
+        if (steps == std::numeric_limits<uint32_t>::max()) {
             PRINTB("WARNING: Bad range parameter in for statement: too many elements (%lu).", steps);
         } else {
+            if (flat) out.reserve(steps);
             for (RangeType::iterator it = range.begin();it != range.end();it++) {
-                c.set_variable(it_name, ValuePtr(*it));
-                vec.push_back(this->first->evaluate(&c));
+                it_value = ValuePtr(*it);
+                evaluateBody(this->first, &c, out);
             }
         }
     } else if (it_values->type() == Value::VECTOR) {
-        for (size_t i = 0; i < it_values->toVector().size(); i++) {
-            c.set_variable(it_name, it_values->toVector()[i]);
-            vec.push_back(this->first->evaluate(&c));
+        if (const std::vector<double> *numbers = it_values->toNumbers()) {
+            if (flat) out.reserve(numbers->size());
+            for (double d : *numbers) {
+                it_value = ValuePtr(d);
+                evaluateBody(this->first, &c, out);
+            }
+        } else {
+            const Value::VectorType &vec = it_values->toVector();
+            if (flat) out.reserve(vec.size());
+            for (const auto &item : vec) {
+                it_value = item;
+                evaluateBody(this->first, &c, out);
+            }
         }
     } else if (it_values->type() != Value::UNDEFINED) {
-        c.set_variable(it_name, it_values);
-        vec.push_back(this->first->evaluate(&c));
-    }
-
-    if (this->first->isListComprehension()) {
-        return ValuePtr(flatten(vec));
-    } else {
-        return ValuePtr(vec);
+        it_value = it_values;
+        evaluateBody(this->first, &c, out);
     }
 }
 
@@ -652,18 +649,16 @@ ExpressionLcForC::ExpressionLcForC(const AssignmentList &arglist, const Assignme
 {
 }
 
-ValuePtr ExpressionLcForC::evaluate(const Context *context) const
+void ExpressionLcForC::evaluateElements(const Context *context, VectorBuilder &out) const
 {
 	ExperimentalFeatureException::check(Feature::ExperimentalForCExpression);
 
-	Value::VectorType vec;
-
     Context c(context);
     evaluate_sequential_assignment(this->call_arguments, &c);
 
 	unsigned int counter = 0;
     while (this->first->evaluate(&c)) {
-        vec.push_back(this->second->evaluate(&c));
+        evaluateBody(this->second, &c, out);
 
 		if (counter++ == 1000000) throw RecursionException::create("for loop", "");
 
@@ -671,12 +666,6 @@ ValuePtr ExpressionLcForC::evaluate(const Context *context) const
         evaluate_sequential_assignment(this->incr_arguments, &tmp);
         c.apply_variables(tmp);
     }    
-
-    if (this->second->isListComprehension()) {
-        return ValuePtr(flatten(vec));
-    } else {
-        return ValuePtr(vec);
-    }
 }
 
 void ExpressionLcForC::print(std::ostream &stream) const
@@ -693,11 +682,11 @@ ExpressionLcLet::ExpressionLcLet(const AssignmentList &arglist, Expression *expr
 {
 }
 
-ValuePtr ExpressionLcLet::evaluate(const Context *context) const
+void ExpressionLcLet::evaluateElements(const Context *context, VectorBuilder &out) const
 {
     Context c(context);
     evaluate_sequential_assignment(this->call_arguments, &c);
-    return this->first->evaluate(&c);
+    evaluateBody(this->first, &c, out);
 }
 
 void ExpressionLcLet::print(std::ostream &stream) const
@@ -165,6 +165,7 @@ public:
 
 class ExpressionConst : public Expression
 {
+	friend class ASTCache;
 public:
 	ExpressionConst(const ValuePtr &val);
 	ValuePtr evaluate(const class Context *) const;
@@ -192,6 +193,8 @@ public:
 
 class ExpressionLookup : public Expression
 {
+	friend class ASTCache;
+	friend class PurityAnalyzer;
 public:
 	ExpressionLookup(const std::string &var_name);
 	ValuePtr evaluate(const class Context *context) const;
@@ -202,6 +205,7 @@ private:
 
 class ExpressionMember : public Expression
 {
+	friend class ASTCache;
 public:
 	ExpressionMember(Expression *expr, const std::string &member);
 	ValuePtr evaluate(const class Context *context) const;
@@ -223,6 +227,9 @@ public:
 
 class ExpressionLet : public Expression
 {
+	friend class ASTCache;
+	friend class PurityAnalyzer;
+	friend class FunctionTailRecursion;
 public:
 	ExpressionLet(const AssignmentList &arglist, Expression *expr);
 	ValuePtr evaluate(const class Context *context) const;
@@ -237,13 +244,21 @@ class ExpressionLc : public Expression
 public:
 	ExpressionLc(Expression *expr);
 	ExpressionLc(Expression *expr1, Expression *expr2);
+
+	ValuePtr evaluate(const class Context *context) const;
+	// Appends the elements generated by this comprehension to out
+	virtual void evaluateElements(const class Context *context, VectorBuilder &out) const = 0;
+	// Appends the element(s) generated by a (possibly nested) comprehension body
+	static void evaluateBody(const Expression *expr, const class Context *context, VectorBuilder &out);
 };
 
 class ExpressionLcIf : public ExpressionLc
 {
+	friend class ASTCache;
+	friend class PurityAnalyzer;
 public:
 	ExpressionLcIf(Expression *cond, Expression *exprIf, Expression *exprElse);
-	ValuePtr evaluate(const class Context *context) const;
+	void evaluateElements(const class Context *context, VectorBuilder &out) const;
 	virtual void print(std::ostream &stream) const;
 private:
         Expression *cond;
@@ -251,9 +266,11 @@ private:
 
 class ExpressionLcFor : public ExpressionLc
 {
+	friend class ASTCache;
+	friend class PurityAnalyzer;
 public:
 	ExpressionLcFor(const AssignmentList &arglist, Expression *expr);
-	ValuePtr evaluate(const class Context *context) const;
+	void evaluateElements(const class Context *context, VectorBuilder &out) const;
 	virtual void print(std::ostream &stream) const;
 private:
 	AssignmentList call_arguments;
@@ -261,9 +278,11 @@ private:
 
 class ExpressionLcForC : public ExpressionLc
 {
+	friend class ASTCache;
+	friend class PurityAnalyzer;
 public:
 	ExpressionLcForC(const AssignmentList &arglist, const AssignmentList &incrargs, Expression *cond, Expression *expr);
-	ValuePtr evaluate(const class Context *context) const;
+	void evaluateElements(const class Context *context, VectorBuilder &out) const;
 	virtual void print(std::ostream &stream) const;
 private:
 	AssignmentList call_arguments;
@@ -274,15 +293,17 @@ class ExpressionLcEach : public ExpressionLc
 {
 public:
 	ExpressionLcEach(Expression *expr);
-	ValuePtr evaluate(const class Context *context) const;
+	void evaluateElements(const class Context *context, VectorBuilder &out) const;
 	virtual void print(std::ostream &stream) const;
 };
 
 class ExpressionLcLet : public ExpressionLc
 {
+	friend class ASTCache;
+	friend class PurityAnalyzer;
 public:
 	ExpressionLcLet(const AssignmentList &arglist, Expression *expr);
-	ValuePtr evaluate(const class Context *context) const;
+	void evaluateElements(const class Context *context, VectorBuilder &out) const;
 	virtual void print(std::ostream &stream) const;
 private:
 	AssignmentList call_arguments;
@@ -17,6 +17,7 @@ public:
         static const Feature ExperimentalEachExpression;
         static const Feature ExperimentalElseExpression;
         static const Feature ExperimentalForCExpression;
+        static const Feature ExperimentalParallelFor;
 
 	const std::string& get_name() const;
 	const std::string& get_description() const;
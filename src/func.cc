@@ -30,7 +30,9 @@
 #include "function.h"
 #include "expression.h"
 #include "evalcontext.h"
+#include "modcontext.h"
 #include "builtin.h"
+#include "cache.h"
 #include "stl-utils.h"
 #include "printutils.h"
 #include "stackcheck.h"
@@ -42,6 +44,13 @@
 #include <cmath>
 #include <limits>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <typeinfo>
+#include <unordered_map>
+#include <boost/thread/mutex.hpp>
+#include <boost/functional/hash.hpp>
 
 /*
  Random numbers
@@ -69,6 +78,8 @@ int process_id = getpid();
 
 boost::mt19937 deterministic_rng;
 boost::mt19937 lessdeterministic_rng( std::time(0) + process_id );
+// rands() may be called from several threads
+static boost::mutex rng_mutex;
 
 AbstractFunction::~AbstractFunction()
 {
@@ -88,8 +99,254 @@ std::string AbstractFunction::dump(const std::string &indent, const std::string
 	return dump.str();
 }
 
+/*
+ Memoization
+
+ Functions are memoized if their result only depends on their arguments and
+ the variables they read: They must not read $-variables, and may only call
+ builtins without side effects, themselves, and other such functions defined
+ in the same scope. The memo key contains the arguments and the values of
+ all free variables read by the function and by the functions it calls.
+
+ Small values are part of the key, larger vectors are keyed by identity and
+ kept alive by the memo entry, so recursing over a list stays cheap.
+ All functions share one memo table, bounded by the estimated size in bytes
+ of the keys, the results and the vectors kept alive. Results of
+ evaluations printing any messages aren't stored, so warnings aren't lost.
+*/
+
+// Default size in bytes of the memo table, 0 disables memoization
+static size_t memo_limit = 64*1024*1024;
+// Vectors with more elements than this are keyed by identity
+static const size_t memo_vector_limit = 16;
+
+static std::atomic<unsigned long> memo_hits(0);
+static std::atomic<unsigned long> memo_misses(0);
+static std::atomic<unsigned long> memo_next_id(0);
+
+static const std::set<std::string> impure_builtins = {
+	"rands", "parent_module", "dxf_dim", "dxf_cross"
+};
+
+struct MemoEntry {
+	ValuePtr result;
+	std::vector<ValuePtr> pinned;
+};
+
+static boost::mutex memo_mutex;
+static Cache<std::string, MemoEntry> memo_cache(memo_limit);
+
+struct Function::MemoTable
+{
+	// Ids aren't reused, so entries of deleted functions are never hit
+	MemoTable() : id(memo_next_id++), pure(false) {}
+
+	unsigned long id;
+	std::once_flag analyzed;
+	bool pure;
+	// Free variables of the function, looked up in the call context
+	std::set<std::string> locals;
+	// Free variables of other functions called, looked up in the defining context
+	std::set<std::string> outer;
+};
+
+class PurityAnalyzer
+{
+public:
+	PurityAnalyzer(const Context *ctx) : ctx(ctx), pure(true) {}
+
+	// Collects the free variables of the function body
+	void function(const Function &f, std::set<std::string> &vars) {
+		visited.insert(&f);
+		std::set<std::string> bound;
+		for(const auto &arg : f.definition_arguments) {
+			if (arg.first[0] == '$') pure = false;
+			bound.insert(arg.first);
+		}
+		expression(f.expr, bound, vars);
+	}
+
+	bool isPure() const { return pure; }
+
+	// Free variables of other functions called
+	std::set<std::string> outer;
+
+private:
+	const Context *ctx;
+	bool pure;
+	std::set<const Function *> visited;
+
+	void call(const std::string &name) {
+		const AbstractFunction *f = ctx->findFunction(name);
+		if (dynamic_cast<const BuiltinFunction *>(f)) {
+			if (impure_builtins.count(name)) pure = false;
+			return;
+		}
+		const Function *func = dynamic_cast<const Function *>(f);
+		if (!func) {
+			pure = false;
+			return;
+		}
+		if (visited.count(func)) return;
+
+		// Other functions are evaluated in ctx too if they're defined there
+		const ModuleContext *mc = dynamic_cast<const ModuleContext *>(ctx);
+		if (!mc || !mc->functions_p) {
+			pure = false;
+			return;
+		}
+		auto it = mc->functions_p->find(name);
+		if (it == mc->functions_p->end() || it->second != func) {
+			pure = false;
+			return;
+		}
+		// Default arguments are evaluated in ctx
+		for(const auto &arg : func->definition_arguments) {
+			expression(arg.second.get(), std::set<std::string>(), outer);
+		}
+		function(*func, outer);
+	}
+
+	void assignments(const AssignmentList &args, std::set<std::string> &bound, std::set<std::string> &vars) {
+		for(const auto &arg : args) {
+			expression(arg.second.get(), bound, vars);
+			bound.insert(arg.first);
+		}
+	}
+
+	void expression(const Expression *e, std::set<std::string> bound, std::set<std::string> &vars) {
+		if (!e || !pure) return;
+		const std::type_info &type = typeid(*e);
+		if (type == typeid(ExpressionLookup)) {
+			const std::string &name = static_cast<const ExpressionLookup *>(e)->var_name;
+			if (name[0] == '$') pure = false;
+			else if (!bound.count(name)) vars.insert(name);
+		}
+		else if (type == typeid(ExpressionFunctionCall)) {
+			const ExpressionFunctionCall *fc = static_cast<const ExpressionFunctionCall *>(e);
+			for(const auto &arg : fc->call_arguments) expression(arg.second.get(), bound, vars);
+			call(fc->funcname);
+		}
+		else if (type == typeid(ExpressionLet)) {
+			assignments(static_cast<const ExpressionLet *>(e)->call_arguments, bound, vars);
+			expression(e->first, bound, vars);
+		}
+		else if (type == typeid(ExpressionLcLet)) {
+			assignments(static_cast<const ExpressionLcLet *>(e)->call_arguments, bound, vars);
+			expression(e->first, bound, vars);
+		}
+		else if (type == typeid(ExpressionLcIf)) {
+			expression(static_cast<const ExpressionLcIf *>(e)->cond, bound, vars);
+			expression(e->first, bound, vars);
+			expression(e->second, bound, vars);
+		}
+		else if (type == typeid(ExpressionLcFor)) {
+			for(const auto &arg : static_cast<const ExpressionLcFor *>(e)->call_arguments) {
+				expression(arg.second.get(), bound, vars);
+				bound.insert(arg.first);
+			}
+			expression(e->first, bound, vars);
+		}
+		else if (type == typeid(ExpressionLcForC)) {
+			const ExpressionLcForC *lc = static_cast<const ExpressionLcForC *>(e);
+			assignments(lc->call_arguments, bound, vars);
+			// Variables only assigned by the increment are looked up outside in the first iteration
+			for(const auto &arg : lc->incr_arguments) expression(arg.second.get(), bound, vars);
+			expression(e->first, bound, vars);
+			expression(e->second, bound, vars);
+		}
+		else {
+			for(const auto &child : e->children) expression(child, bound, vars);
+		}
+	}
+};
+
+static void memo_append(std::string &key, const void *data, size_t size)
+{
+	key.append(static_cast<const char *>(data), size);
+}
+
+static void memo_append(std::string &key, double d)
+{
+	memo_append(key, &d, sizeof(d));
+}
+
+static void memo_key_value(std::string &key, const ValuePtr &v, std::vector<ValuePtr> &pinned)
+{
+	switch (v->type()) {
+	case Value::UNDEFINED:
+		key += 'u';
+		break;
+	case Value::BOOL:
+		key += v->toBool() ? 't' : 'f';
+		break;
+	case Value::NUMBER:
+		key += 'd';
+		memo_append(key, v->toDouble());
+		break;
+	case Value::STRING: {
+		const std::string s = v->toString();
+		size_t size = s.size();
+		key += 's';
+		memo_append(key, &size, sizeof(size));
+		key += s;
+		break;
+	}
+	case Value::VECTOR: {
+		const std::vector<double> *numbers = v->toNumbers();
+		size_t size = numbers ? numbers->size() : v->toVector().size();
+		if (size > memo_vector_limit) {
+			const Value *ptr = v.get();
+			key += 'p';
+			memo_append(key, &ptr, sizeof(ptr));
+			pinned.push_back(v);
+		}
+		else {
+			key += 'v';
+			memo_append(key, &size, sizeof(size));
+			if (numbers) {
+				for(double d : *numbers) {
+					key += 'd';
+					memo_append(key, d);
+				}
+			}
+			else {
+				for(const auto &item : v->toVector()) memo_key_value(key, item, pinned);
+			}
+		}
+		break;
+	}
+	case Value::RANGE: {
+		RangeType range = v->toRange();
+		key += 'r';
+		memo_append(key, range.begin_value());
+		memo_append(key, range.step_value());
+		memo_append(key, range.end_value());
+		break;
+	}
+	}
+}
+
+// Estimated size in bytes of the value
+static size_t memo_value_size(const ValuePtr &v)
+{
+	size_t size = sizeof(Value);
+	if (v->type() == Value::STRING) {
+		size += v->toString().size();
+	}
+	else if (v->type() == Value::VECTOR) {
+		if (const std::vector<double> *numbers = v->toNumbers()) {
+			size += numbers->size() * sizeof(double);
+		}
+		else {
+			for(const auto &item : v->toVector()) size += sizeof(ValuePtr) + memo_value_size(item);
+		}
+	}
+	return size;
+}
+
 Function::Function(const char *name, AssignmentList &definition_arguments, Expression *expr)
-	: name(name), definition_arguments(definition_arguments), expr(expr)
+	: name(name), definition_arguments(definition_arguments), expr(expr), memo(new MemoTable)
 {
 }
 
@@ -98,16 +355,90 @@ Function::~Function()
 	delete expr;
 }
 
+/*!
+	Builds the memo key for a call with the arguments set in c. Returns false
+	if the function can't be memoized.
+*/
+bool Function::memoKey(const Context *ctx, const Context &c, std::string &key, std::vector<ValuePtr> &pinned) const
+{
+	std::call_once(memo->analyzed, [this, ctx]() {
+		PurityAnalyzer analyzer(ctx);
+		analyzer.function(*this, memo->locals);
+		memo->outer = analyzer.outer;
+		memo->pure = analyzer.isPure();
+	});
+	if (!memo->pure) return false;
+
+	memo_append(key, &memo->id, sizeof(memo->id));
+	for(const auto &arg : definition_arguments) {
+		memo_key_value(key, c.lookup_variable(arg.first, true), pinned);
+	}
+	for(const auto &name : memo->locals) {
+		memo_key_value(key, c.lookup_variable(name, true), pinned);
+	}
+	for(const auto &name : memo->outer) {
+		memo_key_value(key, ctx->lookup_variable(name, true), pinned);
+	}
+	return true;
+}
+
 ValuePtr Function::evaluate(const Context *ctx, const EvalContext *evalctx) const
 {
 	if (!expr) return ValuePtr::undefined;
 	Context c(ctx);
 	c.setVariables(definition_arguments, evalctx);
-	ValuePtr result = expr->evaluate(&c);
 
+	std::string key;
+	std::vector<ValuePtr> pinned;
+	if (memo_limit == 0 || !memoKey(ctx, c, key, pinned)) return evaluateBody(c);
+
+	{
+		boost::mutex::scoped_lock lock(memo_mutex);
+		const MemoEntry *entry = memo_cache[key];
+		if (entry) {
+			memo_hits++;
+			return entry->result;
+		}
+	}
+	memo_misses++;
+
+	unsigned long messages = print_messages_count;
+	ValuePtr result = evaluateBody(c);
+	if (print_messages_count == messages) {
+		size_t cost = sizeof(MemoEntry) + key.size() + memo_value_size(result);
+		for(const auto &v : pinned) cost += memo_value_size(v);
+		// Results larger than the whole table aren't stored
+		if (cost <= memo_limit) {
+			boost::mutex::scoped_lock lock(memo_mutex);
+			memo_cache.insert(key, new MemoEntry{result, std::move(pinned)}, int(cost));
+		}
+	}
 	return result;
 }
 
+ValuePtr Function::evaluateBody(Context &c) const
+{
+	return expr->evaluate(&c);
+}
+
+void Function::printCacheStats()
+{
+	PRINTB("Function calls memoized: %d hits, %d misses", memo_hits.load() % memo_misses.load());
+	boost::mutex::scoped_lock lock(memo_mutex);
+	PRINTB("Function memo size in bytes: %d", memo_cache.totalCost());
+}
+
+/*!
+	Sets the size in bytes of the memo table shared by all functions. 0
+	disables memoization.
+*/
+void Function::setMemoLimit(size_t limit)
+{
+	boost::mutex::scoped_lock lock(memo_mutex);
+	memo_limit = limit;
+	memo_cache.setMaxCost(int(limit));
+}
+
 std::string Function::dump(const std::string &indent, const std::string &name) const
 {
 	std::stringstream dump;
@@ -122,22 +453,27 @@ std::string Function::dump(const std::string &indent, const std::string &name) c
 	return dump.str();
 }
 
+/*!
+	Function with self calls in tail position, i.e. as the result of the body,
+	of a branch of a ternary operator or of the body of a let() expression in
+	such a position. Tail calls are executed iteratively, reusing the context
+	of the function, so deep recursion needs neither C++ stack nor more than
+	one context.
+*/
 class FunctionTailRecursion : public Function
 {
-private:
-	bool invert;
-	ExpressionFunctionCall *call; // memory owned by the main expression
-	Expression *endexpr; // memory owned by the main expression
-
 public:
-	FunctionTailRecursion(const char *name, AssignmentList &definition_arguments, Expression *expr, ExpressionFunctionCall *call, Expression *endexpr, bool invert);
+	FunctionTailRecursion(const char *name, AssignmentList &definition_arguments, Expression *expr);
 	virtual ~FunctionTailRecursion();
 
-	virtual ValuePtr evaluate(const Context *ctx, const EvalContext *evalctx) const;
+	static bool hasTailCall(const std::string &name, const Expression *expr);
+
+protected:
+	virtual ValuePtr evaluateBody(Context &c) const;
 };
 
-FunctionTailRecursion::FunctionTailRecursion(const char *name, AssignmentList &definition_arguments, Expression *expr, ExpressionFunctionCall *call, Expression *endexpr, bool invert)
-	: Function(name, definition_arguments, expr), invert(invert), call(call), endexpr(endexpr)
+FunctionTailRecursion::FunctionTailRecursion(const char *name, AssignmentList &definition_arguments, Expression *expr)
+	: Function(name, definition_arguments, expr)
 {
 }
 
@@ -145,42 +481,76 @@ FunctionTailRecursion::~FunctionTailRecursion()
 {
 }
 
-ValuePtr FunctionTailRecursion::evaluate(const Context *ctx, const EvalContext *evalctx) const
+bool FunctionTailRecursion::hasTailCall(const std::string &name, const Expression *expr)
 {
-	if (!expr) return ValuePtr::undefined;
+	const std::type_info &type = typeid(*expr);
+	if (type == typeid(ExpressionTernary)) {
+		return hasTailCall(name, expr->second) || hasTailCall(name, expr->third);
+	}
+	if (type == typeid(ExpressionLet)) return hasTailCall(name, expr->first);
+	const ExpressionFunctionCall *call = dynamic_cast<const ExpressionFunctionCall *>(expr);
+	return call && call->funcname == name;
+}
 
-	Context c(ctx);
-	c.setVariables(definition_arguments, evalctx);
+namespace {
+	// Contexts of the let() expressions on the way to a tail position
+	struct LetFrames {
+		std::vector<Context *> contexts;
+
+		~LetFrames() { clear(); }
+		void clear() {
+			// Contexts must be destroyed in reverse order to keep the context stack intact
+			while (!contexts.empty()) {
+				delete contexts.back();
+				contexts.pop_back();
+			}
+		}
+	};
+}
 
-	EvalContext ec(&c, call->call_arguments);
-	Context tmp(&c);
+ValuePtr FunctionTailRecursion::evaluateBody(Context &c) const
+{
+	LetFrames frames;
 	unsigned int counter = 0;
-	while (invert ^ expr->first->evaluate(&c)) {
-		tmp.setVariables(definition_arguments, &ec);
-		c.apply_variables(tmp);
+	while (true) {
+		const Context *current = &c;
+		const Expression *e = expr;
+		while (true) {
+			const std::type_info &type = typeid(*e);
+			if (type == typeid(ExpressionTernary)) {
+				e = e->first->evaluate(current) ? e->second : e->third;
+			}
+			else if (type == typeid(ExpressionLet)) {
+				Context *let = new Context(current);
+				frames.contexts.push_back(let);
+				EvalContext ec(let, static_cast<const ExpressionLet *>(e)->call_arguments);
+				ec.assignTo(*let);
+				current = let;
+				e = e->first;
+			}
+			else break;
+		}
 
-		if (counter++ == 1000000) throw RecursionException::create("function", this->name);
-	}
+		const ExpressionFunctionCall *call = dynamic_cast<const ExpressionFunctionCall *>(e);
+		if (!call || call->funcname != this->name) return e->evaluate(current);
 
-	ValuePtr result = endexpr->evaluate(&c);
+		if (counter++ == 1000000) throw RecursionException::create("function", this->name);
 
-	return result;
+		// Bind the arguments of the tail call and start over in the same context
+		{
+			EvalContext ec(current, call->call_arguments);
+			Context tmp(c.getParent());
+			tmp.setVariables(definition_arguments, &ec);
+			c.replace_variables(tmp);
+		}
+		frames.clear();
+	}
 }
 
 Function * Function::create(const char *name, AssignmentList &definition_arguments, Expression *expr)
 {
-	if (dynamic_cast<ExpressionTernary *>(expr)) {
-		ExpressionFunctionCall *f1 = dynamic_cast<ExpressionFunctionCall *>(expr->second);
-		ExpressionFunctionCall *f2 = dynamic_cast<ExpressionFunctionCall *>(expr->third);
-		if (f1 && !f2) {
-			if (name == f1->funcname) {
-				return new FunctionTailRecursion(name, definition_arguments, expr, f1, expr->third, false);
-			}
-		} else if (f2 && !f1) {
-			if (name == f2->funcname) {
-				return new FunctionTailRecursion(name, definition_arguments, expr, f2, expr->second, true);
-			}
-		}
+	if (expr && FunctionTailRecursion::hasTailCall(name, expr)) {
+		return new FunctionTailRecursion(name, definition_arguments, expr);
 	}
 	return new Function(name, definition_arguments, expr);
 }
@@ -268,13 +638,15 @@ ValuePtr builtin_rands(const Context *, const EvalContext *evalctx)
 		size_t numresults = boost_numeric_cast<size_t,double>( numresultsd );
 
 		bool deterministic = false;
+		uint32_t seed = 0;
 		if (n > 3) {
 			ValuePtr v3 = evalctx->getArgValue(3);
 			if (v3->type() != Value::NUMBER) goto quit;
-			uint32_t seed = static_cast<uint32_t>(hash_floating_point( v3->toDouble() ));
-			deterministic_rng.seed( seed );
+			seed = static_cast<uint32_t>(hash_floating_point( v3->toDouble() ));
 			deterministic = true;
 		}
+		boost::mutex::scoped_lock lock(rng_mutex);
+		if (deterministic) deterministic_rng.seed( seed );
 		Value::VectorType vec;
 		if (min==max) { // Boost doesn't allow min == max
 			for (size_t i=0; i < numresults; i++)
@@ -304,6 +676,14 @@ ValuePtr builtin_min(const Context *, const EvalContext *evalctx)
 	if (n >= 1) {
 		ValuePtr v0 = evalctx->getArgValue(0);
 
+		const std::vector<double> *numbers = v0->toNumbers();
+		if (n == 1 && numbers) {
+			double min = (*numbers)[0];
+			for (size_t i = 1; i < numbers->size(); i++) {
+				if ((*numbers)[i] < min) min = (*numbers)[i];
+			}
+			return ValuePtr(min);
+		}
 		if (n == 1 && v0->type() == Value::VECTOR && !v0->toVector().empty()) {
 			ValuePtr min = v0->toVector()[0];
 			for (size_t i = 1; i < v0->toVector().size(); i++) {
@@ -336,6 +716,14 @@ ValuePtr builtin_max(const Context *, const EvalContext *evalctx)
 	if (n >= 1) {
 		ValuePtr v0 = evalctx->getArgValue(0);
 
+		const std::vector<double> *numbers = v0->toNumbers();
+		if (n == 1 && numbers) {
+			double max = (*numbers)[0];
+			for (size_t i = 1; i < numbers->size(); i++) {
+				if ((*numbers)[i] > max) max = (*numbers)[i];
+			}
+			return ValuePtr(max);
+		}
 		if (n == 1 && v0->type() == Value::VECTOR && !v0->toVector().empty()) {
 			ValuePtr max = v0->toVector()[0];
 			for (size_t i = 1; i < v0->toVector().size(); i++) {
@@ -569,6 +957,7 @@ ValuePtr builtin_length(const Context *, const EvalContext *evalctx)
 {
 	if (evalctx->numArgs() == 1) {
 		ValuePtr v = evalctx->getArgValue(0);
+		if (const std::vector<double> *numbers = v->toNumbers()) return ValuePtr(int(numbers->size()));
 		if (v->type() == Value::VECTOR) return ValuePtr(int(v->toVector().size()));
 		if (v->type() == Value::STRING) {
 			//Unicode glyph count for the length -- rather than the string (num. of bytes) length.
@@ -631,11 +1020,13 @@ ValuePtr builtin_chr(const Context *, const EvalContext *evalctx)
 
 ValuePtr builtin_concat(const Context *, const EvalContext *evalctx)
 {
-	Value::VectorType result;
+	VectorBuilder result;
 
 	for (size_t i = 0; i < evalctx->numArgs(); i++) {
 		ValuePtr val = evalctx->getArgValue(i);
-		if (val->type() == Value::VECTOR) {
+		if (const std::vector<double> *numbers = val->toNumbers()) {
+			for (double d : *numbers) result.push_back(d);
+		} else if (val->type() == Value::VECTOR) {
 			for(const auto &v : val->toVector()) { 
 				result.push_back(v);
 			}
@@ -643,9 +1034,109 @@ ValuePtr builtin_concat(const Context *, const EvalContext *evalctx)
 			result.push_back(val);
 		}
 	}
-	return ValuePtr(result);
+	return result.build();
 }
 
+/*
+ Table indexes
+
+ search() and lookup() are often called many times with the same large
+ table. Values are immutable, so an index built for a table stays valid as
+ long as the same table value is passed again. Tables are identified by
+ address, and a weak pointer makes sure the address wasn't reused by a new
+ value. Indexes are only built on the second use of a table, so tables used
+ once are scanned as before.
+*/
+template <typename Index>
+class TableIndexCache
+{
+public:
+	TableIndexCache() {}
+
+	// Returns the index for a table and column, or NULL if there is none (yet)
+	template <typename Build>
+	shared_ptr<const Index> get(const ValuePtr &table, unsigned int column, Build build) {
+		const std::vector<double> *numbers = table->toNumbers();
+		size_t size = numbers ? numbers->size() : table->toVector().size();
+		if (size < min_size && table->type() != Value::STRING) return shared_ptr<const Index>();
+
+		boost::mutex::scoped_lock lock(this->mutex);
+		Key key(table.get(), column);
+		auto it = this->entries.find(key);
+		if (it != this->entries.end() && !it->second.table.expired()) {
+			Entry &entry = it->second;
+			if (!entry.built) {
+				entry.index = build();
+				entry.built = true;
+			}
+			return entry.index;
+		}
+
+		if (this->entries.size() >= max_entries) prune();
+		Entry &entry = this->entries[key];
+		entry.table = table;
+		entry.index.reset();
+		entry.built = false;
+		return shared_ptr<const Index>();
+	}
+
+private:
+	// Tables smaller than this are always scanned
+	static const size_t min_size = 16;
+	static const size_t max_entries = 64;
+
+	typedef std::pair<const Value *, unsigned int> Key;
+	struct Entry {
+		std::weak_ptr<const Value> table;
+		shared_ptr<const Index> index;
+		bool built;
+	};
+
+	void prune() {
+		for (auto it = this->entries.begin(); it != this->entries.end(); ) {
+			if (it->second.table.expired()) it = this->entries.erase(it);
+			else it++;
+		}
+		if (this->entries.size() >= max_entries) this->entries.clear();
+	}
+
+	boost::mutex mutex;
+	std::unordered_map<Key, Entry, boost::hash<Key>> entries;
+};
+
+// Breakpoints of a lookup() table sorted by position, ties in table order
+class LookupIndex
+{
+public:
+	struct Point {
+		double p, v;
+		size_t idx;
+		bool operator<(const Point &other) const {
+			return p < other.p || (p == other.p && idx < other.idx);
+		}
+	};
+	std::vector<Point> points;
+
+	static shared_ptr<const LookupIndex> build(const Value::VectorType &vec) {
+		shared_ptr<LookupIndex> index = make_shared<LookupIndex>();
+		for (size_t i = 0; i < vec.size(); i++) {
+			Point pt = { 0, 0, i };
+			if (vec[i]->getVec2(pt.p, pt.v)) {
+				// NaN positions are never selected, unless they're the first point
+				if (std::isnan(pt.p)) {
+					if (i == 0) return shared_ptr<const LookupIndex>();
+					continue;
+				}
+				index->points.push_back(pt);
+			}
+		}
+		std::sort(index->points.begin(), index->points.end());
+		return index;
+	}
+};
+
+static TableIndexCache<LookupIndex> lookup_indexes;
+
 ValuePtr builtin_lookup(const Context *, const EvalContext *evalctx)
 {
 	double p, low_p, low_v, high_p, high_v;
@@ -660,7 +1151,27 @@ ValuePtr builtin_lookup(const Context *, const EvalContext *evalctx)
 
 	if (!vec[0]->getVec2(low_p, low_v) || !vec[0]->getVec2(high_p, high_v))
 		return ValuePtr::undefined;
-	for (size_t i = 1; i < vec.size(); i++) {
+
+	shared_ptr<const LookupIndex> index;
+	if (!std::isnan(p)) index = lookup_indexes.get(v1, 0, [&vec]() { return LookupIndex::build(vec); });
+	if (index) {
+		// The greatest position <= p and the smallest one >= p, the first in the table on ties
+		LookupIndex::Point key = { p, 0, 0 };
+		auto high = std::lower_bound(index->points.begin(), index->points.end(), key);
+		if (high != index->points.end()) {
+			high_p = high->p;
+			high_v = high->v;
+		}
+		auto low = std::upper_bound(index->points.begin(), index->points.end(), LookupIndex::Point{ p, 0, vec.size() });
+		if (low != index->points.begin()) {
+			low--;
+			double low_pos = low->p;
+			while (low != index->points.begin() && (low - 1)->p == low_pos) low--;
+			low_p = low->p;
+			low_v = low->v;
+		}
+	}
+	else for (size_t i = 1; i < vec.size(); i++) {
 		double this_p, this_v;
 		if (vec[i]->getVec2(this_p, this_v)) {
 			if (this_p <= p && (this_p > low_p || low_p > p)) {
@@ -731,6 +1242,169 @@ ValuePtr builtin_lookup(const Context *, const EvalContext *evalctx)
 
 */
 
+// Hash consistent with Value::operator==
+static size_t value_hash(const Value &v)
+{
+	size_t seed = v.type();
+	switch (v.type()) {
+	case Value::BOOL:
+		boost::hash_combine(seed, v.toBool());
+		break;
+	case Value::NUMBER: {
+		double d = v.toDouble();
+		boost::hash_combine(seed, d == 0 ? 0.0 : d); // -0 == 0
+		break;
+	}
+	case Value::STRING:
+		boost::hash_combine(seed, v.toString());
+		break;
+	case Value::VECTOR:
+		if (const std::vector<double> *numbers = v.toNumbers()) {
+			for (double d : *numbers) boost::hash_combine(seed, value_hash(Value(d)));
+		}
+		else {
+			for (const auto &item : v.toVector()) boost::hash_combine(seed, value_hash(*item));
+		}
+		break;
+	case Value::RANGE: {
+		RangeType range = v.toRange();
+		boost::hash_combine(seed, range.begin_value());
+		boost::hash_combine(seed, range.step_value());
+		boost::hash_combine(seed, range.end_value());
+		break;
+	}
+	default:
+		break;
+	}
+	return seed;
+}
+
+// Positions of the matches for each value of a search() table column
+class SearchIndex
+{
+public:
+	typedef std::vector<uint32_t> Positions;
+
+	const Positions *find(const ValuePtr &v) const {
+		auto it = this->positions.find(v);
+		return it == this->positions.end() ? NULL : &it->second;
+	}
+
+	static shared_ptr<const SearchIndex> build(const Value::VectorType &table, unsigned int index_col_num) {
+		shared_ptr<SearchIndex> index = make_shared<SearchIndex>();
+		for (size_t j = 0; j < table.size(); j++) {
+			// Column 0 matches both the entry itself and its first element
+			if (index_col_num == 0) index->add(table[j], j);
+			const Value::VectorType &entry = table[j]->toVector();
+			if (index_col_num < entry.size()) index->add(entry[index_col_num], j);
+		}
+		return index;
+	}
+
+private:
+	struct Hash {
+		size_t operator()(const ValuePtr &v) const { return value_hash(*v); }
+	};
+	struct Equal {
+		bool operator()(const ValuePtr &a, const ValuePtr &b) const { return *a == *b; }
+	};
+
+	void add(const ValuePtr &v, uint32_t pos) {
+		// Values containing NaN never match anything
+		if (!(*v == *v)) return;
+		this->positions[v].push_back(pos);
+	}
+
+	std::unordered_map<ValuePtr, Positions, Hash, Equal> positions;
+};
+
+// Positions of the matches for each character searched in a search() table
+class CharIndex
+{
+public:
+	typedef std::vector<uint32_t> Positions;
+
+	const Positions *find(gunichar c) const {
+		auto it = this->positions.find(c);
+		return it == this->positions.end() ? NULL : &it->second;
+	}
+
+	// Characters of a string
+	static shared_ptr<const CharIndex> build(const std::string &table) {
+		shared_ptr<CharIndex> index = make_shared<CharIndex>();
+		uint32_t j = 0;
+		for (const gchar *ptr = table.c_str(); *ptr; ptr = g_utf8_next_char(ptr)) {
+			index->positions[g_utf8_get_char(ptr)].push_back(j++);
+		}
+		return index;
+	}
+
+	// First characters of a column of a vector table
+	static shared_ptr<const CharIndex> build(const Value::VectorType &table, unsigned int index_col_num) {
+		shared_ptr<CharIndex> index = make_shared<CharIndex>();
+		for (size_t j = 0; j < table.size(); j++) {
+			const Value::VectorType &entry = table[j]->toVector();
+			// Invalid entries are reported by the linear search
+			if (entry.size() <= index_col_num) return shared_ptr<const CharIndex>();
+			index->positions[g_utf8_get_char(entry[index_col_num]->toString().c_str())].push_back(j);
+		}
+		return index;
+	}
+
+private:
+	std::unordered_map<gunichar, Positions> positions;
+};
+
+static TableIndexCache<SearchIndex> search_indexes;
+static TableIndexCache<CharIndex> char_indexes;
+
+// Column used for the index of string tables, which have no columns
+static const unsigned int string_table_column = std::numeric_limits<unsigned int>::max();
+
+/*!
+	Adds the matches found in an index like the linear search would: The first
+	one as a number, or a vector of the first num_returns_per_match (0 = all).
+*/
+static unsigned int add_matches(Value::VectorType &returnvec, const std::vector<uint32_t> *positions,
+																unsigned int num_returns_per_match)
+{
+	size_t count = positions ? positions->size() : 0;
+	if (num_returns_per_match > 0) count = std::min(count, size_t(num_returns_per_match));
+	if (num_returns_per_match == 1) {
+		if (count > 0) returnvec.push_back(ValuePtr(double((*positions)[0])));
+	}
+	else {
+		std::vector<double> resultvec(count);
+		for (size_t k = 0; k < count; k++) resultvec[k] = (*positions)[k];
+		returnvec.push_back(ValuePtr(std::move(resultvec)));
+	}
+	return count;
+}
+
+static Value::VectorType search(const std::string &find, const CharIndex &index,
+																unsigned int num_returns_per_match)
+{
+	Value::VectorType returnvec;
+	for (const gchar *ptr_ft = find.c_str(); *ptr_ft; ptr_ft = g_utf8_next_char(ptr_ft)) {
+		add_matches(returnvec, index.find(g_utf8_get_char(ptr_ft)), num_returns_per_match);
+	}
+	return returnvec;
+}
+
+static Value::VectorType search_vector_table(const std::string &find, const CharIndex &index,
+																						 unsigned int num_returns_per_match)
+{
+	Value::VectorType returnvec;
+	for (const gchar *ptr_ft = find.c_str(); *ptr_ft; ptr_ft = g_utf8_next_char(ptr_ft)) {
+		if (add_matches(returnvec, index.find(g_utf8_get_char(ptr_ft)), num_returns_per_match) == 0) {
+			gchar utf8_of_cp[6] = ""; //A buffer for a single unicode character to be copied into
+			g_utf8_strncpy(utf8_of_cp, ptr_ft, 1);
+			PRINTB("  WARNING: search term not found: \"%s\"", utf8_of_cp);
+		}
+	}
+	return returnvec;
+}
+
 static Value::VectorType search(const std::string &find, const std::string &table,
 																unsigned int num_returns_per_match)
 {
@@ -822,7 +1496,30 @@ ValuePtr builtin_search(const Context *, const EvalContext *evalctx)
 
 	Value::VectorType returnvec;
 
-	if (findThis->type() == Value::NUMBER) {
+	shared_ptr<const SearchIndex> index;
+	if (findThis->type() == Value::NUMBER || findThis->type() == Value::VECTOR) {
+		index = search_indexes.get(searchTable, index_col_num, [&searchTable, index_col_num]() {
+				return SearchIndex::build(searchTable->toVector(), index_col_num);
+			});
+	}
+
+	if (index) {
+		if (findThis->type() == Value::NUMBER) {
+			// All matches are returned as one flat list
+			const SearchIndex::Positions *positions = index->find(findThis);
+			size_t count = positions ? positions->size() : 0;
+			if (num_returns_per_match != 0) count = std::min(count, size_t(num_returns_per_match));
+			for (size_t k = 0; k < count; k++) returnvec.push_back(ValuePtr(double((*positions)[k])));
+		}
+		else {
+			for (const auto &find_value : findThis->toVector()) {
+				const SearchIndex::Positions *positions = index->find(find_value);
+				if (add_matches(returnvec, positions, num_returns_per_match) == 0 && num_returns_per_match == 1) {
+					returnvec.push_back(ValuePtr(Value::VectorType()));
+				}
+			}
+		}
+	} else if (findThis->type() == Value::NUMBER) {
 		unsigned int matchCount = 0;
 
 		for (size_t j = 0; j < searchTable->toVector().size(); j++) {
@@ -838,10 +1535,18 @@ ValuePtr builtin_search(const Context *, const EvalContext *evalctx)
 		}
 	} else if (findThis->type() == Value::STRING) {
 		if (searchTable->type() == Value::STRING) {
-			returnvec = search(findThis->toString(), searchTable->toString(), num_returns_per_match);
+			shared_ptr<const CharIndex> index = char_indexes.get(searchTable, string_table_column, [&searchTable]() {
+					return CharIndex::build(searchTable->toString());
+				});
+			if (index) returnvec = search(findThis->toString(), *index, num_returns_per_match);
+			else returnvec = search(findThis->toString(), searchTable->toString(), num_returns_per_match);
 		}
 		else {
-			returnvec = search(findThis->toString(), searchTable->toVector(), num_returns_per_match, index_col_num);
+			shared_ptr<const CharIndex> index = char_indexes.get(searchTable, index_col_num, [&searchTable, index_col_num]() {
+					return CharIndex::build(searchTable->toVector(), index_col_num);
+				});
+			if (index) returnvec = search_vector_table(findThis->toString(), *index, num_returns_per_match);
+			else returnvec = search(findThis->toString(), searchTable->toVector(), num_returns_per_match, index_col_num);
 		}
 	} else if (findThis->type() == Value::VECTOR) {
 		for (size_t i = 0; i < findThis->toVector().size(); i++) {
@@ -937,6 +1642,11 @@ ValuePtr builtin_norm(const Context *, const EvalContext *evalctx)
 {
 	if (evalctx->numArgs() == 1) {
 		 ValuePtr val = evalctx->getArgValue(0);
+		if (const std::vector<double> *numbers = val->toNumbers()) {
+			double sum = 0;
+			for (double x : *numbers) sum += x*x;
+			return ValuePtr(sqrt(sum));
+		}
 		if (val->type() == Value::VECTOR) {
 			double sum = 0;
 			const Value::VectorType &v = val->toVector();
@@ -970,6 +1680,26 @@ ValuePtr builtin_cross(const Context *, const EvalContext *evalctx)
 		return ValuePtr::undefined;
 	}
 	
+	const std::vector<double> *n0 = arg0->toNumbers();
+	const std::vector<double> *n1 = arg1->toNumbers();
+	if (n0 && n1 && n0->size() == 3 && n1->size() == 3) {
+		const std::vector<double> &a = *n0, &b = *n1;
+		for (unsigned int i = 0; i < 3; i++) {
+			if (std::isnan(a[i]) || std::isnan(b[i])) {
+				PRINT("WARNING: Invalid value (NaN) in parameter vector for cross()");
+				return ValuePtr::undefined;
+			}
+			if (std::isinf(a[i]) || std::isinf(b[i])) {
+				PRINT("WARNING: Invalid value (INF) in parameter vector for cross()");
+				return ValuePtr::undefined;
+			}
+		}
+		return ValuePtr(Value(std::vector<double>{
+					a[1] * b[2] - a[2] * b[1],
+					a[2] * b[0] - a[0] * b[2],
+					a[0] * b[1] - a[1] * b[0]}));
+	}
+
 	const Value::VectorType &v0 = arg0->toVector();
 	const Value::VectorType &v1 = arg1->toVector();
 	if ((v0.size() == 2) && (v1.size() == 2)) {
@@ -6,6 +6,7 @@
 
 #include <string>
 #include <vector>
+#include <memory>
 
 class AbstractFunction
 {
@@ -50,4 +51,16 @@ public:
 	virtual std::string dump(const std::string &indent, const std::string &name) const;
         
         static Function * create(const char *name, AssignmentList &definition_arguments, Expression *expr);
+
+	static void printCacheStats();
+	static void setMemoLimit(size_t limit);
+
+protected:
+	virtual ValuePtr evaluateBody(class Context &c) const;
+
+private:
+	struct MemoTable;
+	std::unique_ptr<MemoTable> memo;
+
+	bool memoKey(const Context *ctx, const Context &c, std::string &key, std::vector<ValuePtr> &pinned) const;
 };
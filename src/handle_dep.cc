@@ -1,23 +1,35 @@
 #include "handle_dep.h"
+#include "FileWatcher.h"
 #include <string>
 #include <sstream>
 #include <stdlib.h> // for system()
-#include <unordered_set>
+#include <set>
 #include <boost/regex.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/filesystem.hpp>
 namespace fs = boost::filesystem;
 #include "boosty.h"
 
-std::unordered_set<std::string> dependencies;
+// Sorted, so the deps file doesn't depend on the order of evaluation
+std::set<std::string> dependencies;
 const char *make_command = NULL;
 
-void handle_dep(const std::string &filename)
+// Libraries may be parsed concurrently
+static boost::mutex dep_mutex;
+
+/*!
+	Registers filename as a dependency of the current output. If dependent
+	is given, it's recorded in the FileWatcher dependency graph as well.
+*/
+void handle_dep(const std::string &filename, const std::string &dependent)
 {
 	fs::path filepath(filename);
 	std::string dep;
 	if (boosty::is_absolute(filepath)) dep = filename;
 	else dep = (fs::current_path() / filepath).string();
+	boost::mutex::scoped_lock lock(dep_mutex);
 	dependencies.insert(boost::regex_replace(filename, boost::regex("\\ "), "\\\\ "));
+	if (!dependent.empty()) FileWatcher::instance()->addDependency(filename, dependent);
 
 	if (!fs::exists(filepath) && make_command) {
 		std::stringstream buf;
@@ -26,6 +38,16 @@ void handle_dep(const std::string &filename)
 	}
 }
 
+/*!
+	Forgets the dependencies registered so far, e.g. before the next job of
+	a server.
+*/
+void clear_deps()
+{
+	boost::mutex::scoped_lock lock(dep_mutex);
+	dependencies.clear();
+}
+
 bool write_deps(const std::string &filename, const std::string &output_file)
 {
 	FILE *fp = fopen(filename.c_str(), "wt");
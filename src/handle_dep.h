@@ -3,5 +3,6 @@
 #include <string>
 
 extern const char *make_command;
-void handle_dep(const std::string &filename);
+void handle_dep(const std::string &filename, const std::string &dependent = "");
+void clear_deps();
 bool write_deps(const std::string &filename, const std::string &output_file);
@@ -115,6 +115,8 @@ AbstractNode *ImportModule::instantiate(const Context *ctx, const ModuleInstanti
 	node->fa = c.lookup_variable("$fa")->toDouble();
 
 	node->filename = filename;
+	// Registered here, since the geometry may come from the cache
+	if (!filename.empty()) handle_dep(filename);
 	Value layerval = *c.lookup_variable("layer", true);
 	if (layerval.isUndefined()) {
 		layerval = *c.lookup_variable("layername");
@@ -193,7 +195,6 @@ const Geometry *ImportNode::createGeometry() const
 		PolySet *p = new PolySet(3);
 		g = p;
 
-		handle_dep((std::string)this->filename);
 		// Open file and position at the end
 		std::ifstream f(this->filename.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
 		if (!f.good()) {
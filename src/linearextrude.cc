@@ -30,6 +30,7 @@
 #include "evalcontext.h"
 #include "printutils.h"
 #include "fileutils.h"
+#include "handle_dep.h"
 #include "builtin.h"
 #include "calc.h"
 #include "polyset.h"
@@ -77,6 +78,7 @@ AbstractNode *LinearExtrudeModule::instantiate(const Context *ctx, const ModuleI
 	if (!file->isUndefined() && file->type() == Value::STRING) {
 		printDeprecation("Support for reading files in linear_extrude will be removed in future releases. Use a child import() instead.");
 		node->filename = lookup_file(file->toString(), inst->path(), c.documentPath());
+		if (!node->filename.empty()) handle_dep(node->filename);
 	}
 
 	// if height not given, and first argument is a number,
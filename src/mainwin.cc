@@ -27,6 +27,7 @@
 #include "openscad.h"
 #include "GeometryCache.h"
 #include "ModuleCache.h"
+#include "function.h"
 #include "MainWindow.h"
 #include "OpenSCADApp.h"
 #include "parsersettings.h"
@@ -123,6 +124,7 @@
 
 #include "boosty.h"
 #include "FontCache.h"
+#include "FreetypeRenderer.h"
 #include "transformnode.h"
 
 #undef sprintf
@@ -1165,6 +1167,7 @@ void MainWindow::compileCSG(bool procevents, bool quiet)
 #ifdef ENABLE_CGAL
 		CGALCache::instance()->print();
 #endif
+		Function::printCacheStats();
 		if (procevents) QApplication::processEvents();
 	}
 	catch (const ProgressCancelException &e) {
@@ -1935,6 +1938,7 @@ void MainWindow::actionRenderDone(shared_ptr<const Geometry> root_geom)
 #ifdef ENABLE_CGAL
 		CGALCache::instance()->print();
 #endif
+		Function::printCacheStats();
 
 		int s = this->renderingTime.elapsed() / 1000;
 		PRINTB("Total rendering time: %d hours, %d minutes, %d seconds", (s / (60*60)) % ((s / 60) % 60) % (s % 60));
@@ -2265,6 +2269,7 @@ void MainWindow::actionFlushCaches()
 	dxf_cross_cache.clear();
 	ModuleCache::instance()->clear();
 	FontCache::instance()->clear();
+	FreetypeRenderer::clear_cache();
 }
 
 void MainWindow::viewModeActionsUncheck()
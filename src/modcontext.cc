@@ -134,6 +134,15 @@ ValuePtr ModuleContext::evaluate_function(const std::string &name,
 	return Context::evaluate_function(name, evalctx);
 }
 
+const AbstractFunction *ModuleContext::findFunction(const std::string &name) const
+{
+	if (this->functions_p) {
+		auto it = this->functions_p->find(name);
+		if (it != this->functions_p->end() && it->second->is_enabled()) return it->second;
+	}
+	return Context::findFunction(name);
+}
+
 AbstractNode *ModuleContext::instantiate_module(const ModuleInstantiation &inst, EvalContext *evalctx) const
 {
 	const AbstractModule *foundm = this->findLocalModule(inst.name());
@@ -212,6 +221,24 @@ ValuePtr FileContext::evaluate_function(const std::string &name,
 	return ModuleContext::evaluate_function(name, evalctx);
 }
 
+const AbstractFunction *FileContext::findFunction(const std::string &name) const
+{
+	if (this->functions_p) {
+		auto it = this->functions_p->find(name);
+		if (it != this->functions_p->end() && it->second->is_enabled()) return it->second;
+	}
+
+	for(const auto &m : this->usedlibs) {
+		FileModule *usedmod = ModuleCache::instance()->lookup(m);
+		if (usedmod) {
+			auto it = usedmod->scope.functions.find(name);
+			if (it != usedmod->scope.functions.end()) return it->second;
+		}
+	}
+
+	return ModuleContext::findFunction(name);
+}
+
 AbstractNode *FileContext::instantiate_module(const ModuleInstantiation &inst, EvalContext *evalctx) const
 {
 	const AbstractModule *foundm = this->findLocalModule(inst.name());
@@ -21,6 +21,7 @@ public:
 																										const EvalContext *evalctx) const;
 	virtual AbstractNode *instantiate_module(const ModuleInstantiation &inst, 
 																					 EvalContext *evalctx) const;
+	virtual const AbstractFunction *findFunction(const std::string &name) const;
 
 	const AbstractModule *findLocalModule(const std::string &name) const;
 	const AbstractFunction *findLocalFunction(const std::string &name) const;
@@ -48,6 +49,7 @@ public:
 																		 const EvalContext *evalctx) const;
 	virtual AbstractNode *instantiate_module(const ModuleInstantiation &inst, 
 																					 EvalContext *evalctx) const;
+	virtual const AbstractFunction *findFunction(const std::string &name) const;
 
 private:
 	const FileModule::ModuleContainer &usedlibs;
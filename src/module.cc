@@ -41,8 +41,11 @@
 namespace fs = boost::filesystem;
 #include "boosty.h"
 #include "FontCache.h"
+#include "FileWatcher.h"
+#include "handle_dep.h"
 #include <sstream>
 #include <sys/stat.h>
+#include <boost/thread/mutex.hpp>
 
 AbstractModule::~AbstractModule()
 {
@@ -168,7 +171,7 @@ std::vector<AbstractNode*> IfElseModuleInstantiation::instantiateElseChildren(co
 	return this->else_scope.instantiateChildren(evalctx);
 }
 
-std::deque<std::string> Module::module_stack;
+thread_local std::deque<std::string> Module::module_stack;
 
 Module::~Module()
 {
@@ -232,11 +235,15 @@ FileModule::~FileModule()
 }
 
 void FileModule::registerUse(const std::string path) {
+	uses.push_back(path);
 	std::string extraw = boosty::extension_str(fs::path(path));
 	std::string ext = boost::algorithm::to_lower_copy(extraw);
 	
 	if ((ext == ".otf") || (ext == ".ttf")) {
 		if (fs::is_regular(path)) {
+			// Libraries may be parsed concurrently
+			static boost::mutex font_mutex;
+			boost::mutex::scoped_lock lock(font_mutex);
 			FontCache::instance()->register_font_file(path);
 		} else {
 			PRINTB("ERROR: Can't read font with path '%s'", path);
@@ -252,12 +259,27 @@ void FileModule::registerInclude(const std::string &localpath,
 	struct stat st;
 	memset(&st, 0, sizeof(struct stat));
 	bool valid = stat(fullpath.c_str(), &st) == 0;
-	IncludeFile inc = {fullpath, valid, st.st_mtime};
+	IncludeFile inc = {fullpath, valid, st.st_mtime, FileWatcher::instance()->generation()};
 	this->includes[localpath] = inc;
 }
 
+/*!
+	Registers the files this module includes and uses with handle_dep(), as
+	parsing it did, for when the module is used again from the cache.
+*/
+void FileModule::registerDependencies(const std::string &filename) const
+{
+	for(const auto &item : this->includes) {
+		if (item.second.valid) handle_dep(item.second.filename, filename);
+	}
+	for(const auto &use : this->uses) {
+		if (boosty::is_absolute(fs::path(use))) handle_dep(use, filename);
+	}
+}
+
 bool FileModule::includesChanged() const
 {
+	FileWatcher::instance()->update();
 	for(const auto &item : this->includes) {
 		if (include_modified(item.second)) return true;
 	}
@@ -266,6 +288,9 @@ bool FileModule::includesChanged() const
 
 bool FileModule::include_modified(const IncludeFile &inc) const
 {
+	// Only stat includes the watcher can't vouch for
+	if (inc.valid && !FileWatcher::instance()->changedSince(inc.filename, inc.generation)) return false;
+
 	struct stat st;
 	memset(&st, 0, sizeof(struct stat));
 
@@ -285,47 +310,72 @@ bool FileModule::include_modified(const IncludeFile &inc) const
 bool FileModule::handleDependencies()
 {
 	if (this->is_handling_dependencies) return false;
+
+	// Without changes reported by the watcher, there's nothing to check
+	FileWatcher *watcher = FileWatcher::instance();
+	unsigned long generation = watcher->update();
+	if (this->dependencies_generation) {
+		bool changed = false;
+		for (const auto &filename : this->usedlibs) {
+			if (watcher->changedSince(filename, this->dependencies_generation)) {
+				changed = true;
+				break;
+			}
+		}
+		if (!changed) return false;
+	}
+
 	this->is_handling_dependencies = true;
 
 	bool somethingchanged = false;
+	bool resolved = true;
 	std::vector<std::pair<std::string,std::string>> updates;
+	std::vector<std::string> filenames;
+	std::vector<bool> wasmissing;
 
 	// If a lib in usedlibs was previously missing, we need to relocate it
 	// by searching the applicable paths. We can identify a previously missing module
 	// as it will have a relative path.
 	for(auto filename : this->usedlibs) {
-
-		bool wasmissing = false;
-		bool found = true;
-
 		// Get an absolute filename for the module
 		if (!boosty::is_absolute(filename)) {
-			wasmissing = true;
 			fs::path fullpath = find_valid_path(this->path, filename);
-			if (!fullpath.empty()) {
-				updates.push_back(std::make_pair(filename, boosty::stringy(fullpath)));
-				filename = boosty::stringy(fullpath);
-			}
-			else {
-				found = false;
+			if (fullpath.empty()) {
+				resolved = false;
+				continue;
 			}
+			updates.push_back(std::make_pair(filename, boosty::stringy(fullpath)));
+			filenames.push_back(boosty::stringy(fullpath));
+			wasmissing.push_back(true);
+		}
+		else {
+			filenames.push_back(filename);
+			wasmissing.push_back(false);
 		}
+	}
 
-		if (found) {
-			bool wascached = ModuleCache::instance()->isCached(filename);
-			FileModule *oldmodule = ModuleCache::instance()->lookup(filename);
-			FileModule *newmodule;
-			bool changed = ModuleCache::instance()->evaluate(filename, newmodule);
-			// Detect appearance but not removal of files, and keep old module
-			// on compile errors (FIXME: Is this correct behavior?)
-			if (changed) {
-				PRINTDB("  %s: %p -> %p", filename % oldmodule % newmodule);
-			}
-			somethingchanged |= changed;
-			// Only print warning if we're not part of an automatic reload
-			if (!newmodule && !wascached && !wasmissing) {
-				PRINTB_NOCACHE("WARNING: Failed to compile library '%s'.", filename);
-			}
+	// Parse the libraries needing compilation concurrently; evaluate() below
+	// picks up the results in order.
+	ModuleCache::instance()->prepare(filenames);
+
+	for (size_t i = 0; i < filenames.size(); i++) {
+		const std::string &filename = filenames[i];
+		bool wascached = ModuleCache::instance()->isCached(filename);
+		FileModule *oldmodule = ModuleCache::instance()->lookup(filename);
+		FileModule *newmodule = NULL;
+		bool changed = ModuleCache::instance()->evaluate(filename, newmodule);
+		if (newmodule && !newmodule->isHandlingDependencies() && !newmodule->dependenciesResolved()) {
+			resolved = false;
+		}
+		// Detect appearance but not removal of files, and keep old module
+		// on compile errors (FIXME: Is this correct behavior?)
+		if (changed) {
+			PRINTDB("  %s: %p -> %p", filename % oldmodule % newmodule);
+		}
+		somethingchanged |= changed;
+		// Only print warning if we're not part of an automatic reload
+		if (!newmodule && !wascached && !wasmissing[i]) {
+			PRINTB_NOCACHE("WARNING: Failed to compile library '%s'.", filename);
 		}
 	}
 
@@ -335,6 +385,8 @@ bool FileModule::handleDependencies()
 		this->usedlibs.erase(files.first);
 		this->usedlibs.insert(files.second);
 	}
+	// Missing libraries can only be noticed by searching for them again
+	this->dependencies_generation = resolved ? generation : 0;
 	this->is_handling_dependencies = false;
 	return somethingchanged;
 }
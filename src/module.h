@@ -114,21 +114,25 @@ public:
 	virtual std::string dump(const std::string &indent, const std::string &name) const;
 	static const std::string& stack_element(int n) { return module_stack[n]; };
 	static int stack_size() { return module_stack.size(); };
+	// The stack is per thread; threads instantiating on behalf of another one start with a copy
+	static const std::deque<std::string> &get_stack() { return module_stack; }
+	static void set_stack(const std::deque<std::string> &stack) { module_stack = stack; }
 
 	AssignmentList definition_arguments;
 
 	LocalScope scope;
 
 private:
-	static std::deque<std::string> module_stack;
+	static thread_local std::deque<std::string> module_stack;
 };
 
 // FIXME: A FileModule doesn't have definition arguments, so we shouldn't really
 // inherit from a Module
 class FileModule : public Module
 {
+	friend class ASTCache;
 public:
-	FileModule() : context(NULL), is_handling_dependencies(false) {}
+	FileModule() : context(NULL), is_handling_dependencies(false), dependencies_generation(0) {}
 	virtual ~FileModule();
 
 	void setModulePath(const std::string &path) { this->path = path; }
@@ -136,11 +140,13 @@ public:
         void registerUse(const std::string path);
 	void registerInclude(const std::string &localpath, const std::string &fullpath);
 	bool includesChanged() const;
+	void registerDependencies(const std::string &filename) const;
 	bool handleDependencies();
 	virtual AbstractNode *instantiate(const Context *ctx, const ModuleInstantiation *inst, EvalContext *evalctx = NULL);
 	bool hasIncludes() const { return !this->includes.empty(); }
 	bool usesLibraries() const { return !this->usedlibs.empty(); }
 	bool isHandlingDependencies() const { return this->is_handling_dependencies; }
+	bool dependenciesResolved() const { return this->dependencies_generation != 0; }
         ValuePtr lookup_variable(const std::string &name) const;
 
 	typedef std::unordered_set<std::string> ModuleContainer;
@@ -152,12 +158,17 @@ private:
 		std::string filename;
 		bool valid;
 		time_t mtime;
+		unsigned long generation;
 	};
 
 	bool include_modified(const IncludeFile &inc) const;
 
 	typedef std::unordered_map<std::string, struct IncludeFile> IncludeContainer;
 	IncludeContainer includes;
+	// All used files in order, including fonts
+	std::vector<std::string> uses;
 	bool is_handling_dependencies;
+	// FileWatcher generation of the last complete dependency check, or 0
+	unsigned long dependencies_generation;
 	std::string path;
 };
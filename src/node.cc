@@ -33,7 +33,7 @@
 #include <iostream>
 #include <algorithm>
 
-size_t AbstractNode::idx_counter;
+thread_local size_t AbstractNode::idx_counter;
 
 AbstractNode::AbstractNode(const ModuleInstantiation *mi)
 {
@@ -46,6 +46,15 @@ AbstractNode::~AbstractNode()
 	std::for_each(this->children.begin(), this->children.end(), del_fun<AbstractNode>());
 }
 
+/*!
+	Adds offset to the index of this node and all its descendants.
+*/
+void AbstractNode::shiftIndex(size_t offset)
+{
+	this->idx += offset;
+	for(auto child : this->children) child->shiftIndex(offset);
+}
+
 Response AbstractNode::accept(class State &state, Visitor &visitor) const
 {
 	return visitor.visit(state, *this);
@@ -24,7 +24,9 @@ class AbstractNode
 	// We can hash on pointer value or smth. else.
   //  -> remove and
 	// use smth. else to display node identifier in CSG tree output?
-	static size_t idx_counter;   // Node instantiation index
+	// Node instantiation index. Threads instantiating parts of a tree number
+	// their nodes separately, and the parts are moved into place with shiftIndex().
+	static thread_local size_t idx_counter;
 public:
 	AbstractNode(const class ModuleInstantiation *mi);
 	virtual ~AbstractNode();
@@ -40,7 +42,9 @@ public:
 	}
 	size_t index() const { return this->idx; }
 
-	static void resetIndexCounter() { idx_counter = 1; }
+	static void resetIndexCounter(size_t start = 1) { idx_counter = start; }
+	static size_t indexCounter() { return idx_counter; }
+	void shiftIndex(size_t offset);
 
 	// FIXME: Make protected
 	std::vector<AbstractNode*> children;
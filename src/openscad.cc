@@ -42,8 +42,12 @@
 #include "stackcheck.h"
 #include "CocoaUtils.h"
 #include "FontCache.h"
+#include "ASTCache.h"
+#include "GeometryCache.h"
+#include "function.h"
 #include "OffscreenView.h"
 #include "GeometryEvaluator.h"
+#include "parallel.h"
 #ifdef OPENVR
 #include "openvr.h"
 #endif
@@ -51,11 +55,14 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include <memory>
+#include <set>
 
 #ifdef ENABLE_CGAL
 #undef foreach
 #include "CGAL_Nef_polyhedron.h"
 #include "cgalutils.h"
+#include "CGALCache.h"
 #endif
 
 #include "csgnode.h"
@@ -67,6 +74,7 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/program_options.hpp>
+#include <boost/property_tree/json_parser.hpp>
 #include <boost/filesystem.hpp>
 #include "boosty.h"
 
@@ -81,6 +89,16 @@
 #define snprintf _snprintf
 #endif
 
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
 #include <GL/glut.h>
 
 namespace po = boost::program_options;
@@ -97,6 +115,11 @@ std::string currentdir;
 static bool arg_info = false;
 static std::string arg_colorscheme;
 static bool enable_vr = false;
+static bool arg_cache_stats = false;
+static bool arg_server = false;
+static std::string arg_server_socket;
+static vector<PngView> arg_views;
+static std::string arg_sweep;
 
 #define QUOTE(x__) # x__
 #define QUOTED(x__) QUOTE(x__)
@@ -122,7 +145,8 @@ std::string openscad_detailedversionnumber =
 class Echostream : public std::ofstream
 {
 public:
-	Echostream( const char * filename ) : std::ofstream( filename ) {
+	Echostream( const char * filename ) : std::ofstream( filename ),
+		prevhandler( outputhandler ), prevdata( outputhandler_data ) {
 		set_output_handler( &Echostream::output, this );
 	}
 	static void output( const std::string &msg, void *userdata ) {
@@ -130,8 +154,12 @@ public:
 		*thisp << msg << "\n";
 	}
 	~Echostream() {
+		set_output_handler( prevhandler, prevdata );
 		this->close();
 	}
+private:
+	OutputHandlerFunc *prevhandler;
+	void *prevdata;
 };
 
 static void help(const char *progname, bool failure = false)
@@ -143,7 +171,7 @@ static void help(const char *progname, bool failure = false)
   for (int i=0;i<tablen;i++) tabstr[i] = ' ';
   tabstr[tablen] = '\0';
 
-	PRINTB("Usage: %1% [ -o output_file [ -d deps_file ] ]\\\n"
+	PRINTB("Usage: %1% [ -o output_file [ -o .. ] [ -d deps_file ] ]\\\n"
          "%2%[ -m make_command ] [ -D var=val [..] ] \\\n"
 	 "%2%[ --help ] print this help message and exit \\\n"
          "%2%[ --version ] [ --info ] \\\n"
@@ -153,8 +181,12 @@ static void help(const char *progname, bool failure = false)
          "%2%[ --viewall ] \\\n"
          "%2%[ --imgsize=width,height ] [ --projection=(o)rtho|(p)ersp] \\\n"
          "%2%[ --render | --preview[=throwntogether] ] \\\n"
+         "%2%[ --render-backend=opengl|software ] [ --views=file.json ] \\\n"
+         "%2%[ --sweep=file.csv|file.json ] \\\n"
          "%2%[ --colorscheme=[Cornfield|Sunset|Metallic|Starnight|BeforeDawn|Nature|DeepOcean] ] \\\n"
-         "%2%[ --csglimit=num ]"
+         "%2%[ --csglimit=num ] [ --ast-cache=directory ] [ --font-cache=file ] [ --cache-stats ] \\\n"
+         "%2%[ --memo-limit=bytes ] \\\n"
+         "%2%[ --server[=socket] ]"
 #ifdef ENABLE_EXPERIMENTAL
          " [ --enable=<feature> ]"
 #endif
@@ -210,83 +242,163 @@ void localization_init() {
 	}
 }
 
-Camera get_camera(po::variables_map vm)
+// Sets up the camera from --camera parameters
+static bool setup_camera(Camera &camera, const string &params)
 {
-	Camera camera;
-
-	if (vm.count("camera")) {
-		vector<string> strs;
-		vector<double> cam_parameters;
-		split(strs, vm["camera"].as<string>(), is_any_of(","));
-		if ( strs.size()==6 || strs.size()==7 ) {
-			try {
-				for(const auto &s : strs) cam_parameters.push_back(lexical_cast<double>(s));
-				camera.setup(cam_parameters);
-			}
-			catch (bad_lexical_cast &) {
-				PRINT("Camera setup requires numbers as parameters");
-			}
-		} else {
-			PRINT("Camera setup requires either 7 numbers for Gimbal Camera");
-			PRINT("or 6 numbers for Vector Camera");
-			exit(1);
-		}
+	vector<string> strs;
+	vector<double> cam_parameters;
+	split(strs, params, is_any_of(","));
+	if (strs.size() != 6 && strs.size() != 7) {
+		PRINT("Camera setup requires either 7 numbers for Gimbal Camera");
+		PRINT("or 6 numbers for Vector Camera");
+		return false;
+	}
+	try {
+		for(const auto &s : strs) cam_parameters.push_back(lexical_cast<double>(s));
+		camera.setup(cam_parameters);
+	}
+	catch (bad_lexical_cast &) {
+		PRINT("Camera setup requires numbers as parameters");
+		return false;
 	}
-
 	if (camera.type == Camera::GIMBAL) {
 		camera.gimbalDefaultTranslate();
 	}
+	return true;
+}
+
+static bool setup_projection(Camera &camera, const string &proj)
+{
+	if (proj=="o" || proj=="ortho" || proj=="orthogonal")
+		camera.projection = Camera::ORTHOGONAL;
+	else if (proj=="p" || proj=="perspective")
+		camera.projection = Camera::PERSPECTIVE;
+	else {
+		PRINT("projection needs to be 'o' or 'p' for ortho or perspective\n");
+		return false;
+	}
+	return true;
+}
+
+static bool setup_imgsize(Camera &camera, const string &imgsize)
+{
+	vector<string> strs;
+	split(strs, imgsize, is_any_of(","));
+	try {
+		if (strs.size() != 2) throw bad_lexical_cast();
+		camera.pixel_width = lexical_cast<int>(strs[0]);
+		camera.pixel_height = lexical_cast<int>(strs[1]);
+	}
+	catch (bad_lexical_cast &) {
+		PRINT("Need 2 numbers for imgsize");
+		return false;
+	}
+	return true;
+}
+
+Camera get_camera(po::variables_map vm)
+{
+	Camera camera;
+	camera.pixel_width = RenderSettings::inst()->img_width;
+	camera.pixel_height = RenderSettings::inst()->img_height;
 
+	if (vm.count("camera") && !setup_camera(camera, vm["camera"].as<string>())) exit(1);
 	if (vm.count("viewall")) {
 		camera.viewall = true;
 	}
-
 	if (vm.count("autocenter")) {
 		camera.autocenter = true;
 	}
+	if (vm.count("projection") && !setup_projection(camera, vm["projection"].as<string>())) exit(1);
+	if (vm.count("imgsize") && !setup_imgsize(camera, vm["imgsize"].as<string>())) exit(1);
 
-	if (vm.count("projection")) {
-		string proj = vm["projection"].as<string>();
-		if (proj=="o" || proj=="ortho" || proj=="orthogonal")
-			camera.projection = Camera::ORTHOGONAL;
-		else if (proj=="p" || proj=="perspective")
-			camera.projection = Camera::PERSPECTIVE;
-		else {
-			PRINT("projection needs to be 'o' or 'p' for ortho or perspective\n");
-			exit(1);
-		}
+	return camera;
+}
+
+// Turns the camera around the z axis through the center of the view
+static void rotate_camera(Camera &camera, double angle)
+{
+	if (camera.type == Camera::NONE) {
+		// Same view direction as Camera::viewAll() picks
+		camera.type = Camera::VECTOR;
+		camera.center = Vector3d(0, 0, 0);
+		camera.eye = -Vector3d(1, 1, -0.5);
+		camera.viewall = camera.autocenter = true;
+	}
+	if (camera.type == Camera::GIMBAL) {
+		camera.object_rot.z() += angle;
 	}
+	else {
+		camera.eye = camera.center + Eigen::AngleAxisd(angle * M_PI / 180, Vector3d::UnitZ()) * (camera.eye - camera.center);
+	}
+}
 
-	int w = RenderSettings::inst()->img_width;
-	int h = RenderSettings::inst()->img_height;
-	if (vm.count("imgsize")) {
-		vector<string> strs;
-		split(strs, vm["imgsize"].as<string>(), is_any_of(","));
-		if ( strs.size() != 2 ) {
-			PRINT("Need 2 numbers for imgsize");
-			exit(1);
-		} else {
-			try {
-				w = lexical_cast<int>(strs[0]);
-				h = lexical_cast<int>(strs[1]);
+/*!
+	Reads the images to export with --views from a JSON file like
+
+	  { "views": [
+	      { "file": "front.png", "camera": "0,0,0,90,0,0,200", "projection": "o" },
+	      { "file": "turntable%03d.png", "imgsize": "256,256", "frames": 36 }
+	  ] }
+
+	Settings a view doesn't give are taken from the command line. A view
+	with frames is rendered that many times while the camera turns around
+	the z axis, and its file name is a format string for the frame number.
+*/
+static bool read_views(const string &filename, const Camera &defaults, vector<PngView> &views)
+{
+	namespace pt = boost::property_tree;
+	pt::ptree spec;
+	try {
+		pt::read_json(filename, spec);
+		for(const auto &v : spec.get_child("views")) {
+			const pt::ptree &view = v.second;
+			// Lists can be given as JSON arrays or as comma separated strings
+			auto get_list = [&view](const string &key) {
+				string list = view.get<string>(key);
+				for(const auto &item : view.get_child(key)) {
+					if (!list.empty()) list += ",";
+					list += item.second.get_value<string>();
+				}
+				return list;
+			};
+			Camera camera = defaults;
+			if (view.count("camera") && !setup_camera(camera, get_list("camera"))) return false;
+			camera.viewall = view.get("viewall", camera.viewall);
+			camera.autocenter = view.get("autocenter", camera.autocenter);
+			if (view.count("projection") && !setup_projection(camera, view.get<string>("projection"))) return false;
+			if (view.count("imgsize") && !setup_imgsize(camera, get_list("imgsize"))) return false;
+
+			string file = view.get<string>("file");
+			int frames = view.get("frames", 0);
+			if (frames <= 0) {
+				views.push_back(PngView(camera, file));
+				continue;
+			}
+			boost::format frame_file(file);
+			if (frame_file.expected_args() != 1) {
+				PRINTB("Can't read views from '%s': The file name '%s' of a view with frames needs one format directive for the frame number, like %%03d", filename % file);
+				return false;
 			}
-			catch (bad_lexical_cast &) {
-				PRINT("Need 2 numbers for imgsize");
+			for (int i = 0; i < frames; i++) {
+				PngView frame(camera, (boost::format(frame_file) % i).str());
+				rotate_camera(frame.camera, 360.0 * i / frames);
+				views.push_back(frame);
 			}
 		}
 	}
-	camera.pixel_width = w;
-	camera.pixel_height = h;
-
-	return camera;
+	catch (const std::exception &e) {
+		PRINTB("Can't read views from '%s': %s", filename % e.what());
+		return false;
+	}
+	return true;
 }
 
 #ifndef OPENSCAD_NOGUI
 #include <QSettings>
 #define OPENSCAD_QTGUI 1
 #endif
-static bool checkAndExport(shared_ptr<const Geometry> root_geom, unsigned nd,
-	enum FileFormat format, const char *filename)
+static bool checkExport(shared_ptr<const Geometry> root_geom, unsigned nd)
 {
 	if (root_geom->getDimension() != nd) {
 		PRINTB("Current top level object is not a %dD object.", nd);
@@ -296,7 +408,6 @@ static bool checkAndExport(shared_ptr<const Geometry> root_geom, unsigned nd,
 		PRINT("Current top level object is empty.");
 		return false;
 	}
-	exportFileByName(root_geom, format, filename, filename);
 	return true;
 }
 
@@ -324,140 +435,225 @@ void set_render_color_scheme(const std::string color_scheme, const bool exit_if_
 
 #include <QCoreApplication>
 
-int cmdline(const char *deps_output_file, const std::string &filename, Camera &camera, const char *output_file, const fs::path &original_path, Render::type renderer, int argc, char ** argv )
+/*!
+	The output files of an export, by format
+*/
+struct OutputFiles
 {
-#ifdef OPENSCAD_QTGUI
-	QCoreApplication app(argc, argv);
-	const std::string application_path = QCoreApplication::instance()->applicationDirPath().toLocal8Bit().constData();
-#else
-	const std::string application_path = boosty::stringy(boosty::absolute(boost::filesystem::path(argv[0]).parent_path()));
-#endif	
-	PlatformUtils::registerApplicationPath(application_path);
-	parser_init();
-	localization_init();
+	const char *stl = NULL;
+	const char *off = NULL;
+	const char *amf = NULL;
+	const char *dxf = NULL;
+	const char *svg = NULL;
+	const char *csg = NULL;
+	const char *png = NULL;
+	const char *ast = NULL;
+	const char *term = NULL;
+	const char *echo = NULL;
+	const char *nefdbg = NULL;
+	const char *nef3 = NULL;
+};
 
-	Tree tree;
-#ifdef ENABLE_CGAL
-	GeometryEvaluator geomevaluator(tree);
-#endif
-	if (arg_info) {
-	    info();
-	}
-	
-	const char *stl_output_file = NULL;
-	const char *off_output_file = NULL;
-	const char *amf_output_file = NULL;
-	const char *dxf_output_file = NULL;
-	const char *svg_output_file = NULL;
-	const char *csg_output_file = NULL;
-	const char *png_output_file = NULL;
-	const char *ast_output_file = NULL;
-	const char *term_output_file = NULL;
-	const char *echo_output_file = NULL;
-	const char *nefdbg_output_file = NULL;
-	const char *nef3_output_file = NULL;
-
-	std::string suffix = boosty::extension_str( output_file );
-	boost::algorithm::to_lower( suffix );
-
-	if (suffix == ".stl") stl_output_file = output_file;
-	else if (suffix == ".off") off_output_file = output_file;
-	else if (suffix == ".amf") amf_output_file = output_file;
-	else if (suffix == ".dxf") dxf_output_file = output_file;
-	else if (suffix == ".svg") svg_output_file = output_file;
-	else if (suffix == ".csg") csg_output_file = output_file;
-	else if (suffix == ".png") png_output_file = output_file;
-	else if (suffix == ".ast") ast_output_file = output_file;
-	else if (suffix == ".term") term_output_file = output_file;
-	else if (suffix == ".echo") echo_output_file = output_file;
-	else if (suffix == ".nefdbg") nefdbg_output_file = output_file;
-	else if (suffix == ".nef3") nef3_output_file = output_file;
-	else {
-		PRINTB("Unknown suffix for output file %s\n", output_file);
-		return 1;
+/*!
+	Sorts the given output files by their suffix. Only one file per format
+	can be given.
+*/
+static bool get_output_files(const vector<string> &output_files, OutputFiles &out)
+{
+	for (const auto &output_file : output_files) {
+		std::string suffix = boosty::extension_str(output_file);
+		boost::algorithm::to_lower(suffix);
+
+		const char **target;
+		if (suffix == ".stl") target = &out.stl;
+		else if (suffix == ".off") target = &out.off;
+		else if (suffix == ".amf") target = &out.amf;
+		else if (suffix == ".dxf") target = &out.dxf;
+		else if (suffix == ".svg") target = &out.svg;
+		else if (suffix == ".csg") target = &out.csg;
+		else if (suffix == ".png") target = &out.png;
+		else if (suffix == ".ast") target = &out.ast;
+		else if (suffix == ".term") target = &out.term;
+		else if (suffix == ".echo") target = &out.echo;
+		else if (suffix == ".nefdbg") target = &out.nefdbg;
+		else if (suffix == ".nef3") target = &out.nef3;
+		else {
+			PRINTB("Unknown suffix for output file %s\n", output_file);
+			return false;
+		}
+		if (*target) {
+			PRINTB("Only one %s output file can be given", suffix);
+			return false;
+		}
+		*target = output_file.c_str();
 	}
+	return true;
+}
 
-	set_render_color_scheme(arg_colorscheme, true);
-	
-	// Top context - this context only holds builtins
-	ModuleContext top_ctx;
-	top_ctx.registerBuiltin();
-#ifdef DEBUG
-	PRINTDB("Top ModuleContext:\n%s",top_ctx.dump(NULL, NULL));
-#endif
-	shared_ptr<Echostream> echostream;
-	if (echo_output_file)
-		echostream.reset( new Echostream( echo_output_file ) );
+/*!
+	A parsed and instantiated input file
+*/
+struct ExportModel
+{
+	ExportModel() : root_inst("group"), root_node(NULL) {}
 
-	FileModule *root_module;
-	ModuleInstantiation root_inst("group");
+	std::unique_ptr<FileModule> root_module;
+	ModuleInstantiation root_inst;
+	std::unique_ptr<AbstractNode> absolute_root_node;
 	AbstractNode *root_node;
-	AbstractNode *absolute_root_node;
-	shared_ptr<const Geometry> root_geom;
+	fs::path fparent;
+};
 
+static bool read_input(const std::string &filename, std::string &text)
+{
 	handle_dep(filename);
 
 	std::ifstream ifs(filename.c_str());
 	if (!ifs.is_open()) {
 		PRINTB("Can't open input file '%s'!\n", filename.c_str());
-		return 1;
+		return false;
 	}
-	std::string text((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
-	text += "\n" + commandline_commands;
+	text.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+	return true;
+}
+
+/*!
+	Parses the text of the given file. Doesn't touch the module cache, so
+	this can run on worker threads.
+*/
+static bool parse_model(const std::string &filename, const std::string &text, ExportModel &model)
+{
 	fs::path abspath = boosty::absolute(filename);
-	root_module = parse(text.c_str(), abspath, false);
-	if (!root_module) {
+	model.root_module.reset(parse(text.c_str(), abspath, false));
+	if (!model.root_module) {
 		PRINTB("Can't parse file '%s'!\n", filename.c_str());
-		return 1;
+		return false;
 	}
-	root_module->handleDependencies();
+	model.fparent = abspath.parent_path();
+	return true;
+}
 
-	fs::path fpath = boosty::absolute(fs::path(filename));
-	fs::path fparent = fpath.parent_path();
-	fs::current_path(fparent);
-	top_ctx.setDocumentPath(fparent.string());
+/*!
+	Instantiates a parsed model, whose dependencies have been handled.
+	Only touches the model, so this can run on worker threads.
+*/
+static void instantiate_model(ExportModel &model)
+{
+	// Worker threads are reused, and an earlier model may have failed inside a module
+	Module::set_stack(std::deque<std::string>());
+	// Top context - this context only holds builtins
+	ModuleContext top_ctx;
+	top_ctx.registerBuiltin();
+#ifdef DEBUG
+	PRINTDB("Top ModuleContext:\n%s",top_ctx.dump(NULL, NULL));
+#endif
+	top_ctx.setDocumentPath(model.fparent.string());
 
 	AbstractNode::resetIndexCounter();
-	absolute_root_node = root_module->instantiate(&top_ctx, &root_inst, NULL);
+	model.absolute_root_node.reset(model.root_module->instantiate(&top_ctx, &model.root_inst, NULL));
 
 	// Do we have an explicit root node (! modifier)?
-	if (!(root_node = find_root_tag(absolute_root_node)))
-		root_node = absolute_root_node;
+	if (!(model.root_node = find_root_tag(model.absolute_root_node.get())))
+		model.root_node = model.absolute_root_node.get();
+}
 
-	tree.setRoot(root_node);
+/*!
+	Evaluates an instantiated model and writes the output files. Nothing is
+	written if the geometry doesn't suit one of the requested formats.
+*/
+static int export_model(const ExportModel &model, const OutputFiles &out, const char *deps_output_file,
+												Camera &camera, const vector<string> &output_files, const vector<PngView> &views,
+												const fs::path &original_path, Render::type renderer)
+{
+	Tree tree;
+#ifdef ENABLE_CGAL
+	GeometryEvaluator geomevaluator(tree);
+#endif
+	shared_ptr<const Geometry> root_geom;
 
-	if (csg_output_file) {
+	fs::current_path(model.fparent);
+	tree.setRoot(model.root_node);
+
+	struct GeometryExport {
+		const char *filename;
+		unsigned int dim;
+		FileFormat format;
+	};
+	const GeometryExport formats[] = {
+		{ out.stl, 3, OPENSCAD_STL },
+		{ out.off, 3, OPENSCAD_OFF },
+		{ out.amf, 3, OPENSCAD_AMF },
+		{ out.dxf, 2, OPENSCAD_DXF },
+		{ out.svg, 2, OPENSCAD_SVG },
+		{ out.nefdbg, 3, OPENSCAD_NEFDBG },
+		{ out.nef3, 3, OPENSCAD_NEF3 }
+	};
+
+	bool geometry_output = out.stl || out.off || out.amf || out.dxf ||
+		out.svg || out.nefdbg || out.nef3;
+	bool text_output = out.csg || out.ast || out.term;
+	bool evaluate = geometry_output || out.png || !views.empty() || out.echo || !text_output;
+	if (evaluate) {
+#ifdef ENABLE_CGAL
+		if (!geometry_output && (renderer==Render::OPENCSG || renderer==Render::THROWNTOGETHER)) {
+			// echo or OpenCSG png -> don't necessarily need geometry evaluation
+		} else {
+			// Force creation of CGAL objects (for testing)
+			root_geom = geomevaluator.evaluateGeometry(*tree.root(), true);
+			if (!root_geom) root_geom.reset(new CGAL_Nef_polyhedron());
+			if (renderer == Render::CGAL && root_geom->getDimension() == 3) {
+				const CGAL_Nef_polyhedron *N = dynamic_cast<const CGAL_Nef_polyhedron*>(root_geom.get());
+				if (!N) {
+					N = CGALUtils::createNefPolyhedronFromGeometry(*root_geom);
+					root_geom.reset(N);
+					PRINT("Converted to Nef polyhedron");
+				}
+			}
+		}
+		for (const auto &e : formats) {
+			if (e.filename && !checkExport(root_geom, e.dim)) return 1;
+		}
+#else
+		PRINT("OpenSCAD has been compiled without CGAL support!\n");
+		return 1;
+#endif
+	}
+
+	if (out.csg) {
 		fs::current_path(original_path);
-		std::ofstream fstream(csg_output_file);
+		std::ofstream fstream(out.csg);
+		fs::current_path(model.fparent); // Force exported filenames to be relative to document path
 		if (!fstream.is_open()) {
-			PRINTB("Can't open file \"%s\" for export", csg_output_file);
+			PRINTB("Can't open file \"%s\" for export", out.csg);
 		}
 		else {
-			fs::current_path(fparent); // Force exported filenames to be relative to document path
-			fstream << tree.getString(*root_node) << "\n";
+			fstream << tree.getString(*model.root_node) << "\n";
 			fstream.close();
 		}
 	}
-	else if (ast_output_file) {
+
+	if (out.ast) {
 		fs::current_path(original_path);
-		std::ofstream fstream(ast_output_file);
+		std::ofstream fstream(out.ast);
+		fs::current_path(model.fparent); // Force exported filenames to be relative to document path
 		if (!fstream.is_open()) {
-			PRINTB("Can't open file \"%s\" for export", ast_output_file);
+			PRINTB("Can't open file \"%s\" for export", out.ast);
 		}
 		else {
-			fs::current_path(fparent); // Force exported filenames to be relative to document path
-			fstream << root_module->dump("", "") << "\n";
+			fstream << model.root_module->dump("", "") << "\n";
 			fstream.close();
 		}
 	}
-	else if (term_output_file) {
+
+	if (out.term) {
 		CSGTreeEvaluator csgRenderer(tree);
-		shared_ptr<CSGNode> root_raw_term = csgRenderer.buildCSGTree(*root_node);
+		shared_ptr<CSGNode> root_raw_term = csgRenderer.buildCSGTree(*model.root_node);
 
 		fs::current_path(original_path);
-		std::ofstream fstream(term_output_file);
+		std::ofstream fstream(out.term);
+		fs::current_path(model.fparent);
 		if (!fstream.is_open()) {
-			PRINTB("Can't open file \"%s\" for export", term_output_file);
+			PRINTB("Can't open file \"%s\" for export", out.term);
 		}
 		else {
 			if (!root_raw_term)
@@ -468,106 +664,519 @@ int cmdline(const char *deps_output_file, const std::string &filename, Camera &c
 			fstream.close();
 		}
 	}
-	else {
+
+	fs::current_path(original_path);
+
+	if (deps_output_file) {
+		// Every output file depends on the same files
+		vector<string> targets(output_files);
+		for(const auto &view : views) targets.push_back(view.filename);
+		if (!write_deps(deps_output_file, boost::algorithm::join(targets, " "))) {
+			PRINT("error writing deps");
+			return 1;
+		}
+	}
+
 #ifdef ENABLE_CGAL
-		if ((echo_output_file || png_output_file) &&
-				(renderer==Render::OPENCSG || renderer==Render::THROWNTOGETHER)) {
-			// echo or OpenCSG png -> don't necessarily need geometry evaluation
-		} else {
-			// Force creation of CGAL objects (for testing)
-			root_geom = geomevaluator.evaluateGeometry(*tree.root(), true);
-			if (!root_geom) root_geom.reset(new CGAL_Nef_polyhedron());
-			if (renderer == Render::CGAL && root_geom->getDimension() == 3) {
-				const CGAL_Nef_polyhedron *N = dynamic_cast<const CGAL_Nef_polyhedron*>(root_geom.get());
-				if (!N) {
-					N = CGALUtils::createNefPolyhedronFromGeometry(*root_geom);
-					root_geom.reset(N);
-					PRINT("Converted to Nef polyhedron");
+	if (evaluate) {
+		// Exports which only read a PolySet or Polygon2d can run concurrently.
+		// Anything touching a Nef polyhedron stays on this thread, since
+		// CGAL's reference counted numbers aren't thread safe. The PolySet
+		// extracted from a Nef polyhedron is cached in it and shared by
+		// these exports and the images.
+		const CGAL_Nef_polyhedron *N = dynamic_cast<const CGAL_Nef_polyhedron *>(root_geom.get());
+		std::vector<GeometryExport> concurrent, serial;
+		for (const auto &e : formats) {
+			if (!e.filename) continue;
+			bool uses_nef = N || e.format == OPENSCAD_AMF || e.format == OPENSCAD_NEFDBG || e.format == OPENSCAD_NEF3;
+			(uses_nef ? serial : concurrent).push_back(e);
+		}
+		// All images are rendered from the same evaluated tree
+		vector<PngView> png_views(views);
+		if (out.png) png_views.push_back(PngView(camera, out.png));
+
+		// Job 0 runs on the calling thread, which owns the OpenGL context
+		Parallel::for_each_index(0, concurrent.size() + 1, [&](size_t i) {
+				if (i > 0) {
+					const GeometryExport &e = concurrent[i - 1];
+					exportFileByName(root_geom, e.format, e.filename, e.filename);
+					return;
 				}
-			}
+				for (const auto &e : serial) {
+					exportFileByName(root_geom, e.format, e.filename, e.filename);
+				}
+				if (!png_views.empty()) {
+					if (renderer==Render::CGAL || renderer==Render::GEOMETRY) {
+						export_png(root_geom, png_views);
+					} else if (renderer==Render::THROWNTOGETHER) {
+						export_png_with_throwntogether(tree, png_views);
+					} else {
+						export_png_with_opencsg(tree, png_views);
+					}
+				}
+			});
+	}
+#endif
+	return 0;
+}
+
+
+static int export_file(const char *deps_output_file, const std::string &filename, Camera &camera,
+											 const vector<string> &output_files, const vector<PngView> &views,
+											 const fs::path &original_path, Render::type renderer)
+{
+	// Every output file is written from the same evaluation
+	OutputFiles out;
+	if (!get_output_files(output_files, out)) return 1;
+
+	shared_ptr<Echostream> echostream;
+	if (out.echo)
+		echostream.reset( new Echostream( out.echo ) );
+
+	std::string text;
+	if (!read_input(filename, text)) return 1;
+	text += "\n" + commandline_commands;
+
+	ExportModel model;
+	if (!parse_model(filename, text, model)) return 1;
+	model.root_module->handleDependencies();
+
+	fs::current_path(model.fparent);
+	instantiate_model(model);
+
+	return export_model(model, out, deps_output_file, camera, output_files, views, original_path, renderer);
+}
+
+typedef vector<std::pair<string, string>> Assignments;
+
+/*!
+	Splits a line of a CSV file into its trimmed fields. Fields can be
+	quoted, with "" standing for a quote inside a quoted field. Returns
+	false if a quote isn't closed.
+*/
+static bool split_csv_line(const string &line, vector<string> &fields)
+{
+	fields.clear();
+	string field;
+	bool quoted = false;
+	for (size_t i = 0; i < line.size(); i++) {
+		char c = line[i];
+		if (quoted) {
+			if (c != '"') field += c;
+			else if (i + 1 < line.size() && line[i + 1] == '"') field += line[i++];
+			else quoted = false;
 		}
+		else if (c == '"') quoted = true;
+		else if (c == ',') {
+			fields.push_back(boost::algorithm::trim_copy(field));
+			field.clear();
+		}
+		else field += c;
+	}
+	fields.push_back(boost::algorithm::trim_copy(field));
+	return !quoted;
+}
 
-		fs::current_path(original_path);
+/*!
+	Reads the variants to export with --sweep. A CSV file has the variable
+	names in its first line and a variant in each further line:
 
-		if (deps_output_file) {
-			std::string deps_out( deps_output_file );
-			std::string geom_out;
-			if ( stl_output_file ) geom_out = std::string(stl_output_file);
-			else if ( off_output_file ) geom_out = std::string(off_output_file);
-			else if ( amf_output_file ) geom_out = std::string(amf_output_file);
-			else if ( dxf_output_file ) geom_out = std::string(dxf_output_file);
-			else if ( svg_output_file ) geom_out = std::string(svg_output_file);
-			else if ( png_output_file ) geom_out = std::string(png_output_file);
-			else {
-				PRINTB("Output file:%s\n",output_file);
-				PRINT("Sorry, don't know how to write deps for that file type. Exiting\n");
-				return 1;
+	  len,label
+	  10,"""short"""
+	  20,"""long"""
+
+	A JSON file lists the variants like
+
+	  { "variants": [ { "len": 10, "label": "\"short\"" }, { "len": 20, "label": "\"long\"" } ] }
+
+	Values are expressions, like those given with -D.
+*/
+static bool read_sweep(const string &filename, vector<Assignments> &variants)
+{
+	std::string suffix = boosty::extension_str(filename);
+	boost::algorithm::to_lower(suffix);
+	try {
+		if (suffix == ".json") {
+			namespace pt = boost::property_tree;
+			pt::ptree spec;
+			pt::read_json(filename, spec);
+			for(const auto &v : spec.get_child("variants")) {
+				Assignments variant;
+				for(const auto &a : v.second) {
+					if (!a.second.empty()) throw std::runtime_error("the value of " + a.first + " isn't a number or string");
+					variant.push_back(std::make_pair(a.first, a.second.get_value<string>()));
+				}
+				variants.push_back(variant);
 			}
-			int result = write_deps( deps_out, geom_out );
-			if ( !result ) {
-				PRINT("error writing deps");
-				return 1;
+		}
+		else {
+			std::ifstream ifs(filename.c_str());
+			if (!ifs.is_open()) throw std::runtime_error("can't open file");
+			string line;
+			vector<string> names, values;
+			size_t lineno = 0;
+			while (std::getline(ifs, line)) {
+				lineno++;
+				if (boost::algorithm::trim_copy(line).empty()) continue;
+				if (!split_csv_line(line, names.empty() ? names : values) ||
+						(!values.empty() && values.size() != names.size())) {
+					throw std::runtime_error(str(boost::format("bad line %d") % lineno));
+				}
+				if (values.empty()) continue;
+				Assignments variant;
+				for (size_t i = 0; i < names.size(); i++) variant.push_back(std::make_pair(names[i], values[i]));
+				variants.push_back(variant);
 			}
 		}
+	}
+	catch (const std::exception &e) {
+		PRINTB("Can't read sweep from '%s': %s", filename % e.what());
+		return false;
+	}
+	if (variants.empty()) {
+		PRINTB("Can't read sweep from '%s': no variants given", filename);
+		return false;
+	}
+	return true;
+}
 
-		if (stl_output_file) {
-			if (!checkAndExport(root_geom, 3, OPENSCAD_STL, stl_output_file))
-				return 1;
+/*!
+	Replaces each {name} in an output file name by the value the variant
+	assigns to name, without the quotes of a string.
+*/
+static string sweep_filename(const string &pattern, const Assignments &variant)
+{
+	string filename = pattern;
+	for(const auto &a : variant) {
+		string value = a.second;
+		if (value.size() >= 2 && value[0] == '"' && value[value.size() - 1] == '"') {
+			value = value.substr(1, value.size() - 2);
 		}
+		boost::algorithm::replace_all(filename, "{" + a.first + "}", value);
+	}
+	return filename;
+}
 
-		if (off_output_file) {
-			if (!checkAndExport(root_geom, 3, OPENSCAD_OFF, off_output_file))
-				return 1;
+/*!
+	Exports every variant of a parameter sweep from one process. The input
+	file is read once, and batches of variants are parsed and instantiated
+	on worker threads. They are then evaluated and exported one after another,
+	with their messages printed in order, so geometry which doesn't depend
+	on the variant is taken from the geometry and CGAL caches. Used
+	libraries are compiled once, with the -D assignments of the command
+	line, and shared by all variants.
+*/
+static int sweep(const string &sweepfile, const char *deps_output_file, const string &filename, Camera &camera,
+								 const vector<string> &output_files, const fs::path &original_path, Render::type renderer)
+{
+	vector<Assignments> variants;
+	if (!read_sweep(sweepfile, variants)) return 1;
+
+	struct Variant {
+		vector<string> output_files;
+		string deps_output_file;
+		OutputFiles out;
+		ExportModel model;
+		PrintCapture output;
+		bool ok = false;
+	};
+	vector<Variant> jobs(variants.size());
+	std::set<string> filenames;
+	for (size_t i = 0; i < jobs.size(); i++) {
+		Variant &job = jobs[i];
+		for(const auto &output_file : output_files) {
+			job.output_files.push_back(sweep_filename(output_file, variants[i]));
 		}
-
-		if (amf_output_file) {
-			if (!checkAndExport(root_geom, 3, OPENSCAD_AMF, amf_output_file))
+		if (deps_output_file) job.deps_output_file = sweep_filename(deps_output_file, variants[i]);
+		if (!get_output_files(job.output_files, job.out)) return 1;
+		vector<string> written(job.output_files);
+		if (deps_output_file) written.push_back(job.deps_output_file);
+		for(const auto &file : written) {
+			if (!filenames.insert(file).second) {
+				PRINTB("%s would be written by more than one variant. Use {name} in output file names to tell the variants apart.", file);
 				return 1;
+			}
 		}
+	}
 
-		if (dxf_output_file) {
-			if (!checkAndExport(root_geom, 2, OPENSCAD_DXF, dxf_output_file))
-				return 1;
-		}
-		
-		if (svg_output_file) {
-			if (!checkAndExport(root_geom, 2, OPENSCAD_SVG, svg_output_file))
-				return 1;
+	std::string text;
+	if (!read_input(filename, text)) return 1;
+	text += "\n" + commandline_commands;
+
+	// Only one batch of variants is parsed and instantiated at a time, so the
+	// memory held by their trees doesn't grow with the size of the sweep
+	const size_t batchsize = Parallel::maxThreads();
+	const fs::path fparent = fs::path(boosty::absolute(filename)).parent_path();
+	const boost::thread::id caller = boost::this_thread::get_id();
+	int rc = 0;
+	for (size_t first = 0; first < jobs.size(); first += batchsize) {
+		const size_t last = std::min(first + batchsize, jobs.size());
+		Parallel::for_each_index(first, last, [&](size_t i) {
+				Variant &job = jobs[i];
+				PrintCapture::Scope capture(job.output);
+				std::string commands;
+				for(const auto &a : variants[i]) commands += a.first + "=" + a.second + ";\n";
+				job.ok = parse_model(filename, text + commands, job.model);
+			});
+
+		// The first variant compiles the used libraries, the others find them cached
+		for (size_t i = first; i < last; i++) {
+			Variant &job = jobs[i];
+			if (!job.ok) continue;
+			PrintCapture::Scope capture(job.output);
+			job.model.root_module->handleDependencies();
 		}
 
-		if (png_output_file) {
-			std::ofstream fstream(png_output_file,std::ios::out|std::ios::binary);
-			if (!fstream.is_open()) {
-				PRINTB("Can't open file \"%s\" for export", png_output_file);
+		fs::current_path(fparent);
+		Parallel::for_range(first, last, [&](size_t begin, size_t end) {
+				if (boost::this_thread::get_id() != caller) StackCheck::inst()->init();
+				for (size_t i = begin; i < end; i++) {
+					Variant &job = jobs[i];
+					if (!job.ok) continue;
+					PrintCapture::Scope capture(job.output);
+					try {
+						instantiate_model(job.model);
+					}
+					catch (const std::exception &e) {
+						PRINTB("ERROR: %s", e.what());
+						job.ok = false;
+					}
+				}
+			}, 1, PlatformUtils::stackLimit() + STACK_BUFFER_SIZE);
+
+		for (size_t i = first; i < last; i++) {
+			Variant &job = jobs[i];
+			string assignments;
+			for(const auto &a : variants[i]) {
+				if (!assignments.empty()) assignments += ", ";
+				assignments += a.first + "=" + a.second;
 			}
-			else {
-				if (renderer==Render::CGAL || renderer==Render::GEOMETRY) {
-					export_png(root_geom, camera, fstream);
-				} else if (renderer==Render::THROWNTOGETHER) {
-					export_png_with_throwntogether(tree, camera, fstream);
-				} else {
-					export_png_with_opencsg(tree, camera, fstream);
+			PRINTB("Variant %d of %d: %s", (i + 1) % jobs.size() % assignments);
+			resetPrintedDeprecations();
+			{
+				// Output file names are relative to where openscad was started,
+				// export_model() expects to start in the input file's directory
+				fs::current_path(original_path);
+				shared_ptr<Echostream> echostream;
+				if (job.out.echo)
+					echostream.reset( new Echostream( job.out.echo ) );
+				fs::current_path(fparent);
+				job.output.replay();
+				if (!job.ok || export_model(job.model, job.out, deps_output_file ? job.deps_output_file.c_str() : NULL,
+																		camera, job.output_files, vector<PngView>(), original_path, renderer)) {
+					rc = 1;
 				}
-				fstream.close();
 			}
+			job.model.absolute_root_node.reset();
+			job.model.root_module.reset();
+			job.output = PrintCapture();
 		}
+	}
+	fs::current_path(original_path);
+	return rc;
+}
 
-		if (nefdbg_output_file) {
-			if (!checkAndExport(root_geom, 3, OPENSCAD_NEFDBG, nefdbg_output_file))
-				return 1;
+struct ServerClient {
+	FILE *out;
+	bool connected; // Cleared when writing to out fails
+};
+
+/*!
+	Forwards the messages of a server job to its client.
+*/
+static void server_output(const std::string &msg, void *userdata)
+{
+	ServerClient *client = static_cast<ServerClient *>(userdata);
+	if (!client->connected) return;
+	if (fprintf(client->out, "%s\n", msg.c_str()) < 0 || fflush(client->out) != 0) {
+		client->connected = false;
+	}
+}
+
+/*!
+	Runs a single server job. A job is a line of command line arguments:
+
+	  [ -D var=val [..] ] -o output_file [ -o .. ] [ -d deps_file ] filename
+
+	Relative paths are resolved from the directory the server was started in.
+	The job's -D assignments follow those of the server, given in
+	server_commands. Everything else, like the camera and renderer, is taken
+	from the command line of the server.
+*/
+static int server_job(const std::string &line, const std::string &server_commands, Camera &camera, const fs::path &original_path, Render::type renderer)
+{
+	po::options_description desc;
+	desc.add_options()
+		("o,o", po::value<vector<string>>())
+		("d,d", po::value<string>())
+		("D,D", po::value<vector<string>>())
+		("input-file", po::value<vector<string>>());
+	po::positional_options_description p;
+	p.add("input-file", -1);
+
+	po::variables_map vm;
+	try {
+		po::store(po::command_line_parser(po::split_unix(line)).options(desc).positional(p).run(), vm);
+	}
+	catch(const std::exception &e) {
+		PRINTB("ERROR: %s", e.what());
+		return 1;
+	}
+	if (!vm.count("o") || !vm.count("input-file") || vm["input-file"].as<vector<string>>().size() != 1) {
+		PRINT("ERROR: A job needs exactly one input file and an output file given by -o");
+		return 1;
+	}
+
+	commandline_commands = server_commands;
+	if (vm.count("D")) {
+		for(const auto &cmd : vm["D"].as<vector<string>>()) {
+			commandline_commands += cmd;
+			commandline_commands += ";\n";
 		}
+	}
+	const vector<string> output_files = vm["o"].as<vector<string>>();
+	const string deps_output_file = vm.count("d") ? vm["d"].as<string>() : "";
+	resetPrintedDeprecations();
+	clear_deps();
 
-		if (nef3_output_file) {
-			if (!checkAndExport(root_geom, 3, OPENSCAD_NEF3, nef3_output_file))
-				return 1;
+	int rc;
+	try {
+		rc = export_file(deps_output_file.empty() ? NULL : deps_output_file.c_str(),
+										 vm["input-file"].as<vector<string>>()[0], camera, output_files,
+										 vector<PngView>(), original_path, renderer);
+	}
+	catch(const std::exception &e) {
+		PRINTB("ERROR: %s", e.what());
+		rc = 1;
+	}
+	fs::current_path(original_path);
+	return rc;
+}
+
+/*!
+	Reads jobs line by line from in until the end of input, a "quit" line or
+	a failed write to out. The messages of each job are written to out,
+	followed by a line "done <status>", where status is 0 if the job
+	succeeded. Returns false if the server was asked to quit.
+*/
+static bool server_serve(FILE *in, FILE *out, const std::string &server_commands, Camera &camera, const fs::path &original_path, Render::type renderer)
+{
+	ServerClient client = {out, true};
+	std::string line;
+	int c;
+	while (client.connected && ((c = fgetc(in)) != EOF || !line.empty())) {
+		if (c != EOF && c != '\n') {
+			line += char(c);
+			continue;
 		}
+		boost::algorithm::trim(line);
+		if (line == "quit") return false;
+		if (!line.empty()) {
+			OutputHandlerFunc *prevhandler = outputhandler;
+			void *prevdata = outputhandler_data;
+			set_output_handler(server_output, &client);
+			int rc = server_job(line, server_commands, camera, original_path, renderer);
+			set_output_handler(prevhandler, prevdata);
+			server_output(str(boost::format("done %d") % rc), &client);
+		}
+		line.clear();
+	}
+	return true;
+}
+
+/*!
+	Keeps running export jobs in one process, so the caches filled by earlier
+	jobs (parsed libraries, fonts, geometry and CGAL objects, ...) speed up
+	later ones. Jobs are read from stdin, or, if a socket path is given, from
+	connections to a Unix domain socket. Connections are served one at a time.
+	A client going away ends its connection, not the server.
+*/
+static int server(const std::string &socketpath, Camera &camera, const fs::path &original_path, Render::type renderer)
+{
+	const std::string server_commands = commandline_commands;
+#ifndef _WIN32
+	// Writing to a closed connection fails instead of killing the server
+	signal(SIGPIPE, SIG_IGN);
+#endif
+	if (socketpath.empty()) {
+		server_serve(stdin, stdout, server_commands, camera, original_path, renderer);
+		return 0;
+	}
+#ifdef _WIN32
+	PRINT("ERROR: Serving jobs on a socket is not supported on this platform");
+	return 1;
 #else
-		PRINT("OpenSCAD has been compiled without CGAL support!\n");
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (socketpath.size() >= sizeof(addr.sun_path)) {
+		PRINTB("ERROR: Socket path too long: %s", socketpath);
 		return 1;
-#endif
 	}
-	delete root_node;
+	strcpy(addr.sun_path, socketpath.c_str());
+
+	// Only replace a stale socket, never some other file given by mistake
+	struct stat st;
+	if (lstat(socketpath.c_str(), &st) == 0) {
+		if (!S_ISSOCK(st.st_mode)) {
+			PRINTB("ERROR: Can't listen on socket %s: File exists and is not a socket", socketpath);
+			return 1;
+		}
+		if (unlink(socketpath.c_str()) != 0) {
+			PRINTB("ERROR: Can't remove old socket %s: %s", socketpath % strerror(errno));
+			return 1;
+		}
+	}
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0 || bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 8) < 0) {
+		PRINTB("ERROR: Can't listen on socket %s: %s", socketpath % strerror(errno));
+		if (fd >= 0) close(fd);
+		return 1;
+	}
+	PRINTB("Listening on %s", socketpath);
+
+	bool running = true;
+	while (running) {
+		int conn = accept(fd, NULL, NULL);
+		if (conn < 0) {
+			if (errno == EINTR) continue;
+			PRINTB("ERROR: Can't accept connection: %s", strerror(errno));
+			break;
+		}
+		FILE *in = fdopen(conn, "r");
+		FILE *out = fdopen(dup(conn), "w");
+		if (in && out) running = server_serve(in, out, server_commands, camera, original_path, renderer);
+		if (in) fclose(in);
+		if (out) fclose(out);
+	}
+	close(fd);
+	unlink(socketpath.c_str());
 	return 0;
+#endif
+}
+
+int cmdline(const char *deps_output_file, const std::string &filename, Camera &camera, const vector<string> &output_files, const fs::path &original_path, Render::type renderer, int argc, char ** argv )
+{
+#ifdef OPENSCAD_QTGUI
+	QCoreApplication app(argc, argv);
+	const std::string application_path = QCoreApplication::instance()->applicationDirPath().toLocal8Bit().constData();
+#else
+	const std::string application_path = boosty::stringy(boosty::absolute(boost::filesystem::path(argv[0]).parent_path()));
+#endif	
+	PlatformUtils::registerApplicationPath(application_path);
+	parser_init();
+	localization_init();
+
+	if (arg_info) {
+	    info();
+	}
+
+	set_render_color_scheme(arg_colorscheme, true);
+
+	if (arg_server) return server(arg_server_socket, camera, original_path, renderer);
+	if (!arg_sweep.empty()) return sweep(arg_sweep, deps_output_file, filename, camera, output_files, original_path, renderer);
+	return export_file(deps_output_file, filename, camera, output_files, arg_views, original_path, renderer);
 }
 
 #ifdef OPENSCAD_QTGUI
@@ -806,7 +1415,7 @@ int main(int argc, char **argv)
 
 	fs::path original_path = fs::current_path();
 
-	const char *output_file = NULL;
+	vector<string> output_files;
 	const char *deps_output_file = NULL;
 
 	po::options_description desc("Allowed options");
@@ -817,16 +1426,24 @@ int main(int argc, char **argv)
 		("render", po::value<string>()->implicit_value(""), "if exporting a png image, do a full geometry evaluation")
 		("preview", po::value<string>()->implicit_value(""), "if exporting a png image, do an OpenCSG(default) or ThrownTogether preview")
 		("csglimit", po::value<unsigned int>(), "if exporting a png image, stop rendering at the given number of CSG elements")
+		("render-backend", po::value<string>(), "=opengl|software, draw png images with OpenGL or with the CPU without a display")
 		("camera", po::value<string>(), "parameters for camera when exporting png")
 		("autocenter", "adjust camera to look at object center")
 		("viewall", "adjust camera to fit object")
 		("imgsize", po::value<string>(), "=width,height for exporting png")
+		("views", po::value<string>(), "=file.json listing png images to export with their cameras and sizes")
+		("sweep", po::value<string>(), "=file.csv|file.json listing sets of -D assignments to export")
 		("projection", po::value<string>(), "(o)rtho or (p)erspective when exporting png")
 		("colorscheme", po::value<string>(), "colorscheme")
 		("debug", po::value<string>(), "special debug info")
+		("ast-cache", po::value<string>(), "=directory for caching parsed libraries")
+		("font-cache", po::value<string>(), "=file for caching the font list")
+		("cache-stats", "print cache statistics when done")
+		("memo-limit", po::value<size_t>(), "=bytes of function results to memoize, 0 disables memoization")
+		("server", po::value<string>()->implicit_value(""), "keep running export jobs read from stdin, or from connections to the given Unix socket")
 		("quiet,q", "quiet mode (don't print anything *except* errors)")
 		("enable-vr", "enable openVR mode")
-		("o,o", po::value<string>(), "out-file")
+		("o,o", po::value<vector<string>>(), "out-file")
 		("s,s", po::value<string>(), "stl-file")
 		("x,x", po::value<string>(), "dxf-file")
 		("d,d", po::value<string>(), "deps-file")
@@ -865,9 +1482,21 @@ int main(int argc, char **argv)
 	if (vm.count("quiet")) {
 		OpenSCAD::quiet = true;
 	}
+	if (vm.count("ast-cache")) {
+		ASTCache::instance()->setCacheDir(vm["ast-cache"].as<string>());
+	}
+	if (vm.count("font-cache")) {
+		FontCache::setSnapshotFile(vm["font-cache"].as<string>());
+	}
 	if (vm.count("help")) help(argv[0]);
 	if (vm.count("version")) version();
 	if (vm.count("info")) arg_info = true;
+	if (vm.count("cache-stats")) arg_cache_stats = true;
+	if (vm.count("memo-limit")) Function::setMemoLimit(vm["memo-limit"].as<size_t>());
+	if (vm.count("server")) {
+		arg_server = true;
+		arg_server_socket = vm["server"].as<string>();
+	}
 
 	Render::type renderer = Render::OPENCSG;
 	if (vm.count("preview")) {
@@ -882,21 +1511,25 @@ int main(int argc, char **argv)
 	if (vm.count("csglimit")) {
 		RenderSettings::inst()->openCSGTermLimit = vm["csglimit"].as<unsigned int>();
 	}
+	if (vm.count("render-backend")) {
+		string backend = vm["render-backend"].as<string>();
+		if (backend == "software") RenderSettings::inst()->software_rendering = true;
+		else if (backend != "opengl") {
+			PRINTB("Unknown render backend '%s'. Use 'opengl' or 'software'.", backend);
+			return 1;
+		}
+	}
 
 	if (vm.count("o")) {
-		// FIXME: Allow for multiple output files?
-		if (output_file) help(argv[0], true);
-		output_file = vm["o"].as<string>().c_str();
+		output_files = vm["o"].as<vector<string>>();
 	}
 	if (vm.count("s")) {
 		printDeprecation("The -s option is deprecated. Use -o instead.\n");
-		if (output_file) help(argv[0], true);
-		output_file = vm["s"].as<string>().c_str();
+		output_files.push_back(vm["s"].as<string>());
 	}
 	if (vm.count("x")) { 
 		printDeprecation("The -x option is deprecated. Use -o instead.\n");
-		if (output_file) help(argv[0], true);
-		output_file = vm["x"].as<string>().c_str();
+		output_files.push_back(vm["x"].as<string>());
 	}
 	if (vm.count("d")) {
 		if (deps_output_file) help(argv[0], true);
@@ -932,20 +1565,40 @@ int main(int argc, char **argv)
 	currentdir = boosty::stringy(fs::current_path());
 
 	Camera camera = get_camera(vm);
+	if (vm.count("views") && !read_views(vm["views"].as<string>(), camera, arg_views)) return 1;
+	if (vm.count("sweep")) {
+		// Each variant needs its own output files
+		if (output_files.empty() || !arg_views.empty() || arg_server) help(argv[0], true);
+		arg_sweep = vm["sweep"].as<string>();
+	}
 
 	// Initialize global visitors
 	NodeCache nodecache;
 	NodeDumper dumper(nodecache);
 
 	bool cmdlinemode = false;
-	if (output_file) { // cmd-line mode
+	if (!output_files.empty() || !arg_views.empty()) { // cmd-line mode
 		cmdlinemode = true;
 		if (!inputFiles.size()) help(argv[0], true);
 	}
 
-	if (arg_info || cmdlinemode) {
-		if (inputFiles.size() > 1) help(argv[0], true);
-		rc = cmdline(deps_output_file, inputFiles[0], camera, output_file, original_path, renderer, argc, argv);
+	if (arg_info || cmdlinemode || arg_server) {
+		if (arg_server) {
+			if (!output_files.empty() || !arg_views.empty() || inputFiles.size()) help(argv[0], true);
+			rc = cmdline(NULL, "", camera, output_files, original_path, renderer, argc, argv);
+		}
+		else {
+			if (inputFiles.size() > 1) help(argv[0], true);
+			rc = cmdline(deps_output_file, inputFiles[0], camera, output_files, original_path, renderer, argc, argv);
+		}
+		if (arg_cache_stats) {
+			GeometryCache::instance()->print();
+#ifdef ENABLE_CGAL
+			CGALCache::instance()->print();
+#endif
+			Function::printCacheStats();
+			FontCache::instance()->print();
+		}
 	}
 	else if (QtUseGUI()) {
 		rc = gui(inputFiles, original_path, argc, argv);
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <boost/thread.hpp>
+#include <exception>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <deque>
+#include <map>
+#include <vector>
+
+/*!
+	Minimal data-parallel helpers.
+
+	Work is split into contiguous chunks of at least grainsize items and
+	executed on a pool of worker threads, which are started on first use
+	and reused afterwards. The calling thread processes the first chunk
+	itself, and any chunk no worker has picked up by then, so nested calls
+	can't deadlock. Small workloads run inline, so callers don't need to
+	special-case them.
+
+	The body must not touch shared state other than writing to
+	disjoint, preallocated output slots. Workers keep their thread-local
+	state between chunks, so bodies needing fresh state must set it up.
+*/
+namespace Parallel {
+	inline unsigned int &maxThreadsRef() {
+		static unsigned int maxthreads = 0;
+		return maxthreads;
+	}
+
+	/*!
+		Sets the maximum number of threads used by the helpers.
+		0 means use the number of hardware threads; 1 disables threading.
+	*/
+	inline void setMaxThreads(unsigned int n) { maxThreadsRef() = n; }
+
+	inline unsigned int maxThreads() {
+		unsigned int n = maxThreadsRef();
+		if (n == 0) n = boost::thread::hardware_concurrency();
+		return std::max(n, 1u);
+	}
+
+	/*!
+		Worker threads with a given stack size, running queued tasks.
+		Pools are never destroyed, their threads wait for tasks until exit.
+	*/
+	class ThreadPool
+	{
+	public:
+		static ThreadPool &get(size_t stacksize) {
+			static boost::mutex mutex;
+			static std::map<size_t, ThreadPool *> pools;
+			boost::mutex::scoped_lock lock(mutex);
+			ThreadPool *&pool = pools[stacksize];
+			if (!pool) pool = new ThreadPool(stacksize);
+			return *pool;
+		}
+
+		// Queues the task, starting workers up to maxThreads() - 1
+		void submit(const std::function<void()> &task) {
+			boost::mutex::scoped_lock lock(this->mutex);
+			while (this->numthreads + 1 < maxThreads()) {
+				boost::thread::attributes attrs;
+				if (this->stacksize) attrs.set_stack_size(this->stacksize);
+				boost::thread(attrs, [this]() { this->work(); }).detach();
+				this->numthreads++;
+			}
+			this->tasks.push_back(task);
+			this->ready.notify_one();
+		}
+
+	private:
+		ThreadPool(size_t stacksize) : stacksize(stacksize), numthreads(0) {}
+
+		void work() {
+			while (true) {
+				std::function<void()> task;
+				{
+					boost::mutex::scoped_lock lock(this->mutex);
+					while (this->tasks.empty()) this->ready.wait(lock);
+					task = std::move(this->tasks.front());
+					this->tasks.pop_front();
+				}
+				task();
+			}
+		}
+
+		size_t stacksize;
+		size_t numthreads;
+		boost::mutex mutex;
+		boost::condition_variable ready;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	/*!
+		Chunks of one for_range() call. Each chunk is run by whoever claims it
+		first, the caller or a worker.
+	*/
+	class ChunkGroup
+	{
+	public:
+		ChunkGroup(size_t chunks) : claimed(chunks, false), unfinished(chunks) {}
+
+		bool claim(size_t c) {
+			boost::mutex::scoped_lock lock(this->mutex);
+			if (this->claimed[c]) return false;
+			this->claimed[c] = true;
+			return true;
+		}
+
+		void finish() {
+			boost::mutex::scoped_lock lock(this->mutex);
+			if (--this->unfinished == 0) this->done.notify_all();
+		}
+
+		void wait() {
+			boost::mutex::scoped_lock lock(this->mutex);
+			while (this->unfinished > 0) this->done.wait(lock);
+		}
+
+	private:
+		boost::mutex mutex;
+		boost::condition_variable done;
+		std::vector<bool> claimed;
+		size_t unfinished;
+	};
+
+	/*!
+		Calls body(begin, end) for disjoint subranges covering [first, last).
+		If stacksize is nonzero, worker threads get stacks of that size.
+	*/
+	template<typename Body>
+	void for_range(size_t first, size_t last, Body body, size_t grainsize = 1, size_t stacksize = 0)
+	{
+		if (last <= first) return;
+		size_t n = last - first;
+		size_t chunks = std::min<size_t>(maxThreads(), n / std::max<size_t>(grainsize, 1));
+		if (chunks <= 1) {
+			body(first, last);
+			return;
+		}
+
+		size_t chunksize = (n + chunks - 1) / chunks;
+		chunks = (n + chunksize - 1) / chunksize;
+		std::vector<std::exception_ptr> errors(chunks);
+		// Queued tasks may outlive this call if the caller ran their chunks,
+		// so they only share the group, and use the rest once they've claimed
+		// a chunk, which this call waits for
+		auto group = std::make_shared<ChunkGroup>(chunks);
+		auto run = [&](size_t c) {
+			size_t b = first + c * chunksize;
+			try { body(b, std::min(b + chunksize, last)); }
+			catch (...) { errors[c] = std::current_exception(); }
+			group->finish();
+		};
+		ThreadPool &pool = ThreadPool::get(stacksize);
+		for (size_t c = 1; c < chunks; c++) {
+			pool.submit([group, c, &run]() { if (group->claim(c)) run(c); });
+		}
+		for (size_t c = 0; c < chunks; c++) {
+			if (group->claim(c)) run(c);
+		}
+		group->wait();
+
+		for (const auto &err : errors) {
+			if (err) std::rethrow_exception(err);
+		}
+	}
+
+	/*!
+		Calls body(i) for every i in [first, last).
+	*/
+	template<typename Body>
+	void for_each_index(size_t first, size_t last, Body body, size_t grainsize = 1)
+	{
+		for_range(first, last, [&body](size_t b, size_t e) {
+				for (size_t i = b; i < e; i++) body(i);
+			}, grainsize);
+	}
+}
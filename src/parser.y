@@ -26,6 +26,13 @@
 
 %expect 2 /* Expect 2 shift/reduce conflict for ifelse_statement - "dangling else problem" */
 %locations
+%define api.pure
+%parse-param { ParserContext *ctx }
+%lex-param { ParserContext *ctx }
+
+%code requires {
+struct ParserContext;
+}
 
 %{
 
@@ -42,6 +49,7 @@
 #include "function.h"
 #include "printutils.h"
 #include "memory.h"
+#include "ParserContext.h"
 #include <sstream>
 #include <boost/filesystem.hpp>
 
@@ -51,25 +59,11 @@ namespace fs = boost::filesystem;
 
 #define YYMAXDEPTH 20000
 
-int parser_error_pos = -1;
-
-int parserlex(void);
-void yyerror(char const *s);
-
-int lexerget_lineno(void);
-fs::path sourcefile(void);
-int lexerlex_destroy(void);
-int lexerlex(void);
-
-std::stack<LocalScope *> scope_stack;
-FileModule *rootmodule;
+thread_local int parser_error_pos = -1;
 
-extern void lexerdestroy();
-extern FILE *lexerin;
-extern const char *parser_input_buffer;
-const char *parser_input_buffer;
-fs::path parser_sourcefile;
-extern std::vector<fs::path> filename_stack;
+int lexerget_lineno(void *scanner);
+int lexerlex_init_extra(ParserContext *ctx, void **scanner);
+int lexerlex_destroy(void *scanner);
 %}
 
 %union {
@@ -83,6 +77,12 @@ extern std::vector<fs::path> filename_stack;
   AssignmentList *args;
 }
 
+%{
+int lexerlex(YYSTYPE *lvalp, YYLTYPE *llocp, void *scanner);
+int parserlex(YYSTYPE *lvalp, YYLTYPE *llocp, ParserContext *ctx);
+void yyerror(YYLTYPE *llocp, ParserContext *ctx, char const *s);
+%}
+
 %token TOK_ERROR
 
 %token TOK_MODULE
@@ -144,7 +144,7 @@ extern std::vector<fs::path> filename_stack;
 input:    /* empty */
         | TOK_USE
             {
-              rootmodule->registerUse(std::string($1));
+              ctx->rootmodule->registerUse(std::string($1));
               free($1);
             }
           input
@@ -156,26 +156,26 @@ statement:
         | '{' inner_input '}'
         | module_instantiation
             {
-                if ($1) scope_stack.top()->addChild($1);
+                if ($1) ctx->scope_stack.top()->addChild($1);
             }
         | assignment
         | TOK_MODULE TOK_ID '(' arguments_decl optional_commas ')'
             {
                 Module *newmodule = new Module();
                 newmodule->definition_arguments = *$4;
-                scope_stack.top()->modules[$2] = newmodule;
-                scope_stack.push(&newmodule->scope);
+                ctx->scope_stack.top()->modules[$2] = newmodule;
+                ctx->scope_stack.push(&newmodule->scope);
                 free($2);
                 delete $4;
             }
           statement
             {
-                scope_stack.pop();
+                ctx->scope_stack.pop();
             }
         | TOK_FUNCTION TOK_ID '(' arguments_decl optional_commas ')' '=' expr
             {
                 Function *func = Function::create($2, *$4, $8);
-                scope_stack.top()->functions[$2] = func;
+                ctx->scope_stack.top()->functions[$2] = func;
                 free($2);
                 delete $4;
             }
@@ -191,7 +191,7 @@ assignment:
           TOK_ID '=' expr ';'
             {
                 bool found = false;
-                for (auto& iter : scope_stack.top()->assignments) {
+                for (auto& iter : ctx->scope_stack.top()->assignments) {
                     if (iter.first == $1) {
                         iter.second = shared_ptr<Expression>($3);
                         found = true;
@@ -199,7 +199,7 @@ assignment:
                     }
                 }
                 if (!found) {
-                    scope_stack.top()->assignments.push_back(Assignment($1, shared_ptr<Expression>($3)));
+                    ctx->scope_stack.top()->assignments.push_back(Assignment($1, shared_ptr<Expression>($3)));
                 }
                 free($1);
             }
@@ -229,11 +229,11 @@ module_instantiation:
         | single_module_instantiation
             {
                 $<inst>$ = $1;
-                scope_stack.push(&$1->scope);
+                ctx->scope_stack.push(&$1->scope);
             }
           child_statement
             {
-                scope_stack.pop();
+                ctx->scope_stack.pop();
                 $$ = $<inst>2;
             }
         | ifelse_statement
@@ -249,11 +249,11 @@ ifelse_statement:
             }
         | if_statement TOK_ELSE
             {
-                scope_stack.push(&$1->else_scope);
+                ctx->scope_stack.push(&$1->else_scope);
             }
           child_statement
             {
-                scope_stack.pop();
+                ctx->scope_stack.pop();
                 $$ = $1;
             }
         ;
@@ -263,12 +263,12 @@ if_statement:
             {
                 $<ifelse>$ = new IfElseModuleInstantiation();
                 $<ifelse>$->arguments.push_back(Assignment("", shared_ptr<Expression>($3)));
-                $<ifelse>$->setPath(boosty::stringy(parser_sourcefile.parent_path()));
-                scope_stack.push(&$<ifelse>$->scope);
+                $<ifelse>$->setPath(boosty::stringy(ctx->sourcefile.parent_path()));
+                ctx->scope_stack.push(&$<ifelse>$->scope);
             }
           child_statement
             {
-                scope_stack.pop();
+                ctx->scope_stack.pop();
                 $$ = $<ifelse>5;
             }
         ;
@@ -284,7 +284,7 @@ child_statement:
         | '{' child_statements '}'
         | module_instantiation
             {
-                if ($1) scope_stack.top()->addChild($1);
+                if ($1) ctx->scope_stack.top()->addChild($1);
             }
         ;
 
@@ -301,8 +301,8 @@ single_module_instantiation:
             {
                 $$ = new ModuleInstantiation($1);
                 $$->arguments = *$3;
-                $$->setPath(boosty::stringy(parser_sourcefile.parent_path()));
-                if (filename_stack.empty())
+                $$->setPath(boosty::stringy(ctx->sourcefile.parent_path()));
+                if (ctx->filename_stack.empty())
                   $$->setLocation(@$.first_line, @$.first_column,
                                   @$.last_line, @$.last_column);
                 free($1);
@@ -588,38 +588,42 @@ argument_call:
 
 %%
 
-int parserlex(void)
+int parserlex(YYSTYPE *lvalp, YYLTYPE *llocp, ParserContext *ctx)
 {
-  return lexerlex();
+  return lexerlex(lvalp, llocp, ctx->scanner);
 }
 
-void yyerror (char const *s)
+void yyerror(YYLTYPE *, ParserContext *ctx, char const *s)
 {
     // FIXME: We leak memory on parser errors...
     PRINTB("ERROR: Parser error in file %s, line %d: %s\n",
-        sourcefile() % lexerget_lineno() % s);
+        ctx->currentSourceFile() % lexerget_lineno(ctx->scanner) % s);
 }
 
+/*!
+  Parses the given text. Each call uses its own parser and lexer state, so
+  this may be called concurrently from several threads.
+  The error position is left in the thread's parser_error_pos.
+*/
 FileModule *parse(const char *text, const fs::path &filename, int debug)
 {
-  lexerin = NULL;
-  parser_error_pos = -1;
-  parser_input_buffer = text;
-  parser_sourcefile = boosty::absolute(filename);
+  ParserContext ctx(text, boosty::absolute(filename));
 
-  rootmodule = new FileModule();
-  rootmodule->setModulePath(boosty::stringy(filename.parent_path()));
-  scope_stack.push(&rootmodule->scope);
-  //        PRINTB_NOCACHE("New module: %s %p", "root" % rootmodule);
+  ctx.rootmodule = new FileModule();
+  ctx.rootmodule->setModulePath(boosty::stringy(filename.parent_path()));
+  ctx.scope_stack.push(&ctx.rootmodule->scope);
+  //        PRINTB_NOCACHE("New module: %s %p", "root" % ctx.rootmodule);
 
-  parserdebug = debug;
-  int parserretval = parserparse();
-  lexerdestroy();
-  lexerlex_destroy();
+  if (debug) parserdebug = debug;
+  lexerlex_init_extra(&ctx, &ctx.scanner);
+  int parserretval = parserparse(&ctx);
+  // parserdebug is global, so don't leave it on for other parses
+  if (debug) parserdebug = 0;
+  lexerlex_destroy(ctx.scanner);
 
+  parser_error_pos = ctx.error_pos;
   if (parserretval != 0) return NULL;
 
   parser_error_pos = -1;
-  scope_stack.pop();
-  return rootmodule;
+  return ctx.rootmodule;
 }
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <boost/filesystem.hpp>
 
 namespace fs = boost::filesystem;
 
-extern int parser_error_pos;
+extern thread_local int parser_error_pos;
+extern std::vector<std::string> librarypath;
 
 /**
  * Initialize library path.
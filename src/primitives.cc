@@ -37,7 +37,9 @@
 #include <sstream>
 #include <assert.h>
 #include <cmath>
+#include <map>
 #include <boost/assign/std/vector.hpp>
+#include <boost/thread/mutex.hpp>
 using namespace boost::assign; // bring 'operator+=()' into scope
 
 #define F_MINIMUM 0.01
@@ -278,17 +280,165 @@ AbstractNode *PrimitiveModule::instantiate(const Context *ctx, const ModuleInsta
 	return node;
 }
 
-struct point2d {
-	double x, y;
+/*!
+	Tessellation of a unit primitive with a given number of fragments.
+
+	Instances with the same primitive type and fragment count share one
+	tessellation, so trig tables and sphere connectivity are only computed
+	once; instances just scale it. Vertex coordinates are computed as
+	radius * cached factor, which gives bit-identical results to computing
+	the trig functions directly.
+*/
+struct UnitTessellation {
+	// Unit circle, one entry per fragment
+	std::vector<double> cos_a, sin_a;
+	// Spheres only: ring position, one entry per ring
+	std::vector<double> ring_sin, ring_cos;
+	// Spheres only: polygons as indices into the ring-major vertex list
+	std::vector<std::vector<int>> polygons;
 };
 
-static void generate_circle(point2d *circle, double r, int fragments)
+static void generate_circle(UnitTessellation &t, int fragments)
 {
+	t.cos_a.resize(fragments);
+	t.sin_a.resize(fragments);
 	for (int i=0; i<fragments; i++) {
 		double phi = (M_PI*2*i) / fragments;
-		circle[i].x = r*cos(phi);
-		circle[i].y = r*sin(phi);
+		t.cos_a[i] = cos(phi);
+		t.sin_a[i] = sin(phi);
+	}
+}
+
+static void generate_sphere(UnitTessellation &t, int fragments)
+{
+	generate_circle(t, fragments);
+	int rings = (fragments+1)/2;
+// Uncomment the following line to enable experimental sphere tesselation
+//	if (rings % 2 == 0) rings++; // To ensure that the middle ring is at phi == 0 degrees
+
+	t.ring_sin.resize(rings);
+	t.ring_cos.resize(rings);
+//	double offset = 0.5 * ((fragments / 2) % 2);
+	for (int i = 0; i < rings; i++) {
+//		double phi = (M_PI * (i + offset)) / (fragments/2);
+		double phi = (M_PI * (i + 0.5)) / rings;
+		t.ring_sin[i] = sin(phi);
+		t.ring_cos[i] = cos(phi);
+	}
+
+	t.polygons.reserve(2*fragments*(rings-1) + 2);
+	std::vector<int> top(fragments);
+	for (int i = 0; i < fragments; i++) top[i] = i;
+	t.polygons.push_back(top);
+
+	// Both rings have the same number of fragments, so triangles alternate
+	// between pointing up and down
+	for (int i = 0; i < rings-1; i++) {
+		int r1 = i*fragments;
+		int r2 = (i+1)*fragments;
+		int r1i = 0, r2i = 0;
+		while (r1i < fragments || r2i < fragments) {
+			if (r2i >= fragments || (r1i < fragments && r1i < r2i)) {
+				int r1j = (r1i+1) % fragments;
+				t.polygons.push_back({r2 + r2i % fragments, r1 + r1j, r1 + r1i});
+				r1i++;
+			} else {
+				int r2j = (r2i+1) % fragments;
+				t.polygons.push_back({r2 + r2i, r2 + r2j, r1 + r1i % fragments});
+				r2i++;
+			}
+		}
+	}
+
+	std::vector<int> bottom(fragments);
+	for (int i = 0; i < fragments; i++) bottom[i] = (rings-1)*fragments + fragments-1-i;
+	t.polygons.push_back(bottom);
+}
+
+/*!
+	Returns the shared tessellation for the given primitive and fragment count.
+	Circles and cylinders share the unit circle tables.
+*/
+static shared_ptr<const UnitTessellation> get_tessellation(primitive_type_e type, int fragments)
+{
+	// Bounds the cache when fragment counts vary a lot, e.g. $fn in a loop
+	static const size_t MAX_ENTRIES = 256;
+	static std::map<std::pair<primitive_type_e, int>, shared_ptr<const UnitTessellation>> cache;
+	static boost::mutex cache_mutex;
+
+	if (type == CYLINDER) type = CIRCLE;
+	std::pair<primitive_type_e, int> key(type, fragments);
+	boost::mutex::scoped_lock lock(cache_mutex);
+	auto it = cache.find(key);
+	if (it != cache.end()) return it->second;
+
+	UnitTessellation *t = new UnitTessellation;
+	if (type == SPHERE) generate_sphere(*t, fragments);
+	else generate_circle(*t, fragments);
+
+	if (cache.size() >= MAX_ENTRIES) cache.clear();
+	shared_ptr<const UnitTessellation> result(t);
+	cache[key] = result;
+	return result;
+}
+
+/*!
+	The faces of a polyhedron() as point indices, in the order they are given.
+*/
+struct PolyhedronFaces {
+	// Keeps the faces value alive, so its address stays a valid key
+	ValuePtr faces;
+	std::vector<std::vector<size_t>> indices;
+};
+
+/*!
+	Returns the face indices of the given faces value. Instances which take
+	their faces from the same variable, e.g. a mesh whose points are animated,
+	share them, so the faces are only converted once.
+*/
+static shared_ptr<const PolyhedronFaces> get_polyhedron_faces(const ValuePtr &faces)
+{
+	static const size_t MAX_ENTRIES = 256;
+	// Bounds the memory held by the cached faces and the values they pin
+	static const size_t MAX_INDICES = 1000000;
+	static std::map<const Value *, shared_ptr<const PolyhedronFaces>> cache;
+	static size_t cached_indices = 0;
+	static boost::mutex cache_mutex;
+
+	{
+		boost::mutex::scoped_lock lock(cache_mutex);
+		auto it = cache.find(faces.get());
+		if (it != cache.end()) return it->second;
 	}
+
+	PolyhedronFaces *f = new PolyhedronFaces;
+	f->faces = faces;
+	size_t count = 0;
+	const Value::VectorType &vec = faces->toVector();
+	f->indices.resize(vec.size());
+	for (size_t i=0; i<vec.size(); i++) {
+		if (const std::vector<double> *numbers = vec[i]->toNumbers()) {
+			f->indices[i].assign(numbers->begin(), numbers->end());
+		}
+		else {
+			const Value::VectorType &face = vec[i]->toVector();
+			f->indices[i].reserve(face.size());
+			for (size_t j=0; j<face.size(); j++) {
+				f->indices[i].push_back(face[j]->toDouble());
+			}
+		}
+		count += f->indices[i].size();
+	}
+	shared_ptr<const PolyhedronFaces> result(f);
+	if (count > MAX_INDICES) return result;
+
+	boost::mutex::scoped_lock lock(cache_mutex);
+	if (cache.size() >= MAX_ENTRIES || cached_indices + count > MAX_INDICES) {
+		cache.clear();
+		cached_indices = 0;
+	}
+	if (cache.insert(std::make_pair(faces.get(), result)).second) cached_indices += count;
+	return result;
 }
 
 /*!
@@ -362,74 +512,25 @@ const Geometry *PrimitiveNode::createGeometry() const
 		PolySet *p = new PolySet(3,true);
 		g = p;
 		if (this->r1 > 0 && !std::isinf(this->r1)) {
-			struct ring_s {
-				point2d *points;
-				double z;
-			};
-
 			int fragments = Calc::get_fragments_from_r(r1, fn, fs, fa);
-			int rings = (fragments+1)/2;
-// Uncomment the following three lines to enable experimental sphere tesselation
-//		if (rings % 2 == 0) rings++; // To ensure that the middle ring is at phi == 0 degrees
-
-			ring_s *ring = new ring_s[rings];
-
-//		double offset = 0.5 * ((fragments / 2) % 2);
-			for (int i = 0; i < rings; i++) {
-//			double phi = (M_PI * (i + offset)) / (fragments/2);
-				double phi = (M_PI * (i + 0.5)) / rings;
-				double r = r1 * sin(phi);
-				ring[i].z = r1 * cos(phi);
-				ring[i].points = new point2d[fragments];
-				generate_circle(ring[i].points, r, fragments);
-			}
-
-			p->append_poly();
-			for (int i = 0; i < fragments; i++)
-				p->append_vertex(ring[0].points[i].x, ring[0].points[i].y, ring[0].z);
-
-			for (int i = 0; i < rings-1; i++) {
-				ring_s *r1 = &ring[i];
-				ring_s *r2 = &ring[i+1];
-				int r1i = 0, r2i = 0;
-				while (r1i < fragments || r2i < fragments)
-				{
-					if (r1i >= fragments)
-						goto sphere_next_r2;
-					if (r2i >= fragments)
-						goto sphere_next_r1;
-					if ((double)r1i / fragments <
-							(double)r2i / fragments)
-					{
-					sphere_next_r1:
-						p->append_poly();
-						int r1j = (r1i+1) % fragments;
-						p->insert_vertex(r1->points[r1i].x, r1->points[r1i].y, r1->z);
-						p->insert_vertex(r1->points[r1j].x, r1->points[r1j].y, r1->z);
-						p->insert_vertex(r2->points[r2i % fragments].x, r2->points[r2i % fragments].y, r2->z);
-						r1i++;
-					} else {
-					sphere_next_r2:
-						p->append_poly();
-						int r2j = (r2i+1) % fragments;
-						p->append_vertex(r2->points[r2i].x, r2->points[r2i].y, r2->z);
-						p->append_vertex(r2->points[r2j].x, r2->points[r2j].y, r2->z);
-						p->append_vertex(r1->points[r1i % fragments].x, r1->points[r1i % fragments].y, r1->z);
-						r2i++;
-					}
+			shared_ptr<const UnitTessellation> t = get_tessellation(SPHERE, fragments);
+
+			std::vector<Vector3d> vertices;
+			vertices.reserve(t->ring_sin.size() * fragments);
+			for (size_t i = 0; i < t->ring_sin.size(); i++) {
+				double r = r1 * t->ring_sin[i];
+				double z = r1 * t->ring_cos[i];
+				for (int j = 0; j < fragments; j++) {
+					vertices.push_back(Vector3d(r*t->cos_a[j], r*t->sin_a[j], z));
 				}
 			}
 
-			p->append_poly();
-			for (int i = 0; i < fragments; i++)
-				p->insert_vertex(ring[rings-1].points[i].x, 
-												 ring[rings-1].points[i].y, 
-												 ring[rings-1].z);
-
-			for (int i = 0; i < rings; i++) {
-				delete[] ring[i].points;
+			p->polygons.reserve(t->polygons.size());
+			for(const auto &indices : t->polygons) {
+				p->append_poly();
+				p->polygons.back().reserve(indices.size());
+				for(int idx : indices) p->append_vertex(vertices[idx]);
 			}
-			delete[] ring;
 		}
 	}
 		break;
@@ -450,50 +551,49 @@ const Geometry *PrimitiveNode::createGeometry() const
 				z2 = this->h;
 			}
 
-			point2d *circle1 = new point2d[fragments];
-			point2d *circle2 = new point2d[fragments];
+			shared_ptr<const UnitTessellation> t = get_tessellation(CYLINDER, fragments);
+			std::vector<Vector3d> circle1(fragments), circle2(fragments);
+			for (int i=0; i<fragments; i++) {
+				circle1[i] = Vector3d(r1*t->cos_a[i], r1*t->sin_a[i], z1);
+				circle2[i] = Vector3d(r2*t->cos_a[i], r2*t->sin_a[i], z2);
+			}
 
-			generate_circle(circle1, r1, fragments);
-			generate_circle(circle2, r2, fragments);
-		
+			p->polygons.reserve(fragments*2 + 2);
 			for (int i=0; i<fragments; i++) {
 				int j = (i+1) % fragments;
 				if (r1 == r2) {
 					p->append_poly();
-					p->insert_vertex(circle1[i].x, circle1[i].y, z1);
-					p->insert_vertex(circle2[i].x, circle2[i].y, z2);
-					p->insert_vertex(circle2[j].x, circle2[j].y, z2);
-					p->insert_vertex(circle1[j].x, circle1[j].y, z1);
+					p->append_vertex(circle1[j]);
+					p->append_vertex(circle2[j]);
+					p->append_vertex(circle2[i]);
+					p->append_vertex(circle1[i]);
 				} else {
 					if (r1 > 0) {
 						p->append_poly();
-						p->insert_vertex(circle1[i].x, circle1[i].y, z1);
-						p->insert_vertex(circle2[i].x, circle2[i].y, z2);
-						p->insert_vertex(circle1[j].x, circle1[j].y, z1);
+						p->append_vertex(circle1[j]);
+						p->append_vertex(circle2[i]);
+						p->append_vertex(circle1[i]);
 					}
 					if (r2 > 0) {
 						p->append_poly();
-						p->insert_vertex(circle2[i].x, circle2[i].y, z2);
-						p->insert_vertex(circle2[j].x, circle2[j].y, z2);
-						p->insert_vertex(circle1[j].x, circle1[j].y, z1);
+						p->append_vertex(circle1[j]);
+						p->append_vertex(circle2[j]);
+						p->append_vertex(circle2[i]);
 					}
 				}
 			}
 
 			if (this->r1 > 0) {
 				p->append_poly();
-				for (int i=0; i<fragments; i++)
-					p->insert_vertex(circle1[i].x, circle1[i].y, z1);
+				for (int i=fragments-1; i>=0; i--)
+					p->append_vertex(circle1[i]);
 			}
 
 			if (this->r2 > 0) {
 				p->append_poly();
 				for (int i=0; i<fragments; i++)
-					p->append_vertex(circle2[i].x, circle2[i].y, z2);
+					p->append_vertex(circle2[i]);
 			}
-
-			delete[] circle1;
-			delete[] circle2;
 		}
 	}
 		break;
@@ -501,22 +601,27 @@ const Geometry *PrimitiveNode::createGeometry() const
 		PolySet *p = new PolySet(3);
 		g = p;
 		p->setConvexity(this->convexity);
-		for (size_t i=0; i<this->faces->toVector().size(); i++)
-		{
-			p->append_poly();
-			const Value::VectorType &vec = this->faces->toVector()[i]->toVector();
-			for (size_t j=0; j<vec.size(); j++) {
-				size_t pt = vec[j]->toDouble();
-				if (pt < this->points->toVector().size()) {
+		shared_ptr<const PolyhedronFaces> faces = get_polyhedron_faces(this->faces);
+		const Value::VectorType &points = this->points->toVector();
+		p->polygons.reserve(faces->indices.size());
+		for(const auto &indices : faces->indices) {
+			Polygon face;
+			face.reserve(indices.size());
+			for (size_t j=0; j<indices.size(); j++) {
+				size_t pt = indices[j];
+				if (pt < points.size()) {
 					double px, py, pz;
-					if (!this->points->toVector()[pt]->getVec3(px, py, pz) ||
+					if (!points[pt]->getVec3(px, py, pz) ||
 							std::isinf(px) || std::isinf(py) || std::isinf(pz)) {
 						PRINTB("ERROR: Unable to convert point at index %d to a vec3 of numbers", j);
+						p->append_poly(Polygon(face.rbegin(), face.rend()));
 						return p;
 					}
-					p->insert_vertex(px, py, pz);
+					face.push_back(Vector3d(px, py, pz));
 				}
 			}
+			// Faces are given clockwise, the PolySet wants them counter-clockwise
+			p->append_poly(Polygon(face.rbegin(), face.rend()));
 		}
 	}
 		break;
@@ -549,11 +654,12 @@ const Geometry *PrimitiveNode::createGeometry() const
 		if (this->r1 > 0 && !std::isinf(this->r1))	{
 			int fragments = Calc::get_fragments_from_r(this->r1, this->fn, this->fs, this->fa);
 
+			shared_ptr<const UnitTessellation> t = get_tessellation(CIRCLE, fragments);
+
 			Outline2d o;
 			o.vertices.resize(fragments);
 			for (int i=0; i < fragments; i++) {
-				double phi = (M_PI*2*i) / fragments;
-				o.vertices[i] = Vector2d(this->r1*cos(phi), this->r1*sin(phi));
+				o.vertices[i] = Vector2d(this->r1*t->cos_a[i], this->r1*t->sin_a[i]);
 			}
 			p->addOutline(o);
 		}
@@ -583,8 +689,14 @@ const Geometry *PrimitiveNode::createGeometry() const
 			else {
 				for(const auto &polygon : this->paths->toVector()) {
 					Outline2d curroutline;
-					for(const auto &index : polygon->toVector()) {
-						unsigned int idx = index->toDouble();
+					const std::vector<double> *indices = polygon->toNumbers();
+					std::vector<double> unpacked;
+					if (!indices) {
+						for(const auto &index : polygon->toVector()) unpacked.push_back(index->toDouble());
+						indices = &unpacked;
+					}
+					for(double index : *indices) {
+						unsigned int idx = index;
 						if (idx < outline.vertices.size()) {
 							curroutline.vertices.push_back(outline.vertices[idx]);
 						}
@@ -5,10 +5,12 @@
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/circular_buffer.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/thread/recursive_mutex.hpp>
 namespace fs = boost::filesystem;
 #include "boosty.h"
 
-std::list<std::string> print_messages_stack;
+thread_local std::list<std::string> print_messages_stack;
+thread_local unsigned long print_messages_count = 0;
 OutputHandlerFunc *outputhandler = NULL;
 void *outputhandler_data = NULL;
 std::string OpenSCAD::debug("");
@@ -16,6 +18,12 @@ bool OpenSCAD::quiet = false;
 
 boost::circular_buffer<std::string> lastmessages(5);
 
+// Capture the messages of this thread are collected in, if any
+static thread_local PrintCapture *print_capture = NULL;
+
+// Geometry evaluation may print from worker threads
+static boost::recursive_mutex print_mutex;
+
 void set_output_handler(OutputHandlerFunc *newhandler, void *userdata)
 {
 	outputhandler = newhandler;
@@ -39,9 +47,36 @@ void print_messages_pop()
 	}
 }
 
+PrintCapture::Scope::Scope(PrintCapture &capture) : previous(print_capture)
+{
+	print_capture = &capture;
+}
+
+PrintCapture::Scope::~Scope()
+{
+	print_capture = this->previous;
+}
+
+void PrintCapture::replay() const
+{
+	for (const auto &msg : this->messages) {
+		switch (msg.first) {
+		case CACHED: PRINT(msg.second); break;
+		case NOCACHE: PRINT_NOCACHE(msg.second); break;
+		case DEPRECATION: printDeprecation(msg.second); break;
+		}
+	}
+}
+
 void PRINT(const std::string &msg)
 {
 	if (msg.empty()) return;
+	if (print_capture) {
+		print_messages_count++;
+		print_capture->messages.push_back(std::make_pair(PrintCapture::CACHED, msg));
+		return;
+	}
+	boost::recursive_mutex::scoped_lock lock(print_mutex);
 	if (print_messages_stack.size() > 0) {
 		if (!print_messages_stack.back().empty()) {
 			print_messages_stack.back() += "\n";
@@ -54,6 +89,12 @@ void PRINT(const std::string &msg)
 void PRINT_NOCACHE(const std::string &msg)
 {
 	if (msg.empty()) return;
+	print_messages_count++;
+	if (print_capture) {
+		print_capture->messages.push_back(std::make_pair(PrintCapture::NOCACHE, msg));
+		return;
+	}
+	boost::recursive_mutex::scoped_lock lock(print_mutex);
 
 	if (boost::starts_with(msg, "WARNING") || boost::starts_with(msg, "ERROR")) {
 		size_t i;
@@ -113,6 +154,12 @@ std::set<std::string> printedDeprecations;
 
 void printDeprecation(const std::string &str)
 {
+	// Whether this is the first time depends on the order of the messages
+	if (print_capture) {
+		print_capture->messages.push_back(std::make_pair(PrintCapture::DEPRECATION, str));
+		return;
+	}
+	boost::recursive_mutex::scoped_lock lock(print_mutex);
 	if (printedDeprecations.find(str) == printedDeprecations.end()) {
 		printedDeprecations.insert(str);
 		std::string msg = "DEPRECATED: " + str;
@@ -122,5 +169,6 @@ void printDeprecation(const std::string &str)
 
 void resetPrintedDeprecations()
 {
+	boost::recursive_mutex::scoped_lock lock(print_mutex);
 	printedDeprecations.clear();
 }
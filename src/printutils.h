@@ -2,6 +2,7 @@
 
 #include <string>
 #include <list>
+#include <vector>
 #include <iostream>
 #include <boost/format.hpp>
 
@@ -19,12 +20,45 @@ namespace OpenSCAD {
 
 void set_output_handler(OutputHandlerFunc *newhandler, void *userdata);
 
-extern std::list<std::string> print_messages_stack;
+// Each thread collects its own message stack
+extern thread_local std::list<std::string> print_messages_stack;
+// Number of messages printed by this thread
+extern thread_local unsigned long print_messages_count;
 void print_messages_push();
 void print_messages_pop();
 void printDeprecation(const std::string &str);
 void resetPrintedDeprecations();
 
+/*!
+	Collects the messages printed by a thread instead of printing them, so
+	output of work done in parallel can be replayed in a deterministic order.
+*/
+class PrintCapture
+{
+public:
+	// Captures the messages printed by the current thread while in scope
+	class Scope
+	{
+	public:
+		Scope(PrintCapture &capture);
+		~Scope();
+	private:
+		PrintCapture *previous;
+	};
+
+	// Prints the captured messages on the current thread
+	void replay() const;
+	bool empty() const { return this->messages.empty(); }
+
+private:
+	friend void PRINT(const std::string &msg);
+	friend void PRINT_NOCACHE(const std::string &msg);
+	friend void printDeprecation(const std::string &str);
+
+	enum Kind { CACHED, NOCACHE, DEPRECATION };
+	std::vector<std::pair<Kind, std::string>> messages;
+};
+
 #define PRINT_DEPRECATION(_fmt, _arg) do { printDeprecation(str(boost::format(_fmt) % _arg)); } while (0)
 
 /* PRINT statements come out in same window as ECHO.
@@ -18,4 +18,5 @@ RenderSettings::RenderSettings()
 	img_width = 512;
 	img_height = 512;
 	colorscheme = "Cornfield";
+	software_rendering = false;
 }
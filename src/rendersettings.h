@@ -11,6 +11,8 @@ public:
 	unsigned int openCSGTermLimit, img_width, img_height;
 	double far_gl_clip_limit;
 	std::string colorscheme;
+	// Export images with SoftwareRenderer instead of an OpenGL context
+	bool software_rendering;
 private:
 	RenderSettings();
 	~RenderSettings() {}
@@ -29,6 +29,7 @@
 #include "evalcontext.h"
 #include "printutils.h"
 #include "fileutils.h"
+#include "handle_dep.h"
 #include "builtin.h"
 #include "polyset.h"
 #include "visitor.h"
@@ -73,6 +74,7 @@ AbstractNode *RotateExtrudeModule::instantiate(const Context *ctx, const ModuleI
 	if (!file->isUndefined()) {
 		printDeprecation("Support for reading files in rotate_extrude will be removed in future releases. Use a child import() instead.");
 		node->filename = lookup_file(file->toString(), inst->path(), c.documentPath());
+		if (!node->filename.empty()) handle_dep(node->filename);
 	}
 
 	node->layername = layer->isUndefined() ? "" : layer->toString();
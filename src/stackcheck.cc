@@ -3,8 +3,6 @@
 #include "stackcheck.h"
 #include "PlatformUtils.h"
 
-StackCheck * StackCheck::self = 0;
-
 StackCheck::StackCheck() : ptr(0)
 {
 }
@@ -32,8 +30,6 @@ bool StackCheck::check()
 
 StackCheck * StackCheck::inst()
 {
-    if (self == 0) {
-        self = new StackCheck();
-    }
-    return self;
+    static thread_local StackCheck self;
+    return &self;
 }
@@ -6,6 +6,7 @@ public:
     StackCheck();
     virtual ~StackCheck();
 
+    // Each thread has its own instance, which needs to be initialized
     static StackCheck * inst();
 
     void init();
@@ -14,6 +15,4 @@ public:
     
 private:
     unsigned char * ptr;
-    
-    static StackCheck *self;
 };
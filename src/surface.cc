@@ -37,10 +37,6 @@
 
 #include <sstream>
 #include <fstream>
-#include <unordered_map>
-#include <boost/functional/hash.hpp>
-#include <boost/tokenizer.hpp>
-#include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/assign/std/vector.hpp>
 using namespace boost::assign; // bring 'operator+=()' into scope
@@ -55,7 +51,29 @@ public:
 	virtual AbstractNode *instantiate(const Context *ctx, const ModuleInstantiation *inst, EvalContext *evalctx) const;
 };
 
-typedef std::unordered_map<std::pair<int,int>, double, boost::hash<std::pair<int,int>>> img_data_t;
+/*!
+	Height samples stored row-major. Row 0 is the first line of a DAT file
+	or the bottom row of an image.
+*/
+struct img_data_t
+{
+	img_data_t() : lines(0), columns(0), min_val(0) { }
+
+	double operator()(int line, int column) const { return heights[line * columns + column]; }
+	double &operator()(int line, int column) { return heights[line * columns + column]; }
+
+	void resize(int l, int c) {
+		lines = l;
+		columns = c;
+		heights.assign(size_t(l) * c, 0.0);
+	}
+
+	int lines;
+	int columns;
+	// Bottom of the generated solid: one below the lowest sample, but never above 0
+	double min_val;
+	std::vector<double> heights;
+};
 
 class SurfaceNode : public LeafNode
 {
@@ -71,13 +89,14 @@ public:
 	bool center;
 	bool invert;
 	int convexity;
+	double decimate;
 	
 	virtual const Geometry *createGeometry() const;
 private:
 	void convert_image(img_data_t &data, std::vector<unsigned char> &img, unsigned int width, unsigned int height) const;
 	bool is_png(std::vector<unsigned char> &img) const;
-	img_data_t read_dat(std::string filename) const;
-	img_data_t read_png_or_dat(std::string filename) const;
+	void read_dat(img_data_t &data, std::string filename) const;
+	void read_png_or_dat(img_data_t &data, std::string filename) const;
 };
 
 AbstractNode *SurfaceModule::instantiate(const Context *ctx, const ModuleInstantiation *inst, EvalContext *evalctx) const
@@ -86,6 +105,7 @@ AbstractNode *SurfaceModule::instantiate(const Context *ctx, const ModuleInstant
 	node->center = false;
 	node->invert = false;
 	node->convexity = 1;
+	node->decimate = 0;
 
 	AssignmentList args;
 	args += Assignment("file"), Assignment("center"), Assignment("convexity");
@@ -95,6 +115,7 @@ AbstractNode *SurfaceModule::instantiate(const Context *ctx, const ModuleInstant
 
 	ValuePtr fileval = c.lookup_variable("file");
 	node->filename = lookup_file(fileval->isUndefined() ? "" : fileval->toString(), inst->path(), c.documentPath());
+	if (!node->filename.empty()) handle_dep(node->filename);
 
 	ValuePtr center = c.lookup_variable("center", true);
 	if (center->type() == Value::BOOL) {
@@ -111,17 +132,26 @@ AbstractNode *SurfaceModule::instantiate(const Context *ctx, const ModuleInstant
 		node->invert = invert->toBool();
 	}
 
+	ValuePtr decimate = c.lookup_variable("decimate", true);
+	if (decimate->type() == Value::NUMBER && decimate->toDouble() > 0) {
+		node->decimate = decimate->toDouble();
+	}
+
 	return node;
 }
 
 void SurfaceNode::convert_image(img_data_t &data, std::vector<unsigned char> &img, unsigned int width, unsigned int height) const
 {
+	data.resize(height, width);
 	for (unsigned int y = 0;y < height;y++) {
+		const unsigned char *row = &img[4 * y * width];
+		double *dst = &data.heights[size_t(height - 1 - y) * width];
 		for (unsigned int x = 0;x < width;x++) {
-			long idx = 4 * (y * width + x);
-			double pixel = 0.2126 * img[idx] + 0.7152 * img[idx + 1] + 0.0722 * img[idx + 2];
+			const unsigned char *px = row + 4 * x;
+			double pixel = 0.2126 * px[0] + 0.7152 * px[1] + 0.0722 * px[2];
 			double z = 100.0/255 * (invert ? 1 - pixel : pixel);
-			data[std::make_pair(height - 1 - y, x)] = z;
+			dst[x] = z;
+			data.min_val = std::min(z - 1, data.min_val);
 		}
 	}
 }
@@ -139,16 +169,16 @@ bool SurfaceNode::is_png(std::vector<unsigned char> &png) const
 		&& (png[7] == 0x0a);
 }
 
-img_data_t SurfaceNode::read_png_or_dat(std::string filename) const
+void SurfaceNode::read_png_or_dat(img_data_t &data, std::string filename) const
 {
-	img_data_t data;
 	std::vector<unsigned char> png;
 	
 	lodepng::load_file(png, filename);
 	
 	if (!is_png(png)) {
 		png.clear();
-		return read_dat(filename);
+		read_dat(data, filename);
+		return;
 	}
 	
 	unsigned int width, height;
@@ -156,150 +186,262 @@ img_data_t SurfaceNode::read_png_or_dat(std::string filename) const
 	unsigned error = lodepng::decode(img, width, height, png);
 	if (error) {
 		PRINTB("ERROR: Can't read PNG image '%s'", filename);
-		data.clear();
-		return data;
+		return;
 	}
+	// The encoded file isn't needed anymore, release it before allocating the heights
+	std::vector<unsigned char>().swap(png);
 	
 	convert_image(data, img, width, height);
-	
-	return data;
 }
 
-img_data_t SurfaceNode::read_dat(std::string filename) const
+/*!
+	Reads a DAT file one line at a time. Numbers are parsed in the C locale,
+	like in the source files. Short lines are padded with zeros up to the
+	longest line.
+*/
+void SurfaceNode::read_dat(img_data_t &data, std::string filename) const
 {
-	img_data_t data;
 	std::ifstream stream(filename.c_str());
 
 	if (!stream.good()) {
 		PRINTB("WARNING: Can't open DAT file '%s'.", filename);
-		return data;
+		return;
 	}
 
-	int lines = 0, columns = 0;
-	double min_val = 0;
-
-	typedef boost::tokenizer<boost::char_separator<char>> tokenizer;
-	boost::char_separator<char> sep(" \t");
+	int lines = 0, columns = 0, lineno = 0;
+	std::vector<double> values;
+	std::vector<size_t> linestart;
 
+	std::istringstream linestream;
+	linestream.imbue(std::locale::classic());
+	std::string line;
 	while (!stream.eof()) {
-		std::string line;
+		line.clear();
 		while (!stream.eof() && (line.size() == 0 || line[0] == '#')) {
 			std::getline(stream, line);
+			lineno++;
 			boost::trim(line);
 		}
 		if (line.size() == 0 && stream.eof()) break;
 
+		linestart.push_back(values.size());
+		linestream.clear();
+		linestream.str(line);
 		int col = 0;
-		tokenizer tokens(line, sep);
-		try {
-			for(const auto &token : tokens) {
-				double v = boost::lexical_cast<double>(token);
-				data[std::make_pair(lines, col++)] = v;
-				if (col > columns) columns = col;
-				min_val = std::min(v-1, min_val);
+		bool ok = true;
+		while (!(linestream >> std::ws).eof()) {
+			double v;
+			int next;
+			if (!(linestream >> v) || ((next = linestream.peek()) != EOF && next != ' ' && next != '\t')) {
+				ok = false;
+				break;
 			}
+			values.push_back(v);
+			col++;
+			if (col > columns) columns = col;
+			data.min_val = std::min(v-1, data.min_val);
 		}
-		catch (const boost::bad_lexical_cast &blc) {
+		if (!ok) {
 			if (!stream.eof()) {
-				PRINTB("WARNING: Illegal value in '%s': %s", filename % blc.what());
+				PRINTB("WARNING: surface(): Illegal value in '%s', line %d", filename % lineno);
 			}
+			// Values preceding the illegal one on this line are kept
+			if (col > 0) lines++;
+			else linestart.pop_back();
 			break;
-  	}
+		}
 		lines++;
 	}
-	
-	return data;
+
+	linestart.push_back(values.size());
+	data.resize(lines, columns);
+	for (int i = 0; i < lines; i++) {
+		std::copy(values.begin() + linestart[i], values.begin() + linestart[i+1], data.heights.begin() + size_t(i) * columns);
+	}
 }
 
-const Geometry *SurfaceNode::createGeometry() const
+/*!
+	Quadtree decimation of the height grid.
+
+	A block of cells becomes a single leaf if all samples inside it are within
+	the given tolerance of the bilinear patch through its four corners.
+	Leaves are triangulated as a fan around their center using every grid point
+	on their border which is a corner of some leaf, so neighbouring leaves of
+	different sizes share edges and the result stays closed.
+*/
+class SurfaceDecimator
 {
-	img_data_t data = read_png_or_dat(filename);
+public:
+	struct Block { int l0, c0, l1, c1; };
 
-	PolySet *p = new PolySet(3);
-	p->setConvexity(convexity);
-	
-	int lines = 0;
-	int columns = 0;
-	double min_val = 0;
-	for (img_data_t::iterator it = data.begin();it != data.end();it++) {
-		lines = std::max(lines, (*it).first.first + 1);
-		columns = std::max(columns, (*it).first.second + 1);
-		min_val = std::min((*it).second - 1, min_val);
+	SurfaceDecimator(const img_data_t &data, double tolerance)
+		: data(data), tolerance(tolerance), corner(size_t(data.lines) * data.columns, false) { }
+
+	void run(std::vector<Block> &leaves) {
+		if (data.lines > 1 && data.columns > 1) split(0, 0, data.lines - 1, data.columns - 1, leaves);
 	}
 
-	double ox = center ? -(columns-1)/2.0 : 0;
-	double oy = center ? -(lines-1)/2.0 : 0;
+	// Marks every grid point which is used as a mesh vertex
+	std::vector<bool> &corners() { return corner; }
 
-	for (int i = 1; i < lines; i++)
-	for (int j = 1; j < columns; j++)
-	{
-		double v1 = data[std::make_pair(i-1, j-1)];
-		double v2 = data[std::make_pair(i-1, j)];
-		double v3 = data[std::make_pair(i, j-1)];
-		double v4 = data[std::make_pair(i, j)];
-		double vx = (v1 + v2 + v3 + v4) / 4;
+private:
+	bool flat(int l0, int c0, int l1, int c1) const {
+		double h00 = data(l0, c0), h01 = data(l0, c1), h10 = data(l1, c0), h11 = data(l1, c1);
+		for (int l = l0; l <= l1; l++) {
+			double v = double(l - l0) / (l1 - l0);
+			for (int c = c0; c <= c1; c++) {
+				double u = double(c - c0) / (c1 - c0);
+				double h = (1-v) * ((1-u) * h00 + u * h01) + v * ((1-u) * h10 + u * h11);
+				if (fabs(data(l, c) - h) > tolerance) return false;
+			}
+		}
+		return true;
+	}
 
-		p->append_poly();
-		p->append_vertex(ox + j-1, oy + i-1, v1);
-		p->append_vertex(ox + j, oy + i-1, v2);
-		p->append_vertex(ox + j-0.5, oy + i-0.5, vx);
+	void split(int l0, int c0, int l1, int c1, std::vector<Block> &leaves) {
+		if ((l1 - l0 == 1 && c1 - c0 == 1) || flat(l0, c0, l1, c1)) {
+			Block b = { l0, c0, l1, c1 };
+			leaves.push_back(b);
+			corner[size_t(l0) * data.columns + c0] = true;
+			corner[size_t(l0) * data.columns + c1] = true;
+			corner[size_t(l1) * data.columns + c0] = true;
+			corner[size_t(l1) * data.columns + c1] = true;
+			return;
+		}
+		int lm = (l1 - l0 > 1) ? (l0 + l1) / 2 : l1;
+		int cm = (c1 - c0 > 1) ? (c0 + c1) / 2 : c1;
+		split(l0, c0, lm, cm, leaves);
+		if (cm < c1) split(l0, cm, lm, c1, leaves);
+		if (lm < l1) split(lm, c0, l1, cm, leaves);
+		if (lm < l1 && cm < c1) split(lm, cm, l1, c1, leaves);
+	}
 
-		p->append_poly();
-		p->append_vertex(ox + j, oy + i-1, v2);
-		p->append_vertex(ox + j, oy + i, v4);
-		p->append_vertex(ox + j-0.5, oy + i-0.5, vx);
+	const img_data_t &data;
+	double tolerance;
+	std::vector<bool> corner;
+};
 
-		p->append_poly();
-		p->append_vertex(ox + j, oy + i, v4);
-		p->append_vertex(ox + j-1, oy + i, v3);
-		p->append_vertex(ox + j-0.5, oy + i-0.5, vx);
+/*!
+	Emits a block of cells as a triangle fan around its center.
+	Only the grid points marked in used are included on the border.
+*/
+static void append_block(PolySet *p, const img_data_t &data, const std::vector<bool> &used,
+												 int l0, int c0, int l1, int c1, double ox, double oy)
+{
+	const int columns = data.columns;
+	std::vector<Vector3d> border;
+	for (int c = c0; c < c1; c++) {
+		if (used[size_t(l0) * columns + c]) border.push_back(Vector3d(ox + c, oy + l0, data(l0, c)));
+	}
+	for (int l = l0; l < l1; l++) {
+		if (used[size_t(l) * columns + c1]) border.push_back(Vector3d(ox + c1, oy + l, data(l, c1)));
+	}
+	for (int c = c1; c > c0; c--) {
+		if (used[size_t(l1) * columns + c]) border.push_back(Vector3d(ox + c, oy + l1, data(l1, c)));
+	}
+	for (int l = l1; l > l0; l--) {
+		if (used[size_t(l) * columns + c0]) border.push_back(Vector3d(ox + c0, oy + l, data(l, c0)));
+	}
 
+	double vx = (data(l0, c0) + data(l0, c1) + data(l1, c0) + data(l1, c1)) / 4;
+	Vector3d center(ox + (c0 + c1) / 2.0, oy + (l0 + l1) / 2.0, vx);
+	for (size_t k = 0; k < border.size(); k++) {
 		p->append_poly();
-		p->append_vertex(ox + j-1, oy + i, v3);
-		p->append_vertex(ox + j-1, oy + i-1, v1);
-		p->append_vertex(ox + j-0.5, oy + i-0.5, vx);
+		p->append_vertex(border[k]);
+		p->append_vertex(border[(k+1) % border.size()]);
+		p->append_vertex(center);
 	}
+}
+
+const Geometry *SurfaceNode::createGeometry() const
+{
+	img_data_t data;
+	read_png_or_dat(data, filename);
+
+	PolySet *p = new PolySet(3);
+	p->setConvexity(convexity);
+	
+	const int lines = data.lines;
+	const int columns = data.columns;
+	const double min_val = data.min_val;
+
+	double ox = center ? -(columns-1)/2.0 : 0;
+	double oy = center ? -(lines-1)/2.0 : 0;
 
-	for (int i = 1; i < lines; i++)
+	// Grid points used as vertices, all of them unless decimating
+	std::vector<bool> used;
+	if (decimate > 0) {
+		SurfaceDecimator decimator(data, decimate);
+		std::vector<SurfaceDecimator::Block> leaves;
+		decimator.run(leaves);
+		used.swap(decimator.corners());
+		if (leaves.empty()) used.assign(size_t(lines) * columns, true);
+		for (const auto &b : leaves) {
+			append_block(p, data, used, b.l0, b.c0, b.l1, b.c1, ox, oy);
+		}
+	}
+	else {
+		used.assign(size_t(lines) * columns, true);
+		if (lines > 1 && columns > 1) p->polygons.reserve(size_t(lines - 1) * (columns - 1) * 4 + 2 * (lines + columns));
+		for (int i = 1; i < lines; i++)
+		for (int j = 1; j < columns; j++) {
+			append_block(p, data, used, i-1, j-1, i, j, ox, oy);
+		}
+	}
+
+	// Side walls, connecting consecutive used border points
+	for (int left = 0, right = 0, i = 1; i < lines; i++)
 	{
-		p->append_poly();
-		p->append_vertex(ox + 0, oy + i-1, min_val);
-		p->append_vertex(ox + 0, oy + i-1, data[std::make_pair(i-1, 0)]);
-		p->append_vertex(ox + 0, oy + i, data[std::make_pair(i, 0)]);
-		p->append_vertex(ox + 0, oy + i, min_val);
+		if (used[size_t(i) * columns] || i == lines-1) {
+			p->append_poly();
+			p->append_vertex(ox + 0, oy + left, min_val);
+			p->append_vertex(ox + 0, oy + left, data(left, 0));
+			p->append_vertex(ox + 0, oy + i, data(i, 0));
+			p->append_vertex(ox + 0, oy + i, min_val);
+			left = i;
+		}
 
-		p->append_poly();
-		p->insert_vertex(ox + columns-1, oy + i-1, min_val);
-		p->insert_vertex(ox + columns-1, oy + i-1, data[std::make_pair(i-1, columns-1)]);
-		p->insert_vertex(ox + columns-1, oy + i, data[std::make_pair(i, columns-1)]);
-		p->insert_vertex(ox + columns-1, oy + i, min_val);
+		if (used[size_t(i) * columns + columns-1] || i == lines-1) {
+			p->append_poly();
+			p->insert_vertex(ox + columns-1, oy + right, min_val);
+			p->insert_vertex(ox + columns-1, oy + right, data(right, columns-1));
+			p->insert_vertex(ox + columns-1, oy + i, data(i, columns-1));
+			p->insert_vertex(ox + columns-1, oy + i, min_val);
+			right = i;
+		}
 	}
 
-	for (int i = 1; i < columns; i++)
+	for (int front = 0, back = 0, i = 1; i < columns; i++)
 	{
-		p->append_poly();
-		p->insert_vertex(ox + i-1, oy + 0, min_val);
-		p->insert_vertex(ox + i-1, oy + 0, data[std::make_pair(0, i-1)]);
-		p->insert_vertex(ox + i, oy + 0, data[std::make_pair(0, i)]);
-		p->insert_vertex(ox + i, oy + 0, min_val);
+		if (used[i] || i == columns-1) {
+			p->append_poly();
+			p->insert_vertex(ox + front, oy + 0, min_val);
+			p->insert_vertex(ox + front, oy + 0, data(0, front));
+			p->insert_vertex(ox + i, oy + 0, data(0, i));
+			p->insert_vertex(ox + i, oy + 0, min_val);
+			front = i;
+		}
 
-		p->append_poly();
-		p->append_vertex(ox + i-1, oy + lines-1, min_val);
-		p->append_vertex(ox + i-1, oy + lines-1, data[std::make_pair(lines-1, i-1)]);
-		p->append_vertex(ox + i, oy + lines-1, data[std::make_pair(lines-1, i)]);
-		p->append_vertex(ox + i, oy + lines-1, min_val);
+		if (used[size_t(lines-1) * columns + i] || i == columns-1) {
+			p->append_poly();
+			p->append_vertex(ox + back, oy + lines-1, min_val);
+			p->append_vertex(ox + back, oy + lines-1, data(lines-1, back));
+			p->append_vertex(ox + i, oy + lines-1, data(lines-1, i));
+			p->append_vertex(ox + i, oy + lines-1, min_val);
+			back = i;
+		}
 	}
 
 	if (columns > 1 && lines > 1) {
 		p->append_poly();
 		for (int i = 0; i < columns-1; i++)
-			p->insert_vertex(ox + i, oy + 0, min_val);
+			if (used[i]) p->insert_vertex(ox + i, oy + 0, min_val);
 		for (int i = 0; i < lines-1; i++)
-			p->insert_vertex(ox + columns-1, oy + i, min_val);
+			if (used[size_t(i) * columns + columns-1]) p->insert_vertex(ox + columns-1, oy + i, min_val);
 		for (int i = columns-1; i > 0; i--)
-			p->insert_vertex(ox + i, oy + lines-1, min_val);
+			if (used[size_t(lines-1) * columns + i]) p->insert_vertex(ox + i, oy + lines-1, min_val);
 		for (int i = lines-1; i > 0; i--)
-			p->insert_vertex(ox + 0, oy + i, min_val);
+			if (used[size_t(i) * columns]) p->insert_vertex(ox + 0, oy + i, min_val);
 	}
 
 	return p;
@@ -312,8 +454,9 @@ std::string SurfaceNode::toString() const
 
 	stream << this->name() << "(file = " << this->filename
 		<< ", center = " << (this->center ? "true" : "false")
-		<< ", invert = " << (this->invert ? "true" : "false")
-				 << ", " "timestamp = " << (fs::exists(path) ? fs::last_write_time(path) : 0)
+		<< ", invert = " << (this->invert ? "true" : "false");
+	if (this->decimate > 0) stream << ", decimate = " << this->decimate;
+	stream << ", " "timestamp = " << (fs::exists(path) ? fs::last_write_time(path) : 0)
 				 << ")";
 
 	return stream.str();
@@ -33,6 +33,7 @@
 #include <boost/variant/apply_visitor.hpp>
 #include <boost/variant/static_visitor.hpp>
 #include <boost/format.hpp>
+#include <Eigen/Core>
 #include "boost-utils.h"
 #include "boosty.h"
 /*Unicode support for string lengths and array accesses*/
@@ -41,6 +42,75 @@
 Value Value::undefined;
 ValuePtr ValuePtr::undefined;
 
+// Index of NumberVectorPtr in Value::Variant
+static const int NUMBERVECTOR_INDEX = 6;
+
+typedef Eigen::Map<const Eigen::ArrayXd> ConstArrayMap;
+typedef Eigen::Map<Eigen::ArrayXd> ArrayMap;
+
+NumberVector::NumberVector(std::vector<double> &&numbers, std::vector<ValuePtr> &&boxed)
+	: numbers(std::move(numbers))
+{
+	std::call_once(this->boxed_flag, [&]() { this->boxed_values = std::move(boxed); });
+}
+
+const std::vector<ValuePtr> &NumberVector::boxed() const
+{
+	std::call_once(this->boxed_flag, [this]() {
+			this->boxed_values.reserve(this->numbers.size());
+			for (double d : this->numbers) this->boxed_values.push_back(ValuePtr(d));
+		});
+	return this->boxed_values;
+}
+
+// Vectors of boxed numbers longer than this stay boxed, so they aren't
+// stored twice. Vectors built element by element are packed at any size.
+static const size_t MAX_REPACKED_SIZE = 64;
+
+// Short vectors consisting only of numbers are packed, keeping the boxed
+// elements for toVector()
+static Value::Variant pack_vector(Value::VectorType &&v)
+{
+	if (v.empty() || v.size() > MAX_REPACKED_SIZE) return std::move(v);
+	std::vector<double> numbers;
+	numbers.reserve(v.size());
+	for (const auto &val : v) {
+		if (val->type() != Value::NUMBER) return std::move(v);
+		numbers.push_back(val->toDouble());
+	}
+	return Value::NumberVectorPtr(make_shared<NumberVector>(std::move(numbers), std::move(v)));
+}
+
+static Value::Variant pack_vector(const Value::VectorType &v)
+{
+	return pack_vector(Value::VectorType(v));
+}
+
+static Value::Variant pack_vector(std::vector<double> &&v)
+{
+	if (v.empty()) return Value::VectorType();
+	return Value::NumberVectorPtr(make_shared<NumberVector>(std::move(v)));
+}
+
+// Applies op elementwise to the first min(a.size(), b.size()) elements
+template <typename Op>
+static Value packed_binary(const std::vector<double> &a, const std::vector<double> &b, Op op)
+{
+	size_t n = std::min(a.size(), b.size());
+	std::vector<double> result(n);
+	ArrayMap(result.data(), n) = op(ConstArrayMap(a.data(), n), ConstArrayMap(b.data(), n));
+	return Value(std::move(result));
+}
+
+// True if all rows of the matrix are packed
+static bool packed_rows(const Value::VectorType &matrix)
+{
+	for (const auto &row : matrix) {
+		if (!row->toNumbers()) return false;
+	}
+	return !matrix.empty();
+}
+
 static uint32_t convert_to_uint32(const double d) {
     uint32_t ret = std::numeric_limits<uint32_t>::max();
 
@@ -126,11 +196,19 @@ Value::Value(char v) : value(std::string(1, v))
   //  std::cout << "creating string from char\n";
 }
 
-Value::Value(const VectorType &v) : value(v)
+Value::Value(const VectorType &v) : value(pack_vector(v))
 {
   //  std::cout << "creating vector\n";
 }
 
+Value::Value(VectorType &&v) : value(pack_vector(std::move(v)))
+{
+}
+
+Value::Value(std::vector<double> &&v) : value(pack_vector(std::move(v)))
+{
+}
+
 Value::Value(const RangeType &v) : value(v)
 {
   //  std::cout << "creating range\n";
@@ -138,7 +216,8 @@ Value::Value(const RangeType &v) : value(v)
 
 Value::ValueType Value::type() const
 {
-  return static_cast<ValueType>(this->value.which());
+  int which = this->value.which();
+  return which == NUMBERVECTOR_INDEX ? VECTOR : static_cast<ValueType>(which);
 }
 
 bool Value::isDefined() const
@@ -169,7 +248,8 @@ bool Value::toBool() const
     return boost::get<std::string>(this->value).size() > 0;
     break;
   case VECTOR:
-    return boost::get<VectorType >(this->value).size() > 0;
+    // Packed vectors are never empty
+    return toNumbers() || boost::get<VectorType >(this->value).size() > 0;
     break;
   case RANGE:
     return true;
@@ -252,6 +332,17 @@ public:
     return stream.str();
   }
 
+  std::string operator()(const Value::NumberVectorPtr &v) const {
+    std::stringstream stream;
+    stream << '[';
+    for (size_t i = 0; i < v->values().size(); i++) {
+      if (i > 0) stream << ", ";
+      stream << (*this)(v->values()[i]);
+    }
+    stream << ']';
+    return stream.str();
+  }
+
   std::string operator()(const RangeType &v) const {
     return (boost::format("[%1% : %2% : %3%]") % v.begin_val % v.step_val % v.end_val).str();
   }
@@ -295,6 +386,13 @@ public:
 		return stream.str();
 	}
 
+	std::string operator()(const Value::NumberVectorPtr &v) const
+	{
+		std::stringstream stream;
+		for (double d : v->values()) stream << (*this)(d);
+		return stream.str();
+	}
+
 	std::string operator()(const RangeType &v) const
 	{
 		const uint32_t steps = v.numValues();
@@ -324,13 +422,35 @@ const Value::VectorType &Value::toVector() const
   
   const VectorType *v = boost::get<VectorType>(&this->value);
   if (v) return *v;
+  const NumberVectorPtr *packed = boost::get<NumberVectorPtr>(&this->value);
+  if (packed) return (*packed)->boxed();
   else return empty;
 }
 
+/*!
+  Returns the numbers of a packed vector, or NULL if this isn't one.
+  Vectors of numbers are usually packed, but long ones made from boxed
+  elements aren't, so callers need to handle both forms.
+*/
+const std::vector<double> *Value::toNumbers() const
+{
+  const NumberVectorPtr *packed = boost::get<NumberVectorPtr>(&this->value);
+  return packed ? &(*packed)->values() : NULL;
+}
+
 bool Value::getVec2(double &x, double &y, bool ignoreInfinite) const
 {
   if (this->type() != VECTOR) return false;
 
+  const std::vector<double> *numbers = toNumbers();
+  if (numbers) {
+    if (numbers->size() != 2) return false;
+    if (ignoreInfinite && !(std::isfinite((*numbers)[0]) && std::isfinite((*numbers)[1]))) return false;
+    x = (*numbers)[0];
+    y = (*numbers)[1];
+    return true;
+  }
+
   const VectorType &v = toVector();
   
   if (v.size() != 2) return false;
@@ -352,6 +472,15 @@ bool Value::getVec3(double &x, double &y, double &z, double defaultval) const
 {
   if (this->type() != VECTOR) return false;
 
+  const std::vector<double> *numbers = toNumbers();
+  if (numbers) {
+    if (numbers->size() != 2 && numbers->size() != 3) return false;
+    x = (*numbers)[0];
+    y = (*numbers)[1];
+    z = numbers->size() == 3 ? (*numbers)[2] : defaultval;
+    return true;
+  }
+
   const VectorType &v = toVector();
 
   if (v.size() == 2) {
@@ -393,6 +522,23 @@ public:
   template <typename T> bool operator()(const T &op1, const T &op2) const {
     return op1 == op2;
   }
+
+  bool operator()(const Value::NumberVectorPtr &op1, const Value::NumberVectorPtr &op2) const {
+    return op1->values() == op2->values();
+  }
+
+  bool operator()(const Value::NumberVectorPtr &op1, const Value::VectorType &op2) const {
+    const std::vector<double> &numbers = op1->values();
+    if (numbers.size() != op2.size()) return false;
+    for (size_t i = 0; i < numbers.size(); i++) {
+      if (op2[i]->type() != Value::NUMBER || numbers[i] != op2[i]->toDouble()) return false;
+    }
+    return true;
+  }
+
+  bool operator()(const Value::VectorType &op1, const Value::NumberVectorPtr &op2) const {
+    return (*this)(op2, op1);
+  }
 };
 
 bool Value::operator==(const Value &v) const
@@ -477,6 +623,19 @@ public:
     }
     return Value(sum);
   }
+
+  Value operator()(const Value::NumberVectorPtr &op1, const Value::NumberVectorPtr &op2) const {
+    return packed_binary(op1->values(), op2->values(),
+                         [](const ConstArrayMap &a, const ConstArrayMap &b) { return a + b; });
+  }
+
+  Value operator()(const Value::NumberVectorPtr &op1, const Value::VectorType &op2) const {
+    return (*this)(op1->boxed(), op2);
+  }
+
+  Value operator()(const Value::VectorType &op1, const Value::NumberVectorPtr &op2) const {
+    return (*this)(op1, op2->boxed());
+  }
 };
 
 Value Value::operator+(const Value &v) const
@@ -502,6 +661,19 @@ public:
     }
     return Value(sum);
   }
+
+  Value operator()(const Value::NumberVectorPtr &op1, const Value::NumberVectorPtr &op2) const {
+    return packed_binary(op1->values(), op2->values(),
+                         [](const ConstArrayMap &a, const ConstArrayMap &b) { return a - b; });
+  }
+
+  Value operator()(const Value::NumberVectorPtr &op1, const Value::VectorType &op2) const {
+    return (*this)(op1->boxed(), op2);
+  }
+
+  Value operator()(const Value::VectorType &op1, const Value::NumberVectorPtr &op2) const {
+    return (*this)(op1, op2->boxed());
+  }
 };
 
 Value Value::operator-(const Value &v) const
@@ -512,6 +684,13 @@ Value Value::operator-(const Value &v) const
 Value Value::multvecnum(const Value &vecval, const Value &numval)
 {
   // Vector * Number
+  const std::vector<double> *numbers = vecval.toNumbers();
+  if (numbers) {
+    std::vector<double> result(numbers->size());
+    ArrayMap(result.data(), result.size()) = ConstArrayMap(numbers->data(), numbers->size()) * numval.toDouble();
+    return Value(std::move(result));
+  }
+
   VectorType dstv;
   for(const auto &val : vecval.toVector()) {
     dstv.push_back(ValuePtr(*val * numval));
@@ -540,6 +719,40 @@ Value Value::multmatvec(const VectorType &matrixvec, const VectorType &vectorvec
   return Value(dstv);
 }
 
+/*!
+  Matrix * Vector for packed vectors. The rows must have the vector's size.
+*/
+Value Value::multmatvec(const VectorType &matrixvec, const std::vector<double> &vectorvec)
+{
+  std::vector<double> dstv;
+  dstv.reserve(matrixvec.size());
+  for (const auto &row : matrixvec) {
+    const std::vector<double> *rowvec = row->toNumbers();
+    if (!rowvec || rowvec->size() != vectorvec.size()) return Value();
+    // Accumulate in order, for results identical to the boxed version
+    double r_e = 0.0;
+    for (size_t j = 0; j < vectorvec.size(); j++) r_e += (*rowvec)[j] * vectorvec[j];
+    dstv.push_back(r_e);
+  }
+  return Value(std::move(dstv));
+}
+
+/*!
+  Vector * Matrix for a packed vector and a matrix with packed rows.
+*/
+Value Value::multvecmat(const std::vector<double> &vectorvec, const VectorType &matrixvec)
+{
+  assert(vectorvec.size() == matrixvec.size());
+  size_t cols = matrixvec[0]->toNumbers()->size();
+  Eigen::ArrayXd dstv = Eigen::ArrayXd::Zero(cols);
+  for (size_t j = 0; j < vectorvec.size(); j++) {
+    const std::vector<double> &rowvec = *matrixvec[j]->toNumbers();
+    if (rowvec.size() < cols) return Value::undefined;
+    dstv += vectorvec[j] * ConstArrayMap(rowvec.data(), cols);
+  }
+  return Value(std::vector<double>(dstv.data(), dstv.data() + cols));
+}
+
 Value Value::multvecmat(const VectorType &vectorvec, const VectorType &matrixvec)
 {
   assert(vectorvec.size() == matrixvec.size());
@@ -572,6 +785,40 @@ Value Value::operator*(const Value &v) const
     return multvecnum(v, *this);
   }
   else if (this->type() == VECTOR && v.type() == VECTOR) {
+    const std::vector<double> *numbers1 = this->toNumbers();
+    const std::vector<double> *numbers2 = v.toNumbers();
+    if (numbers1 && numbers2) {
+      if (numbers1->size() != numbers2->size()) return Value::undefined;
+      // Vector dot product, accumulated in order
+      double r = 0.0;
+      for (size_t i = 0; i < numbers1->size(); i++) r += (*numbers1)[i] * (*numbers2)[i];
+      return Value(r);
+    }
+    if (!numbers1 && numbers2) {
+      const VectorType &matrix = this->toVector();
+      const std::vector<double> *row0 = matrix.empty() ? NULL : matrix[0]->toNumbers();
+      if (row0 && row0->size() == numbers2->size()) return multmatvec(matrix, *numbers2);
+    }
+    else if (numbers1 && !numbers2) {
+      const VectorType &matrix = v.toVector();
+      if (matrix.size() == numbers1->size() && packed_rows(matrix)) return multvecmat(*numbers1, matrix);
+    }
+    else {
+      const VectorType &matrix1 = this->toVector();
+      const VectorType &matrix2 = v.toVector();
+      if (packed_rows(matrix1) && packed_rows(matrix2) &&
+          matrix1[0]->toNumbers()->size() == matrix2.size()) {
+        // Matrix * Matrix
+        VectorType dstv;
+        for (const auto &srcrow : matrix1) {
+          const std::vector<double> &srcrowvec = *srcrow->toNumbers();
+          if (srcrowvec.size() != matrix2.size()) return Value::undefined;
+          dstv.push_back(ValuePtr(multvecmat(srcrowvec, matrix2)));
+        }
+        return Value(dstv);
+      }
+    }
+
     const VectorType &vec1 = this->toVector();
     const VectorType &vec2 = v.toVector();
 		if (vec1.size() == 0 || vec2.size() == 0) return Value::undefined;
@@ -614,6 +861,12 @@ Value Value::operator/(const Value &v) const
     return Value(this->toDouble() / v.toDouble());
   }
   else if (this->type() == VECTOR && v.type() == NUMBER) {
+    const std::vector<double> *numbers = this->toNumbers();
+    if (numbers) {
+      std::vector<double> result(numbers->size());
+      ArrayMap(result.data(), result.size()) = ConstArrayMap(numbers->data(), numbers->size()) / v.toDouble();
+      return Value(std::move(result));
+    }
     const VectorType &vec = this->toVector();
     VectorType dstv;
     for(const auto &vecval : vec) {
@@ -622,6 +875,12 @@ Value Value::operator/(const Value &v) const
     return Value(dstv);
   }
   else if (this->type() == NUMBER && v.type() == VECTOR) {
+    const std::vector<double> *numbers = v.toNumbers();
+    if (numbers) {
+      std::vector<double> result(numbers->size());
+      for (size_t i = 0; i < result.size(); i++) result[i] = this->toDouble() / (*numbers)[i];
+      return Value(std::move(result));
+    }
     const VectorType &vec = v.toVector();
     VectorType dstv;
     for(const auto &vecval : vec) {
@@ -646,6 +905,12 @@ Value Value::operator-() const
     return Value(-this->toDouble());
   }
   else if (this->type() == VECTOR) {
+    const std::vector<double> *numbers = this->toNumbers();
+    if (numbers) {
+      std::vector<double> result(numbers->size());
+      ArrayMap(result.data(), result.size()) = -ConstArrayMap(numbers->data(), numbers->size());
+      return Value(std::move(result));
+    }
     const VectorType &vec = this->toVector();
     VectorType dstv;
     for(const auto &vecval : vec) {
@@ -700,6 +965,12 @@ public:
     return Value::undefined;
   }
 
+  Value operator()(const Value::NumberVectorPtr &vec, const double &idx) const {
+    const uint32_t i = convert_to_uint32(idx);
+    if (i < vec->values().size()) return Value(vec->values()[i]);
+    return Value::undefined;
+  }
+
   Value operator()(const RangeType &range, const double &idx) const {
     const uint32_t i = convert_to_uint32(idx);
     switch(i) {
@@ -869,6 +1140,16 @@ ValuePtr::ValuePtr(const Value::VectorType &v)
 	this->reset(new Value(v));
 }
 
+ValuePtr::ValuePtr(std::vector<ValuePtr> &&v)
+{
+	this->reset(new Value(std::move(v)));
+}
+
+ValuePtr::ValuePtr(std::vector<double> &&v)
+{
+	this->reset(new Value(std::move(v)));
+}
+
 ValuePtr::ValuePtr(const RangeType &v)
 {
 	this->reset(new Value(v));
@@ -953,3 +1234,53 @@ const Value &ValuePtr::operator*() const
 {
 	return *this->get();
 }
+
+// Grows a vector for n more elements, keeping the growth geometric
+template <typename T>
+static void reserve_more(std::vector<T> &vec, size_t n)
+{
+	if (vec.size() + n > vec.capacity()) vec.reserve(std::max(vec.size() + n, 2 * vec.capacity()));
+}
+
+/*!
+	Makes room for n more elements. This is only a hint: Large requests are
+	capped, so a bad estimate doesn't allocate a huge buffer up front.
+*/
+void VectorBuilder::reserve(size_t n)
+{
+	n = std::min(n, size_t(1) << 20);
+	if (this->packed) reserve_more(this->numbers, n);
+	else reserve_more(this->values, n);
+}
+
+void VectorBuilder::push_back(double d)
+{
+	if (this->packed) this->numbers.push_back(d);
+	else this->values.push_back(ValuePtr(d));
+}
+
+void VectorBuilder::push_back(const ValuePtr &v)
+{
+	if (this->packed) {
+		if (v->type() == Value::NUMBER) {
+			this->numbers.push_back(v->toDouble());
+			return;
+		}
+		unpack();
+	}
+	this->values.push_back(v);
+}
+
+void VectorBuilder::unpack()
+{
+	this->values.reserve(this->numbers.capacity());
+	for (double d : this->numbers) this->values.push_back(ValuePtr(d));
+	this->numbers = std::vector<double>();
+	this->packed = false;
+}
+
+ValuePtr VectorBuilder::build()
+{
+	if (this->packed) return ValuePtr(std::move(this->numbers));
+	return ValuePtr(std::move(this->values));
+}
@@ -4,6 +4,7 @@
 #include <string>
 #include <algorithm>
 #include <limits>
+#include <mutex>
 
 // Workaround for https://bugreports.qt-project.org/browse/QTBUG-22829
 #ifndef Q_MOC_RUN
@@ -109,6 +110,8 @@ public:
   ValuePtr(const char *v);
   ValuePtr(const char v);
   ValuePtr(const class std::vector<ValuePtr> &v);
+  ValuePtr(std::vector<ValuePtr> &&v);
+  ValuePtr(std::vector<double> &&v);
   ValuePtr(const class RangeType &v);
 
 	operator bool() const;
@@ -133,10 +136,34 @@ public:
 private:
 };
 
+/*!
+	Contiguous storage for vectors consisting only of numbers.
+
+	Values holding a NumberVector still have type VECTOR. toVector() boxes
+	the elements on first use, so code which doesn't know about the packed
+	form keeps working, while arithmetic, indexing and most builtins use
+	the numbers directly. Vectors packed from boxed elements keep those.
+*/
+class NumberVector
+{
+public:
+	NumberVector(std::vector<double> &&numbers) : numbers(std::move(numbers)) {}
+	NumberVector(std::vector<double> &&numbers, std::vector<ValuePtr> &&boxed);
+
+	const std::vector<double> &values() const { return this->numbers; }
+	const std::vector<ValuePtr> &boxed() const;
+
+private:
+	std::vector<double> numbers;
+	mutable std::once_flag boxed_flag;
+	mutable std::vector<ValuePtr> boxed_values;
+};
+
 class Value
 {
 public:
 	typedef std::vector<ValuePtr> VectorType;
+	typedef shared_ptr<const NumberVector> NumberVectorPtr;
 
   enum ValueType {
     UNDEFINED,
@@ -156,6 +183,8 @@ public:
   Value(const char *v);
   Value(const char v);
   Value(const VectorType &v);
+  Value(VectorType &&v);
+  Value(std::vector<double> &&v);
   Value(const RangeType &v);
   ~Value() {}
 
@@ -171,6 +200,7 @@ public:
   std::string toString() const;
   std::string chrString() const;
   const VectorType &toVector() const;
+  const std::vector<double> *toNumbers() const;
   bool getVec2(double &x, double &y, bool ignoreInfinite = false) const;
   bool getVec3(double &x, double &y, double &z, double defaultval = 0.0) const;
   RangeType toRange() const;
@@ -198,13 +228,39 @@ public:
     return stream;
   }
 
-  typedef boost::variant< boost::blank, bool, double, std::string, VectorType, RangeType > Variant;
+  // NumberVectorPtr is the packed form of VectorType, both have type VECTOR
+  typedef boost::variant< boost::blank, bool, double, std::string, VectorType, RangeType, NumberVectorPtr > Variant;
 
 private:
   static Value multvecnum(const Value &vecval, const Value &numval);
   static Value multmatvec(const VectorType &matrixvec, const VectorType &vectorvec);
+  static Value multmatvec(const VectorType &matrixvec, const std::vector<double> &vectorvec);
+  static Value multvecmat(const std::vector<double> &vectorvec, const VectorType &matrixvec);
   static Value multvecmat(const VectorType &vectorvec, const VectorType &matrixvec);
 
   Variant value;
 };
 
+/*!
+	Builds a vector value element by element. Numbers are stored packed until
+	the first element which isn't a number, so vectors of numbers never have
+	their elements boxed.
+*/
+class VectorBuilder
+{
+public:
+	VectorBuilder() : packed(true) {}
+
+	void reserve(size_t n);
+	void push_back(double d);
+	void push_back(const ValuePtr &v);
+	ValuePtr build();
+
+private:
+	void unpack();
+
+	bool packed;
+	std::vector<double> numbers;
+	Value::VectorType values;
+};
+
@@ -0,0 +1,99 @@
+#!/usr/bin/env python
+
+# Benchmark driver
+#
+#
+# Usage: <script> <inputfile> --openscad=<executable-path> [--format=<format>] [--runs=<n>] [--server] [openscad args]
+#
+#
+# Runs OpenSCAD on the input file <n> times, exporting to the given format,
+# and reports the minimum and median wall clock time of the runs.
+# The exported file is written to a temporary location and discarded.
+#
+# With --server, a single 'openscad --server' process runs all the exports
+# as jobs, and the latency of each job is measured instead. The first job
+# starts with cold caches, so it is reported separately.
+#
+# Benchmarks don't compare output; they only fail if OpenSCAD fails.
+# The timing is printed in a fixed format so it can be collected from the
+# CTest logs: "BENCHMARK <name> runs=<n> min=<seconds> median=<seconds>"
+#
+# This script should return 0 on success, not-0 on error.
+#
+
+import sys, os, subprocess, argparse, tempfile, time
+
+def failquit(*args):
+	if len(args)!=0: print(args)
+	print('benchmark args:',str(sys.argv))
+	print('exiting benchmark.py with failure')
+	sys.exit(1)
+
+#
+# Parse arguments
+#
+parser = argparse.ArgumentParser()
+parser.add_argument('--openscad', required=True, help='Specify OpenSCAD executable')
+parser.add_argument('--format', default='stl', help='Export format used for the timed runs')
+parser.add_argument('--runs', type=int, default=3, help='Number of timed runs')
+parser.add_argument('--server', action='store_true', help='Run the exports as jobs of one server process')
+args,remaining_args = parser.parse_known_args()
+
+inputfile = remaining_args[0]
+remaining_args = remaining_args[1:]
+name = os.path.splitext(os.path.basename(inputfile))[0]
+
+if not os.path.exists(inputfile):
+	failquit('cant find input file named: ' + inputfile)
+if not os.path.exists(args.openscad):
+	failquit('cant find openscad executable named: ' + args.openscad)
+
+fd, outputfile = tempfile.mkstemp(suffix='.' + args.format)
+os.close(fd)
+
+def run_server():
+	cmdline = [args.openscad, '--server'] + remaining_args
+	print('Running OpenSCAD server:')
+	print(' '.join(cmdline))
+	sys.stdout.flush()
+	server = subprocess.Popen(cmdline, stdin=subprocess.PIPE, stdout=subprocess.PIPE, universal_newlines=True)
+	times = []
+	try:
+		for i in range(max(args.runs, 1) + 1):
+			start = time.time()
+			server.stdin.write('-o "%s" "%s"\n' % (outputfile, inputfile))
+			server.stdin.flush()
+			while True:
+				line = server.stdout.readline()
+				if not line: failquit('OpenSCAD server exited unexpectedly')
+				if line.startswith('done '): break
+			elapsed = time.time() - start
+			if line.split()[1] != '0':
+				failquit('OpenSCAD job failed with status ' + line.split()[1])
+			if i == 0: print('First job: %.3f' % elapsed)
+			else: times.append(elapsed)
+	finally:
+		server.stdin.close()
+		server.wait()
+	return times
+
+times = []
+try:
+	if args.server: times = run_server()
+	for i in range(0 if args.server else max(args.runs, 1)):
+		cmdline = [args.openscad, inputfile, '-o', outputfile] + remaining_args
+		print('Running OpenSCAD #' + str(i+1) + ':')
+		print(' '.join(cmdline))
+		sys.stdout.flush()
+		start = time.time()
+		result = subprocess.call(cmdline)
+		elapsed = time.time() - start
+		if result != 0:
+			failquit('OpenSCAD failed with return code ' + str(result))
+		times.append(elapsed)
+finally:
+	if os.path.exists(outputfile): os.remove(outputfile)
+
+times.sort()
+print('BENCHMARK %s runs=%d min=%.3f median=%.3f' % (name, len(times), times[0], times[len(times)//2]))
+sys.exit(0)
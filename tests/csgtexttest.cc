@@ -38,11 +38,13 @@
 #include "Tree.h"
 #include "PlatformUtils.h"
 #include "stackcheck.h"
+#include "feature.h"
 
 #ifndef _MSC_VER
 #include <getopt.h>
 #endif
 #include <assert.h>
+#include <string.h>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -64,13 +66,18 @@ void csgTree(CSGTextCache &cache, const AbstractNode &root)
 
 int main(int argc, char **argv)
 {
-	if (argc != 3) {
-		fprintf(stderr, "Usage: %s <file.scad> <output.txt>\n", argv[0]);
+	std::vector<const char *> args;
+	for (int i = 1; i < argc; i++) {
+		if (!strncmp(argv[i], "--enable=", 9)) Feature::enable_feature(argv[i] + 9);
+		else args.push_back(argv[i]);
+	}
+	if (args.size() != 2) {
+		fprintf(stderr, "Usage: %s [--enable=<feature>]... <file.scad> <output.txt>\n", argv[0]);
 		exit(1);
 	}
 
-	const char *filename = argv[1];
-	const char *outfilename = argv[2];
+	const char *filename = args[0];
+	const char *outfilename = args[1];
 
 	int rc = 0;
 
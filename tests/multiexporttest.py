@@ -0,0 +1,72 @@
+#!/usr/bin/env python
+
+# Multiple export test
+#
+#
+# Usage: <script> <inputfile> --openscad=<executable-path> --format=<format> [--format=<format> ..] [<openscad args>] file.<suffix>
+#
+#
+# step 1. Run OpenSCAD once on the input file with an -o option for the given
+#         file and for each given format
+# step 2. Run OpenSCAD once for each of these files with only its -o option
+# step 3. Fail if any file from step 1 differs from the one written in step 2
+# step 4. (done in CTest) - compare the given file to the expected output
+#
+# All the optional openscad args are passed on to OpenSCAD.
+#
+# This script should return 0 on success, not-0 on error.
+#
+
+import sys, os, shutil, subprocess, tempfile, argparse
+
+def failquit(*args):
+	if len(args)!=0: print(args)
+	print('multiexporttest args:',str(sys.argv))
+	print('exiting multiexporttest.py with failure')
+	sys.exit(1)
+
+def run_openscad(outputfiles):
+	cmd = [args.openscad, inputfile] + remaining_args
+	for outputfile in outputfiles: cmd += ['-o', outputfile]
+	print('Running OpenSCAD:')
+	print(' '.join(cmd))
+	result = subprocess.call(cmd)
+	if result != 0:
+		shutil.rmtree(tmpdir)
+		failquit('OpenSCAD failed with return code ' + str(result))
+
+def read_file(filename):
+	with open(filename, 'rb') as f: return f.read()
+
+#
+# Parse arguments
+#
+parser = argparse.ArgumentParser()
+parser.add_argument('--openscad', required=True, help='Specify OpenSCAD executable')
+parser.add_argument('--format', required=True, action='append', help='Specify an additional export format')
+args,remaining_args = parser.parse_known_args()
+
+inputfile = remaining_args[0]
+outputfile = remaining_args[-1]
+remaining_args = remaining_args[1:-1] # Passed on to the OpenSCAD executable
+
+if not os.path.exists(inputfile):
+	failquit('cant find input file named: ' + inputfile)
+if not os.path.exists(args.openscad):
+	failquit('cant find openscad executable named: ' + args.openscad)
+
+outputsuffix = os.path.splitext(outputfile)[1][1:]
+formats = [outputsuffix] + [f.lower() for f in args.format if f.lower() != outputsuffix]
+
+tmpdir = tempfile.mkdtemp(dir=os.path.dirname(os.path.abspath(outputfile)))
+multifiles = [os.path.join(tmpdir, 'multi.' + f) for f in formats]
+run_openscad(multifiles)
+for f, multifile in zip(formats, multifiles):
+	singlefile = os.path.join(tmpdir, 'single.' + f)
+	run_openscad([singlefile])
+	if read_file(multifile) != read_file(singlefile):
+		shutil.rmtree(tmpdir)
+		failquit('The ' + f + ' file differs from the one written with a single -o option')
+
+shutil.copyfile(multifiles[0], outputfile)
+shutil.rmtree(tmpdir)
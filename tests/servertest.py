@@ -0,0 +1,160 @@
+#!/usr/bin/env python
+
+# Server mode test
+#
+#
+# Usage: <script> <inputfile> --openscad=<executable-path> --job=<job args> [--job=<job args> ..] [--library=<file> ..] [--socket] [<openscad args>] file.txt
+#
+#
+# step 1. Copy the input file to an empty directory and start 'openscad --server'
+#         there, with the optional openscad args
+# step 2. Send each job, followed by the name of the input file, and read the
+#         messages of the job up to its "done" line
+# step 3. Write the messages, the return code of the server and the contents
+#         of every file the jobs wrote, in the order of their names, to the
+#         given file
+# step 4. (done in CTest) - compare the given file to the expected output
+#
+# With --library, the given files are written to a subdirectory, and found
+# through symbolic links in another one, which is put in OPENSCADPATH.
+# Before each job, libraries containing {job} are rewritten with it replaced
+# by the number of the job, so the test shows whether the server notices
+# changes made to the target of a link. Other libraries are written once.
+#
+# With --socket, the server listens on a Unix socket, and every job is sent
+# on a connection of its own. The client of the first job disconnects right
+# after sending it, without reading any messages; the server has to finish
+# that job and keep serving the others. "quit" is sent on a last connection.
+#
+# Paths of the temporary directory are removed from the messages and files.
+#
+# This script should return 0 on success, not-0 on error.
+#
+
+import sys, os, shutil, subprocess, tempfile, argparse, time, socket
+
+def failquit(*args):
+	if len(args)!=0: print(args)
+	print('servertest args:',str(sys.argv))
+	print('exiting servertest.py with failure')
+	sys.exit(1)
+
+def write_library(library, job):
+	target = os.path.join(tmpdir, 'target', os.path.basename(library))
+	with open(library) as f: text = f.read()
+	if '{job}' not in text and os.path.exists(target): return
+	with open(target, 'w') as f: f.write(text.replace('{job}', str(job)))
+	# Timestamps may have a resolution of seconds, make sure this one changes
+	t = time.time() + job
+	os.utime(target, (t, t))
+
+def read_messages(readline, messages):
+	while True:
+		message = readline()
+		if not message: failquit('OpenSCAD server exited unexpectedly')
+		message = message.rstrip('\n')
+		if message.startswith('Could not initialize localization'): continue
+		messages.append(message.replace(tmpdir + os.sep, ''))
+		if message.startswith('done '): return messages
+
+def run_job(server, job, line):
+	for library in args.library: write_library(library, job)
+	messages = ['job %d: %s' % (job, line)]
+	server.stdin.write(line + '\n')
+	server.stdin.flush()
+	return read_messages(server.stdout.readline, messages)
+
+def connect():
+	# The server may still be starting up
+	for attempt in range(300):
+		if server.poll() is not None: failquit('OpenSCAD server exited unexpectedly')
+		client = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+		try:
+			client.connect(socketpath)
+			return client
+		except socket.error:
+			client.close()
+			time.sleep(0.1)
+	failquit('cant connect to the OpenSCAD server')
+
+def run_socket_job(job, line):
+	for library in args.library: write_library(library, job)
+	client = connect()
+	client.sendall((line + '\n').encode())
+	if job == 1:
+		client.close()
+		return ['job %d: %s' % (job, line), 'disconnected']
+	reader = client.makefile('r')
+	messages = read_messages(reader.readline, ['job %d: %s' % (job, line)])
+	reader.close()
+	client.close()
+	return messages
+
+#
+# Parse arguments
+#
+parser = argparse.ArgumentParser()
+parser.add_argument('--openscad', required=True, help='Specify OpenSCAD executable')
+parser.add_argument('--job', required=True, action='append', help='Specify the arguments of a job')
+parser.add_argument('--library', action='append', default=[], help='Specify a library to link into the library path')
+parser.add_argument('--socket', action='store_true', help='Send the jobs on connections to a Unix socket')
+args,remaining_args = parser.parse_known_args()
+
+inputfile = os.path.abspath(remaining_args[0])
+outputfile = os.path.abspath(remaining_args[-1])
+remaining_args = remaining_args[1:-1] # Passed on to the OpenSCAD executable
+
+if not os.path.exists(inputfile):
+	failquit('cant find input file named: ' + inputfile)
+if not os.path.exists(args.openscad):
+	failquit('cant find openscad executable named: ' + args.openscad)
+for library in args.library:
+	if not os.path.exists(library):
+		failquit('cant find library named: ' + library)
+
+tmpdir = tempfile.mkdtemp(dir=os.path.dirname(outputfile))
+inputname = os.path.basename(inputfile)
+shutil.copy(inputfile, os.path.join(tmpdir, inputname))
+env = dict(os.environ)
+if args.library:
+	os.mkdir(os.path.join(tmpdir, 'target'))
+	os.mkdir(os.path.join(tmpdir, 'libraries'))
+	for library in args.library:
+		os.symlink(os.path.join('..', 'target', os.path.basename(library)), os.path.join(tmpdir, 'libraries', os.path.basename(library)))
+	env['OPENSCADPATH'] = os.path.join(tmpdir, 'libraries')
+
+# Socket paths are limited to about 100 characters, so the socket doesn't
+# go into the build directory
+socketdir = tempfile.mkdtemp()
+socketpath = os.path.join(socketdir, 'server.socket')
+
+cmd = [args.openscad, '--server=' + socketpath if args.socket else '--server'] + remaining_args
+print('Running OpenSCAD server:')
+print(' '.join(cmd))
+
+messages = []
+server = subprocess.Popen(cmd, cwd=tmpdir, env=env, stdin=subprocess.PIPE, stdout=subprocess.PIPE, universal_newlines=True)
+if args.socket:
+	for job, line in enumerate(args.job):
+		messages += run_socket_job(job + 1, line + ' ' + inputname)
+	client = connect()
+	client.sendall('quit\n'.encode())
+	client.close()
+	server.stdin.close()
+else:
+	for job, line in enumerate(args.job):
+		messages += run_job(server, job + 1, line + ' ' + inputname)
+	server.stdin.write('quit\n')
+	server.stdin.close()
+messages.append('return code: ' + str(server.wait()))
+print('\n'.join(messages))
+
+with open(outputfile, 'w') as f:
+	for message in messages: f.write(message + '\n')
+	for name in sorted(os.listdir(tmpdir)):
+		if name in [inputname, 'target', 'libraries']: continue
+		f.write('\n' + name + ':\n')
+		with open(os.path.join(tmpdir, name)) as written: f.write(written.read().replace(tmpdir + os.sep, ''))
+
+shutil.rmtree(tmpdir)
+shutil.rmtree(socketdir)
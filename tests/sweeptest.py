@@ -0,0 +1,69 @@
+#!/usr/bin/env python
+
+# Parameter sweep test
+#
+#
+# Usage: <script> <inputfile> --openscad=<executable-path> --sweep=<file.csv|file.json> --output=<pattern> [--output=<pattern> ..] [<openscad args>] file.txt
+#
+#
+# step 1. Run OpenSCAD in an empty directory on the input file with --sweep
+#         and an -o option for each given output file name pattern
+# step 2. Write its console output, without the input file's directory, its
+#         return code and the contents of every file it wrote, in the order
+#         of their names, to the given file
+# step 3. (done in CTest) - compare the given file to the expected output
+#
+# All the optional openscad args are passed on to OpenSCAD.
+#
+# This script should return 0 on success, not-0 on error.
+#
+
+import sys, os, shutil, subprocess, tempfile, argparse
+
+def failquit(*args):
+	if len(args)!=0: print(args)
+	print('sweeptest args:',str(sys.argv))
+	print('exiting sweeptest.py with failure')
+	sys.exit(1)
+
+#
+# Parse arguments
+#
+parser = argparse.ArgumentParser()
+parser.add_argument('--openscad', required=True, help='Specify OpenSCAD executable')
+parser.add_argument('--sweep', required=True, help='Specify the variants to export')
+parser.add_argument('--output', required=True, action='append', help='Specify an output file name pattern')
+args,remaining_args = parser.parse_known_args()
+
+inputfile = os.path.abspath(remaining_args[0])
+outputfile = os.path.abspath(remaining_args[-1])
+remaining_args = remaining_args[1:-1] # Passed on to the OpenSCAD executable
+
+if not os.path.exists(inputfile):
+	failquit('cant find input file named: ' + inputfile)
+if not os.path.exists(args.openscad):
+	failquit('cant find openscad executable named: ' + args.openscad)
+if not os.path.exists(args.sweep):
+	failquit('cant find sweep file named: ' + args.sweep)
+
+cmd = [args.openscad, inputfile, '--sweep=' + os.path.abspath(args.sweep)] + remaining_args
+for output in args.output: cmd += ['-o', output]
+print('Running OpenSCAD:')
+print(' '.join(cmd))
+
+tmpdir = tempfile.mkdtemp(dir=os.path.dirname(outputfile))
+proc = subprocess.Popen(cmd, cwd=tmpdir, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+console = proc.communicate()[0]
+print(console)
+
+with open(outputfile, 'w') as f:
+	for line in console.splitlines():
+		if line.startswith('Could not initialize localization'): continue
+		# Messages name the input file by its absolute path
+		f.write(line.replace(os.path.dirname(inputfile) + os.sep, '') + '\n')
+	f.write('return code: ' + str(proc.returncode) + '\n')
+	for name in sorted(os.listdir(tmpdir)):
+		f.write('\n' + name + ':\n')
+		with open(os.path.join(tmpdir, name)) as written: f.write(written.read())
+
+shutil.rmtree(tmpdir)
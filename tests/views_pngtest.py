@@ -0,0 +1,61 @@
+#!/usr/bin/env python
+
+# Multi-view export test
+#
+#
+# Usage: <script> <inputfile> --openscad=<executable-path> --views=<views.json> --view=<file> [<openscad args>] file.png
+#
+#
+# step 1. Run OpenSCAD once on the input file with --views=<views.json>, in a
+#         temporary directory next to the given .png file
+# step 2. Copy the image <file> exported for one of the views to the given .png file
+# step 3. (done in CTest) - compare the .png file to the expected output
+#
+# All the optional openscad args are passed on to OpenSCAD.
+#
+# This script should return 0 on success, not-0 on error.
+#
+
+import sys, os, shutil, subprocess, tempfile, argparse
+
+def failquit(*args):
+	if len(args)!=0: print(args)
+	print('views_pngtest args:',str(sys.argv))
+	print('exiting views_pngtest.py with failure')
+	sys.exit(1)
+
+#
+# Parse arguments
+#
+parser = argparse.ArgumentParser()
+parser.add_argument('--openscad', required=True, help='Specify OpenSCAD executable')
+parser.add_argument('--views', required=True, help='Specify the views file passed to OpenSCAD')
+parser.add_argument('--view', required=True, help='Specify the exported image to compare')
+args,remaining_args = parser.parse_known_args()
+
+inputfile = os.path.abspath(remaining_args[0])
+pngfile = os.path.abspath(remaining_args[-1])
+remaining_args = remaining_args[1:-1] # Passed on to the OpenSCAD executable
+
+if not os.path.exists(inputfile):
+	failquit('cant find input file named: ' + inputfile)
+if not os.path.exists(args.openscad):
+	failquit('cant find openscad executable named: ' + args.openscad)
+
+# The file names in the views file are relative to the working directory
+viewsdir = tempfile.mkdtemp(dir=os.path.dirname(pngfile))
+export_cmd = [os.path.abspath(args.openscad), inputfile, '--views=' + os.path.abspath(args.views)] + remaining_args
+print('Running OpenSCAD:')
+print(' '.join(export_cmd))
+result = subprocess.call(export_cmd, cwd=viewsdir)
+if result != 0:
+	shutil.rmtree(viewsdir)
+	failquit('OpenSCAD failed with return code ' + str(result))
+
+viewfile = os.path.join(viewsdir, args.view)
+if not os.path.exists(viewfile):
+	print('exported files: ' + ' '.join(sorted(os.listdir(viewsdir))))
+	shutil.rmtree(viewsdir)
+	failquit('OpenSCAD did not export ' + args.view)
+shutil.copyfile(viewfile, pngfile)
+shutil.rmtree(viewsdir)